@@ -0,0 +1,104 @@
+import Foundation
+import CVIPS
+import vips
+
+/// One measured operation on one input.
+struct BenchmarkCase {
+    /// The pipeline name, e.g. `"thumbnail.jpeg"`.
+    let name: String
+    let input: SyntheticImage
+    /// Runs the pipeline once, through to computed pixels or encoded bytes.
+    let run: () throws -> Void
+
+    /// The key results are stored and compared under, e.g. `"resize.lanczos3@2048x1536"`.
+    var key: String { "\(name)@\(input.label)" }
+}
+
+extension BenchmarkCase {
+
+    /// The pipelines VIPSKit spends most of its time in, each mirroring the calls
+    /// the corresponding `VIPSImage` method makes.
+    static func all(for input: SyntheticImage) -> [BenchmarkCase] {
+        let raster = input.raster
+        return [
+            BenchmarkCase(name: "load.jpeg", input: input) {
+                try input.jpeg.withUnsafeBytes { bytes in
+                    try materialize(cvips_image_new_from_buffer(bytes.baseAddress, bytes.count))
+                }
+            },
+            BenchmarkCase(name: "load.png", input: input) {
+                try input.png.withUnsafeBytes { bytes in
+                    try materialize(cvips_image_new_from_buffer(bytes.baseAddress, bytes.count))
+                }
+            },
+            BenchmarkCase(name: "thumbnail.jpeg", input: input) {
+                try input.jpeg.withUnsafeBytes { bytes in
+                    var out: UnsafeMutablePointer<VipsImage>?
+                    try check(cvips_thumbnail_buffer(bytes.baseAddress, bytes.count, &out, 256, 256))
+                    try materialize(out)
+                }
+            },
+            BenchmarkCase(name: "resize.lanczos3", input: input) {
+                var out: UnsafeMutablePointer<VipsImage>?
+                try check(cvips_resize(raster, &out, 0.5, VIPS_KERNEL_LANCZOS3))
+                try materialize(out)
+            },
+            BenchmarkCase(name: "adjust.color", input: input) {
+                try materialize(adjust(raster, brightness: 0.1, contrast: 1.2, saturation: 1.3))
+            },
+            BenchmarkCase(name: "stats", input: input) {
+                var out: UnsafeMutablePointer<VipsImage>?
+                try check(cvips_stats(raster, &out))
+                g_object_unref(gpointer(out))
+            },
+            BenchmarkCase(name: "encode.jpeg", input: input) {
+                _ = try SyntheticImage.encode(raster, format: CVIPS_SAVE_JPEG)
+            },
+            BenchmarkCase(name: "encode.png", input: input) {
+                _ = try SyntheticImage.encode(raster, format: CVIPS_SAVE_PNG)
+            },
+            BenchmarkCase(name: "encode.webp", input: input) {
+                _ = try SyntheticImage.encode(raster, format: CVIPS_SAVE_WEBP)
+            },
+        ]
+    }
+
+    // MARK: - Helpers
+
+    private static func check(_ result: Int32) throws {
+        guard result == 0 else { throw BenchmarkError.vips() }
+    }
+
+    /// Compute every pixel of a lazy pipeline into memory, then release it.
+    private static func materialize(_ image: UnsafeMutablePointer<VipsImage>?) throws {
+        guard let image else { throw BenchmarkError.vips() }
+        defer { g_object_unref(gpointer(image)) }
+        guard let memory = vips_image_copy_memory(image) else { throw BenchmarkError.vips() }
+        g_object_unref(gpointer(memory))
+    }
+
+    /// The graph `VIPSImage.adjust(brightness:contrast:saturation:)` builds: a linear
+    /// brightness/contrast pass, then chroma scaling in LCH.
+    private static func adjust(_ image: UnsafeMutablePointer<VipsImage>, brightness: Double,
+                               contrast: Double, saturation: Double) throws -> UnsafeMutablePointer<VipsImage>? {
+        var a = [Double](repeating: contrast, count: 3)
+        var b = [Double](repeating: 127.5 * (1.0 - contrast) + brightness * 255.0, count: 3)
+        var linear: UnsafeMutablePointer<VipsImage>?
+        try check(cvips_linear(image, &linear, &a, &b, 3))
+        defer { g_object_unref(gpointer(linear)) }
+
+        var lch: UnsafeMutablePointer<VipsImage>?
+        try check(cvips_colourspace(linear, &lch, VIPS_INTERPRETATION_LCH))
+        defer { g_object_unref(gpointer(lch)) }
+
+        var sa: [Double] = [1.0, saturation, 1.0]
+        var sb: [Double] = [0.0, 0.0, 0.0]
+        var scaled: UnsafeMutablePointer<VipsImage>?
+        try check(cvips_linear(lch, &scaled, &sa, &sb, 3))
+        defer { g_object_unref(gpointer(scaled)) }
+
+        var out: UnsafeMutablePointer<VipsImage>?
+        try check(cvips_colourspace(scaled, &out, VIPS_INTERPRETATION_sRGB))
+        return out
+    }
+}
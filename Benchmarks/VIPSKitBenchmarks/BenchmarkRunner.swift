@@ -0,0 +1,115 @@
+import Foundation
+#if canImport(Glibc)
+import Glibc
+#else
+import Darwin
+#endif
+import CVIPS
+import vips
+
+/// The measurements for one case.
+struct BenchmarkResult: Codable {
+    /// The case key, `name@WIDTHxHEIGHT`.
+    let key: String
+    let name: String
+    let width: Int
+    let height: Int
+    let iterations: Int
+    let opsPerSecond: Double
+    /// Input megapixels processed per second.
+    let megapixelsPerSecond: Double
+    let p50Milliseconds: Double
+    let p99Milliseconds: Double
+    /// The libvips tracked-allocation high-water mark when the case finished.
+    /// libvips cannot reset this, so it is the running peak of the whole run.
+    let peakTrackedMemoryBytes: Int
+}
+
+/// A complete run, written as JSON and read back as a baseline.
+struct BenchmarkReport: Codable {
+    let libvipsVersion: String
+    let threads: Int
+    let date: String
+    /// The process's peak resident set size over the whole run.
+    let peakResidentMemoryBytes: Int
+    let results: [BenchmarkResult]
+}
+
+/// Times cases with a warm-up call followed by repeated calls, until both the
+/// minimum iteration count and the minimum duration have been reached.
+struct BenchmarkRunner {
+
+    var minIterations = 5
+    var maxIterations = 1000
+    var minDuration: TimeInterval = 1.0
+
+    func measure(_ benchmark: BenchmarkCase) throws -> BenchmarkResult {
+        try benchmark.run()
+
+        var samples: [UInt64] = []
+        var total: UInt64 = 0
+        while samples.count < maxIterations
+                && (samples.count < minIterations || Double(total) / 1e9 < minDuration) {
+            let start = DispatchTime.now().uptimeNanoseconds
+            try benchmark.run()
+            let elapsed = DispatchTime.now().uptimeNanoseconds - start
+            samples.append(elapsed)
+            total += elapsed
+        }
+
+        samples.sort()
+        let seconds = Double(total) / 1e9
+        let opsPerSecond = Double(samples.count) / seconds
+        return BenchmarkResult(
+            key: benchmark.key,
+            name: benchmark.name,
+            width: benchmark.input.width,
+            height: benchmark.input.height,
+            iterations: samples.count,
+            opsPerSecond: opsPerSecond,
+            megapixelsPerSecond: opsPerSecond * Double(benchmark.input.pixelCount) / 1e6,
+            p50Milliseconds: Self.percentile(samples, 0.50),
+            p99Milliseconds: Self.percentile(samples, 0.99),
+            peakTrackedMemoryBytes: Int(vips_tracked_get_mem_highwater())
+        )
+    }
+
+    /// Nearest-rank percentile of sorted nanosecond samples, in milliseconds.
+    private static func percentile(_ sorted: [UInt64], _ fraction: Double) -> Double {
+        let rank = Int((fraction * Double(sorted.count)).rounded(.up))
+        return Double(sorted[max(rank, 1) - 1]) / 1e6
+    }
+
+    /// The process's peak resident set size in bytes.
+    static func peakResidentMemory() -> Int {
+        var usage = rusage()
+        getrusage(RUSAGE_SELF, &usage)
+        #if canImport(Glibc)
+        return Int(usage.ru_maxrss) * 1024  // kilobytes on Linux
+        #else
+        return Int(usage.ru_maxrss)
+        #endif
+    }
+}
+
+// MARK: - Baseline Comparison
+
+/// A case whose throughput changed relative to a baseline.
+struct BenchmarkComparison {
+    let key: String
+    let baseline: Double
+    let current: Double
+
+    /// The throughput change in percent; negative is slower.
+    var change: Double { (current / baseline - 1) * 100 }
+
+    /// Compare every current result that also appears in the baseline.
+    static func compare(_ report: BenchmarkReport, to baseline: BenchmarkReport) -> [BenchmarkComparison] {
+        let previous = Dictionary(baseline.results.map { ($0.key, $0.opsPerSecond) },
+                                  uniquingKeysWith: { first, _ in first })
+        return report.results.compactMap { result in
+            guard let ops = previous[result.key], ops > 0 else { return nil }
+            return BenchmarkComparison(key: result.key, baseline: ops, current: result.opsPerSecond)
+        }
+    }
+}
@@ -0,0 +1,123 @@
+import Foundation
+import CVIPS
+import vips
+
+/// A benchmark input at one size: the decoded raster plus encoded copies for
+/// the load and thumbnail cases. Inputs are generated, not read from disk, so
+/// every run and every machine measures identical pixels.
+final class SyntheticImage {
+
+    let width: Int
+    let height: Int
+
+    /// The uncompressed 8-bit sRGB raster, held in memory.
+    let raster: UnsafeMutablePointer<VipsImage>
+
+    /// The raster encoded as a quality 85 JPEG.
+    let jpeg: Data
+
+    /// The raster encoded as a PNG.
+    let png: Data
+
+    var pixelCount: Int { width * height }
+
+    var label: String { "\(width)x\(height)" }
+
+    /// Draw the gradient pattern from `Scripts/generate-test-images.swift` (a red to blue
+    /// gradient, a white centre rectangle and a black circle) with seeded noise on top, so
+    /// encoders and resamplers see texture rather than flat colour.
+    init(width: Int, height: Int) throws {
+        self.width = width
+        self.height = height
+
+        var pixels = [UInt8](repeating: 0, count: width * height * 3)
+        var seed: UInt32 = 0x9E37_79B9
+        let radius = Double(min(width, height)) / 6
+        let cx = Double(width) / 2, cy = Double(height) / 2
+        for y in 0..<height {
+            for x in 0..<width {
+                let t = Double(x) / Double(max(width - 1, 1))
+                var rgb = (255 * (1 - t), 51.0, 255 * t)
+                if x >= width / 4 && x < width * 3 / 4 && y >= height / 4 && y < height * 3 / 4 {
+                    rgb = (255, 255, 255)
+                }
+                let dx = Double(x) - cx, dy = Double(y) - cy
+                if dx * dx + dy * dy <= radius * radius {
+                    rgb = (0, 0, 0)
+                }
+
+                // xorshift32: cheap and identical on every platform
+                seed ^= seed << 13
+                seed ^= seed >> 17
+                seed ^= seed << 5
+                let noise = Double(Int(seed & 0x0F) - 8)
+
+                let offset = (y * width + x) * 3
+                pixels[offset] = UInt8(clamping: Int(rgb.0 + noise))
+                pixels[offset + 1] = UInt8(clamping: Int(rgb.1 + noise))
+                pixels[offset + 2] = UInt8(clamping: Int(rgb.2 + noise))
+            }
+        }
+
+        let raster = pixels.withUnsafeBytes { bytes in
+            vips_image_new_from_memory_copy(bytes.baseAddress, bytes.count,
+                                            Int32(width), Int32(height), 3, VIPS_FORMAT_UCHAR)
+        }
+        guard let raster else { throw BenchmarkError.vips() }
+        raster.pointee.Type = VIPS_INTERPRETATION_sRGB
+        self.raster = raster
+
+        jpeg = try Self.encode(raster, format: CVIPS_SAVE_JPEG)
+        png = try Self.encode(raster, format: CVIPS_SAVE_PNG)
+    }
+
+    deinit {
+        g_object_unref(gpointer(raster))
+    }
+
+    /// Encode with the library defaults, matching `VIPSEncodeOptions()`.
+    static func encode(_ image: UnsafeMutablePointer<VipsImage>, format: CVIPSSaveFormat) throws -> Data {
+        var options = defaultOptions(for: format)
+        var buffer: UnsafeMutableRawPointer?
+        var length = 0
+        guard cvips_save_buffer(image, &buffer, &length, format, &options) == 0, let buffer else {
+            throw BenchmarkError.vips()
+        }
+        defer { g_free(buffer) }
+        return Data(bytes: buffer, count: length)
+    }
+
+    /// The C equivalent of `VIPSEncodeOptions()`, which this target cannot
+    /// import because VIPSKit itself requires Apple frameworks.
+    static func defaultOptions(for format: CVIPSSaveFormat) -> CVIPSSaveOptions {
+        var options = CVIPSSaveOptions()
+        options.quality = 85
+        options.keep = CVIPS_KEEP_ALL
+        options.subsample = -1
+        options.compression = 6
+        options.tiff_compression = VIPS_FOREIGN_TIFF_COMPRESSION_NONE
+        switch format {
+        case CVIPS_SAVE_PNG:  options.effort = 7
+        case CVIPS_SAVE_WEBP: options.effort = 4
+        case CVIPS_SAVE_JXL:  options.effort = 7
+        default:              options.effort = -1
+        }
+        return options
+    }
+}
+
+/// A libvips or command-line failure.
+struct BenchmarkError: Error, CustomStringConvertible {
+    let description: String
+
+    init(_ description: String) {
+        self.description = description
+    }
+
+    /// Capture and clear the libvips error buffer.
+    static func vips() -> BenchmarkError {
+        let message = String(cString: vips_error_buffer())
+        vips_error_clear()
+        return BenchmarkError(message.isEmpty ? "Unknown libvips error" : message)
+    }
+}
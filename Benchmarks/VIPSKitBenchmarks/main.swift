@@ -0,0 +1,159 @@
+//
+//  main.swift
+//  VIPSKitBenchmarks
+//
+//  Throughput benchmarks for the load, thumbnail, resize, colour adjust,
+//  statistics and encode pipelines, run through the CVIPS shim so they build
+//  against the system libvips on Linux as well as vips-cocoa on macOS.
+//
+//  swift run -c release VIPSKitBenchmarks --output current.json
+//  swift run -c release VIPSKitBenchmarks --baseline current.json
+//
+
+import Foundation
+import CVIPS
+import vips
+
+let usage = """
+Usage: VIPSKitBenchmarks [OPTIONS]
+
+Options:
+    --sizes WxH,...       Input sizes (default 1024x768,2048x1536,4096x3072)
+    --filter TEXT         Only run cases whose name contains TEXT
+    --min-time SECONDS    Minimum measured time per case (default 1.0)
+    --min-iterations N    Minimum measured iterations per case (default 5)
+    --threads N           libvips worker threads, 0 for one per core (default 0)
+    --output PATH         Write the JSON report to PATH instead of stdout
+    --baseline PATH       Compare ops/s against a previous JSON report
+    --threshold PERCENT   With --baseline, exit 1 if any case is slower by
+                          more than PERCENT (default 10)
+    -h, --help            Show this help message
+
+"""
+
+// MARK: - Arguments
+
+var sizes = [(1024, 768), (2048, 1536), (4096, 3072)]
+var filter: String?
+var runner = BenchmarkRunner()
+var threads = 0
+var outputPath: String?
+var baselinePath: String?
+var threshold = 10.0
+
+/// Progress goes to stderr so stdout carries only the JSON report.
+func log(_ message: String) {
+    FileHandle.standardError.write(Data((message + "\n").utf8))
+}
+
+func padded(_ key: String) -> String {
+    key.padding(toLength: max(key.count, 32), withPad: " ", startingAt: 0) + " "
+}
+
+func fail(_ message: String) -> Never {
+    log("error: \(message)")
+    exit(2)
+}
+
+var arguments = CommandLine.arguments.dropFirst().makeIterator()
+func value(for option: String) -> String {
+    guard let value = arguments.next() else { fail("\(option) needs a value") }
+    return value
+}
+
+while let argument = arguments.next() {
+    switch argument {
+    case "--sizes":
+        sizes = value(for: argument).split(separator: ",").map { size in
+            let parts = size.split(separator: "x").compactMap { Int($0) }
+            guard parts.count == 2, parts[0] > 0, parts[1] > 0 else { fail("invalid size '\(size)'") }
+            return (parts[0], parts[1])
+        }
+    case "--filter":         filter = value(for: argument)
+    case "--min-time":       runner.minDuration = TimeInterval(value(for: argument)) ?? runner.minDuration
+    case "--min-iterations": runner.minIterations = Int(value(for: argument)) ?? runner.minIterations
+    case "--threads":        threads = Int(value(for: argument)) ?? threads
+    case "--output":         outputPath = value(for: argument)
+    case "--baseline":       baselinePath = value(for: argument)
+    case "--threshold":      threshold = Double(value(for: argument)) ?? threshold
+    case "-h", "--help":
+        print(usage, terminator: "")
+        exit(0)
+    default:
+        fail("unknown option '\(argument)'")
+    }
+}
+
+// MARK: - Setup
+
+if vips_init("VIPSKitBenchmarks") != 0 {
+    fail(BenchmarkError.vips().description)
+}
+// Every iteration must recompute; the operation cache would otherwise return
+// the previous result for identical calls on the same input.
+vips_cache_set_max(0)
+vips_concurrency_set(Int32(threads))
+
+// MARK: - Run
+
+var results: [BenchmarkResult] = []
+do {
+    for (width, height) in sizes {
+        let input = try SyntheticImage(width: width, height: height)
+        for benchmark in BenchmarkCase.all(for: input) {
+            if let filter, !benchmark.name.contains(filter) { continue }
+            let result = try runner.measure(benchmark)
+            log(padded(result.key) + String(format: "%10.1f ops/s %10.1f MPix/s  p50 %8.2fms  p99 %8.2fms",
+                                            result.opsPerSecond, result.megapixelsPerSecond,
+                                            result.p50Milliseconds, result.p99Milliseconds))
+            results.append(result)
+        }
+    }
+} catch {
+    fail("\(error)")
+}
+
+let report = BenchmarkReport(
+    libvipsVersion: String(cString: vips_version_string()),
+    threads: Int(vips_concurrency_get()),
+    date: ISO8601DateFormatter().string(from: Date()),
+    peakResidentMemoryBytes: BenchmarkRunner.peakResidentMemory(),
+    results: results
+)
+
+let encoder = JSONEncoder()
+encoder.outputFormatting = [.prettyPrinted, .sortedKeys]
+do {
+    let json = try encoder.encode(report)
+    if let outputPath {
+        try json.write(to: URL(fileURLWithPath: outputPath))
+    } else {
+        FileHandle.standardOutput.write(json)
+        FileHandle.standardOutput.write(Data("\n".utf8))
+    }
+} catch {
+    fail("\(error)")
+}
+
+// MARK: - Baseline
+
+guard let baselinePath else { exit(0) }
+
+let baseline: BenchmarkReport
+do {
+    baseline = try JSONDecoder().decode(BenchmarkReport.self,
+                                        from: Data(contentsOf: URL(fileURLWithPath: baselinePath)))
+} catch {
+    fail("cannot read baseline '\(baselinePath)': \(error)")
+}
+
+var regressions = 0
+log("\nCompared with \(baselinePath) (libvips \(baseline.libvipsVersion)):")
+for comparison in BenchmarkComparison.compare(report, to: baseline) {
+    let regressed = comparison.change < -threshold
+    if regressed { regressions += 1 }
+    log(padded(comparison.key) + String(format: "%10.1f -> %10.1f ops/s  %+6.1f%%",
+                                        comparison.baseline, comparison.current, comparison.change) +
+        (regressed ? "  REGRESSION" : ""))
+}
+exit(regressions > 0 ? 1 : 0)
@@ -1,6 +1,10 @@
 // swift-tools-version: 5.9
 import PackageDescription
 
+// vips-cocoa ships prebuilt static libvips for Apple platforms; elsewhere the
+// shim builds against the system libvips found through pkg-config.
+let applePlatforms: [Platform] = [.iOS, .macOS, .macCatalyst, .visionOS]
+
 let package = Package(
     name: "VIPSKit",
     platforms: [
@@ -19,18 +23,30 @@ let package = Package(
         .target(
             name: "CVIPS",
             dependencies: [
-                .product(name: "vips-static", package: "vips-cocoa"),
+                .product(name: "vips-static", package: "vips-cocoa", condition: .when(platforms: applePlatforms)),
+                .target(name: "CLibVips", condition: .when(platforms: [.linux])),
             ],
             path: "Sources/Internal",
             publicHeadersPath: "include",
             cSettings: [
-                .define("HAVE_CONFIG_H", to: "1"),
+                .define("HAVE_CONFIG_H", to: "1", .when(platforms: applePlatforms)),
             ],
             linkerSettings: [
-                .linkedLibrary("z"),
-                .linkedLibrary("iconv"),
-                .linkedLibrary("resolv"),
-                .linkedLibrary("c++"),
+                .linkedLibrary("z", .when(platforms: applePlatforms)),
+                .linkedLibrary("iconv", .when(platforms: applePlatforms)),
+                .linkedLibrary("resolv", .when(platforms: applePlatforms)),
+                .linkedLibrary("c++", .when(platforms: applePlatforms)),
+            ]
+        ),
+
+        // System libvips (Linux), located through pkg-config
+        .systemLibrary(
+            name: "CLibVips",
+            path: "Sources/CLibVips",
+            pkgConfig: "vips",
+            providers: [
+                .apt(["libvips-dev"]),
+                .brew(["vips"]),
             ]
         ),
 
@@ -39,12 +55,20 @@ let package = Package(
             name: "VIPSKit",
             dependencies: ["CVIPS"],
             path: "Sources",
-            exclude: ["Internal"],
+            exclude: ["Internal", "CLibVips"],
             swiftSettings: [
                 .enableUpcomingFeature("AccessLevelOnImport"),
             ]
         ),
 
+        // Throughput benchmarks for the core pipelines. Depends only on the C shim,
+        // so it also runs on Linux: swift run -c release VIPSKitBenchmarks --help
+        .executableTarget(
+            name: "VIPSKitBenchmarks",
+            dependencies: ["CVIPS"],
+            path: "Benchmarks/VIPSKitBenchmarks"
+        ),
+
         // Tests
         .testTarget(
             name: "VIPSKitTests",
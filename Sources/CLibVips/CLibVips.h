@@ -0,0 +1,3 @@
+// Umbrella header for the system libvips module
+// Used on Linux in place of vips.xcframework; include paths come from pkg-config
+#include <vips/vips.h>
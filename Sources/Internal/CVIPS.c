@@ -3,41 +3,516 @@
 //  VIPSKit
 //
 //  Non-variadic C wrappers for libvips variadic functions.
-//  Each function is a one-liner calling the variadic original.
+//  Most functions are one-liners calling the variadic original. A few
+//  helpers wrap libvips APIs that are only reachable through C macros.
+//  Wrappers are bracketed by profiling scopes that cost one atomic load
+//  while profiling is disabled.
 //
 
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
 #include "CVIPS.h"
 
+// =============================================================================
+// Profiling
+// =============================================================================
+
+// Events kept between resets. Further events are counted as dropped.
+#define CVIPS_PROFILE_MAX_EVENTS (1 << 18)
+
+static gint cvips_profile_enabled = 0;
+static gint cvips_profile_next_thread = 0;
+static _Thread_local int cvips_profile_thread = 0;
+static GMutex cvips_profile_lock;
+static GArray *cvips_profile_events = NULL;
+static guint64 cvips_profile_dropped = 0;
+
+typedef struct {
+    gboolean active;
+    gint64 start;
+    guint cache_size;
+    VipsImage *in;
+    guint64 bytes_in;
+} CVIPSProfileScope;
+
+static gint64 cvips_profile_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (gint64)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static GQuark cvips_profile_seen_quark(void) {
+    static gsize quark = 0;
+    if (g_once_init_enter(&quark)) {
+        g_once_init_leave(&quark, g_quark_from_static_string("cvips-profile-seen"));
+    }
+    return (GQuark)quark;
+}
+
+static guint64 cvips_profile_pixels(VipsImage *image) {
+    return image != NULL ? (guint64)image->Xsize * image->Ysize : 0;
+}
+
+static guint64 cvips_profile_bytes(VipsImage *image) {
+    return image != NULL ? (guint64)VIPS_IMAGE_SIZEOF_IMAGE(image) : 0;
+}
+
+// When profiling is disabled, a scope costs one atomic load and a branch.
+static inline void cvips_profile_begin(CVIPSProfileScope *scope, VipsImage *in, guint64 bytes_in) {
+    scope->active = g_atomic_int_get(&cvips_profile_enabled);
+    if (!scope->active) {
+        return;
+    }
+    scope->in = in;
+    scope->bytes_in = bytes_in != 0 ? bytes_in : cvips_profile_bytes(in);
+    scope->cache_size = vips_cache_get_size();
+    scope->start = cvips_profile_now();
+}
+
+static void cvips_profile_record(CVIPSProfileScope *scope, const char *name, CVIPSProfileKind kind,
+                                 int result, VipsImage **out, const size_t *out_length) {
+    gint64 end = cvips_profile_now();
+    VipsImage *image = (result == 0 && out != NULL) ? *out : NULL;
+
+    if (cvips_profile_thread == 0) {
+        cvips_profile_thread = g_atomic_int_add(&cvips_profile_next_thread, 1) + 1;
+    }
+
+    CVIPSProfileEvent event = {
+        .name = name,
+        .kind = kind,
+        .thread = cvips_profile_thread,
+        .start = scope->start,
+        .duration = end - scope->start,
+        .pixels_in = cvips_profile_pixels(scope->in),
+        .pixels_out = cvips_profile_pixels(image),
+        .bytes_in = scope->bytes_in,
+        .bytes_out = (result == 0 && out_length != NULL) ? (guint64)*out_length : cvips_profile_bytes(image),
+        .cache = CVIPS_CACHE_NONE,
+        .failed = result != 0,
+    };
+
+    // Every image returned while profiling is tagged, so an output that already
+    // carries the tag was handed back by the operation cache. An untagged output
+    // that grew the cache was built fresh. Anything else is uncacheable, or reused
+    // from before profiling started, and is left as unknown. Other threads adding
+    // operations at the same time can make a miss approximate.
+    if (result == 0 && kind != CVIPS_PROFILE_SAVE && kind != CVIPS_PROFILE_DRAW && kind != CVIPS_PROFILE_READ) {
+        if (image != NULL && g_object_get_qdata(G_OBJECT(image), cvips_profile_seen_quark()) != NULL) {
+            event.cache = CVIPS_CACHE_HIT;
+        } else if (vips_cache_get_size() > scope->cache_size) {
+            event.cache = CVIPS_CACHE_MISS;
+        }
+        if (image != NULL) {
+            g_object_set_qdata(G_OBJECT(image), cvips_profile_seen_quark(), GINT_TO_POINTER(1));
+        }
+    }
+
+    g_mutex_lock(&cvips_profile_lock);
+    if (cvips_profile_events == NULL) {
+        cvips_profile_events = g_array_new(FALSE, FALSE, sizeof(CVIPSProfileEvent));
+    }
+    if (cvips_profile_events->len < CVIPS_PROFILE_MAX_EVENTS) {
+        g_array_append_val(cvips_profile_events, event);
+    } else {
+        cvips_profile_dropped++;
+    }
+    g_mutex_unlock(&cvips_profile_lock);
+}
+
+static inline void cvips_profile_end(CVIPSProfileScope *scope, const char *name, CVIPSProfileKind kind,
+                                     int result, VipsImage **out, const size_t *out_length) {
+    if (scope->active) {
+        cvips_profile_record(scope, name, kind, result, out, out_length);
+    }
+}
+
+// Scope an arbitrary block; events are named after the enclosing function.
+#define CVIPS_PROFILE_BEGIN(in, bytes_in) \
+    CVIPSProfileScope profile_scope_; \
+    cvips_profile_begin(&profile_scope_, (in), (bytes_in))
+
+#define CVIPS_PROFILE_END(kind, result, out, out_length) \
+    cvips_profile_end(&profile_scope_, __func__, (kind), (result), (out), (out_length))
+
+// Profile a single call returning a libvips status code, then return it.
+#define CVIPS_PROFILED(kind, in, bytes_in, out, out_length, ...) do { \
+    CVIPS_PROFILE_BEGIN(in, bytes_in); \
+    int profile_result_ = __VA_ARGS__; \
+    CVIPS_PROFILE_END(kind, profile_result_, out, out_length); \
+    return profile_result_; \
+} while (0)
+
+// Profile a single call returning a new image (or NULL), then return it.
+#define CVIPS_PROFILED_NEW(bytes_in, ...) do { \
+    CVIPS_PROFILE_BEGIN(NULL, bytes_in); \
+    VipsImage *profile_image_ = __VA_ARGS__; \
+    CVIPS_PROFILE_END(CVIPS_PROFILE_LOAD, profile_image_ != NULL ? 0 : -1, &profile_image_, NULL); \
+    return profile_image_; \
+} while (0)
+
+#define CVIPS_PROFILED_LOAD(bytes_in, out, ...) CVIPS_PROFILED(CVIPS_PROFILE_LOAD, NULL, bytes_in, out, NULL, __VA_ARGS__)
+#define CVIPS_PROFILED_BUILD(in, out, ...) CVIPS_PROFILED(CVIPS_PROFILE_BUILD, in, 0, out, NULL, __VA_ARGS__)
+#define CVIPS_PROFILED_COMPUTE(in, ...) CVIPS_PROFILED(CVIPS_PROFILE_COMPUTE, in, 0, NULL, NULL, __VA_ARGS__)
+#define CVIPS_PROFILED_SAVE(in, out_length, ...) CVIPS_PROFILED(CVIPS_PROFILE_SAVE, in, 0, NULL, out_length, __VA_ARGS__)
+#define CVIPS_PROFILED_DRAW(image, ...) CVIPS_PROFILED(CVIPS_PROFILE_DRAW, image, 0, NULL, NULL, __VA_ARGS__)
+
+void cvips_profile_set_enabled(int enabled) {
+    g_atomic_int_set(&cvips_profile_enabled, enabled ? 1 : 0);
+}
+
+int cvips_profile_is_enabled(void) {
+    return g_atomic_int_get(&cvips_profile_enabled);
+}
+
+CVIPSProfileEvent *cvips_profile_copy_events(int *count, guint64 *dropped) {
+    g_mutex_lock(&cvips_profile_lock);
+    int n = cvips_profile_events != NULL ? (int)cvips_profile_events->len : 0;
+    CVIPSProfileEvent *copy = NULL;
+    if (n > 0) {
+        copy = g_new(CVIPSProfileEvent, n);
+        memcpy(copy, cvips_profile_events->data, sizeof(CVIPSProfileEvent) * n);
+    }
+    *count = n;
+    *dropped = cvips_profile_dropped;
+    g_mutex_unlock(&cvips_profile_lock);
+    return copy;
+}
+
+void cvips_profile_reset(void) {
+    g_mutex_lock(&cvips_profile_lock);
+    if (cvips_profile_events != NULL) {
+        g_array_set_size(cvips_profile_events, 0);
+    }
+    cvips_profile_dropped = 0;
+    g_mutex_unlock(&cvips_profile_lock);
+}
+
 // =============================================================================
 // Loading
 // =============================================================================
 
 VipsImage *cvips_image_new_from_file(const char *filename) {
-    return vips_image_new_from_file(filename, NULL);
+    CVIPS_PROFILED_NEW(0, vips_image_new_from_file(filename, NULL));
 }
 
 VipsImage *cvips_image_new_from_file_sequential(const char *filename) {
-    return vips_image_new_from_file(filename, "access", VIPS_ACCESS_SEQUENTIAL, NULL);
+    CVIPS_PROFILED_NEW(0, vips_image_new_from_file(filename, "access", VIPS_ACCESS_SEQUENTIAL, NULL));
 }
 
 VipsImage *cvips_image_new_from_buffer(const void *data, size_t length) {
-    return vips_image_new_from_buffer(data, length, "", NULL);
+    CVIPS_PROFILED_NEW(length, vips_image_new_from_buffer(data, length, "", NULL));
 }
 
 VipsImage *cvips_image_new_from_buffer_sequential(const void *data, size_t length) {
-    return vips_image_new_from_buffer(data, length, "", "access", VIPS_ACCESS_SEQUENTIAL, NULL);
+    CVIPS_PROFILED_NEW(length, vips_image_new_from_buffer(data, length, "", "access", VIPS_ACCESS_SEQUENTIAL, NULL));
 }
 
 int cvips_thumbnail(const char *filename, VipsImage **out, int width, int height) {
-    return vips_thumbnail(filename, out, width, "height", height, NULL);
+    CVIPS_PROFILED_LOAD(0, out, vips_thumbnail(filename, out, width, "height", height, NULL));
 }
 
 int cvips_thumbnail_buffer(const void *data, size_t length, VipsImage **out, int width, int height) {
-    return vips_thumbnail_buffer((void *)data, length, out, width, "height", height, NULL);
+    CVIPS_PROFILED_LOAD(length, out, vips_thumbnail_buffer((void *)data, length, out, width, "height", height, NULL));
 }
 
 int cvips_thumbnail_image(VipsImage *in, VipsImage **out, int width, int height) {
-    return vips_thumbnail_image(in, out, width, "height", height, NULL);
+    CVIPS_PROFILED_BUILD(in, out, vips_thumbnail_image(in, out, width, "height", height, NULL));
+}
+
+int cvips_thumbnail_width(const char *filename, VipsImage **out, int width) {
+    CVIPS_PROFILED_LOAD(0, out, vips_thumbnail(filename, out, width, "height", VIPS_MAX_COORD, "size", VIPS_SIZE_DOWN, NULL));
+}
+
+int cvips_thumbnail_buffer_width(const void *data, size_t length, VipsImage **out, int width) {
+    CVIPS_PROFILED_LOAD(length, out, vips_thumbnail_buffer((void *)data, length, out, width,
+                                                           "height", VIPS_MAX_COORD, "size", VIPS_SIZE_DOWN, NULL));
+}
+
+int cvips_thumbnail_image_width(VipsImage *in, VipsImage **out, int width) {
+    CVIPS_PROFILED_BUILD(in, out, vips_thumbnail_image(in, out, width, "height", VIPS_MAX_COORD, "size", VIPS_SIZE_DOWN, NULL));
+}
+
+// =============================================================================
+// Load from source
+// =============================================================================
+
+typedef struct {
+    CVIPSReadCallback read;
+    CVIPSReleaseCallback release;
+    void *context;
+} CVIPSSourceCallback;
+
+static gint64 cvips_source_read(VipsSourceCustom *source, void *buffer, gint64 length, void *user) {
+    CVIPSSourceCallback *callback = (CVIPSSourceCallback *)user;
+    return callback->read(buffer, length, callback->context);
+}
+
+// Runs when the source is finalized, which may be long after loading returns.
+static void cvips_source_callback_free(gpointer data, GClosure *closure) {
+    CVIPSSourceCallback *callback = (CVIPSSourceCallback *)data;
+    if (callback->release != NULL) {
+        callback->release(callback->context);
+    }
+    g_free(callback);
+}
+
+VipsSource *cvips_source_new_from_callback(CVIPSReadCallback read, CVIPSReleaseCallback release, void *context) {
+    VipsSourceCustom *source = vips_source_custom_new();
+    CVIPSSourceCallback *callback = g_new(CVIPSSourceCallback, 1);
+    callback->read = read;
+    callback->release = release;
+    callback->context = context;
+    g_signal_connect_data(source, "read", G_CALLBACK(cvips_source_read),
+                          callback, cvips_source_callback_free, 0);
+    return VIPS_SOURCE(source);
+}
+
+VipsImage *cvips_image_new_from_source(VipsSource *source) {
+    CVIPS_PROFILED_NEW(0, vips_image_new_from_source(source, "", NULL));
+}
+
+VipsImage *cvips_image_new_from_source_sequential(VipsSource *source) {
+    CVIPS_PROFILED_NEW(0, vips_image_new_from_source(source, "", "access", VIPS_ACCESS_SEQUENTIAL, NULL));
+}
+
+int cvips_thumbnail_source(VipsSource *source, VipsImage **out, int width, int height) {
+    CVIPS_PROFILED_LOAD(0, out, vips_thumbnail_source(source, out, width, "height", height, NULL));
+}
+
+// =============================================================================
+// Page ranges
+// =============================================================================
+
+// Returns 1 if the loader (a type name from vips_foreign_find_load) accepts the
+// "page" and "n" options, 0 if it only loads single-page formats, or -1 if no
+// loader was found or a single-page loader was asked for a later page.
+static int cvips_pages_supported(const char *loader, int page) {
+    if (loader == NULL) {
+        return -1;
+    }
+    gpointer klass = g_type_class_ref(g_type_from_name(loader));
+    gboolean paged = g_object_class_find_property(G_OBJECT_CLASS(klass), "page") != NULL;
+    g_type_class_unref(klass);
+    if (!paged && page != 0) {
+        vips_error("cvips_pages", "page %d is out of range for a single-page image", page);
+        return -1;
+    }
+    return paged ? 1 : 0;
+}
+
+VipsImage *cvips_image_new_from_file_pages(const char *filename, int page, int n) {
+    int paged = cvips_pages_supported(vips_foreign_find_load(filename), page);
+    if (paged < 0) {
+        return NULL;
+    }
+    CVIPS_PROFILED_NEW(0, paged ? vips_image_new_from_file(filename, "page", page, "n", n, NULL)
+                                : vips_image_new_from_file(filename, NULL));
+}
+
+VipsImage *cvips_image_new_from_buffer_pages(const void *data, size_t length, int page, int n) {
+    int paged = cvips_pages_supported(vips_foreign_find_load_buffer(data, length), page);
+    if (paged < 0) {
+        return NULL;
+    }
+    CVIPS_PROFILED_NEW(length, paged ? vips_image_new_from_buffer(data, length, "", "page", page, "n", n, NULL)
+                                     : vips_image_new_from_buffer(data, length, "", NULL));
+}
+
+// vips_thumbnail passes loader options through as an option string.
+static void cvips_pages_options(char *options, size_t size, int paged, int page, int n) {
+    options[0] = '\0';
+    if (paged) {
+        g_snprintf(options, size, "page=%d,n=%d", page, n);
+    }
+}
+
+int cvips_thumbnail_pages(const char *filename, VipsImage **out, int width, int height, int page, int n) {
+    int paged = cvips_pages_supported(vips_foreign_find_load(filename), page);
+    if (paged < 0) {
+        return -1;
+    }
+    char options[64];
+    cvips_pages_options(options, sizeof(options), paged, page, n);
+    CVIPS_PROFILED_LOAD(0, out, vips_thumbnail(filename, out, width, "height", height,
+                                               "option_string", options, NULL));
+}
+
+int cvips_thumbnail_buffer_pages(const void *data, size_t length, VipsImage **out, int width, int height,
+                                 int page, int n) {
+    int paged = cvips_pages_supported(vips_foreign_find_load_buffer(data, length), page);
+    if (paged < 0) {
+        return -1;
+    }
+    char options[64];
+    cvips_pages_options(options, sizeof(options), paged, page, n);
+    CVIPS_PROFILED_LOAD(length, out, vips_thumbnail_buffer((void *)data, length, out, width, "height", height,
+                                                           "option_string", options, NULL));
+}
+
+static int cvips_join_pages_run(VipsImage **pages, int n, VipsImage **out) {
+    for (int i = 1; i < n; i++) {
+        if (pages[i]->Xsize != pages[0]->Xsize || pages[i]->Ysize != pages[0]->Ysize) {
+            vips_error("cvips_join_pages", "every page must have the same size");
+            return -1;
+        }
+    }
+
+    VipsImage *joined;
+    if (vips_arrayjoin(pages, &joined, n, "across", 1, NULL)) {
+        return -1;
+    }
+    // A copy gets its own metadata table, so the page fields can be set safely
+    int result = vips_copy(joined, out, NULL);
+    g_object_unref(joined);
+    if (result != 0) {
+        return -1;
+    }
+
+    vips_image_set_int(*out, VIPS_META_PAGE_HEIGHT, pages[0]->Ysize);
+    vips_image_set_int(*out, VIPS_META_N_PAGES, n);
+
+    // Keep one frame delay per page, taken from each page's own metadata
+    int *delays = g_new(int, n);
+    gboolean animated = FALSE;
+    for (int i = 0; i < n; i++) {
+        int *delay;
+        int length;
+        delays[i] = 100;
+        if (vips_image_get_typeof(pages[i], "delay") &&
+            vips_image_get_array_int(pages[i], "delay", &delay, &length) == 0 && length > 0) {
+            delays[i] = delay[0];
+            animated = TRUE;
+        }
+    }
+    if (animated) {
+        vips_image_set_array_int(*out, "delay", delays, n);
+    } else {
+        vips_image_remove(*out, "delay");
+    }
+    g_free(delays);
+    return 0;
+}
+
+int cvips_join_pages(VipsImage **pages, int n, VipsImage **out) {
+    CVIPS_PROFILED_BUILD(n > 0 ? pages[0] : NULL, out, cvips_join_pages_run(pages, n, out));
+}
+
+static int cvips_extract_page_run(VipsImage *in, int index, VipsImage **out) {
+    int page_height = vips_image_get_page_height(in);
+    if (index < 0 || (index + 1) * page_height > in->Ysize) {
+        vips_error("cvips_extract_page", "page %d is out of range", index);
+        return -1;
+    }
+
+    VipsImage *page;
+    if (vips_crop(in, &page, 0, index * page_height, in->Xsize, page_height, NULL)) {
+        return -1;
+    }
+    // As in cvips_join_pages, copy before changing any metadata
+    int result = vips_copy(page, out, NULL);
+    g_object_unref(page);
+    if (result != 0) {
+        return -1;
+    }
+
+    // Match a single-page load: one page high, with only this page's frame delay
+    vips_image_set_int(*out, VIPS_META_PAGE_HEIGHT, page_height);
+    int *delay;
+    int length;
+    if (vips_image_get_typeof(in, "delay") &&
+        vips_image_get_array_int(in, "delay", &delay, &length) == 0 && index < length) {
+        vips_image_set_array_int(*out, "delay", &delay[index], 1);
+    }
+    return 0;
+}
+
+int cvips_extract_page(VipsImage *in, int index, VipsImage **out) {
+    CVIPS_PROFILED_BUILD(in, out, cvips_extract_page_run(in, index, out));
+}
+
+// =============================================================================
+// Header probing
+// =============================================================================
+
+// Build a loader directly, bypassing the operation cache so that probing millions
+// of files leaves nothing behind, then copy the header fields from its output.
+// Building a loader only parses the header; pixels are never requested.
+static int cvips_probe_run(VipsOperation *op, const char *loader, CVIPSImageProbe *probe) {
+    VipsImage *out = NULL;
+    int result = -1;
+
+    if (vips_object_build(VIPS_OBJECT(op)) == 0) {
+        g_object_get(op, "out", &out, NULL);
+    }
+    if (out != NULL) {
+        probe->width = out->Xsize;
+        probe->height = out->Ysize;
+        probe->bands = out->Bands;
+        probe->pages = vips_image_get_n_pages(out);
+        probe->orientation = 0;
+        if (vips_image_get_typeof(out, VIPS_META_ORIENTATION)) {
+            vips_image_get_int(out, VIPS_META_ORIENTATION, &probe->orientation);
+        }
+        // vips_foreign_find_load() returns a type name such as
+        // "VipsForeignLoadJpegFile"; report the nickname ("jpegload") instead,
+        // matching the "vips-loader" metadata of a loaded image.
+        const char *nickname = vips_nickname_find(g_type_from_name(loader));
+        g_strlcpy(probe->loader, nickname != NULL ? nickname : loader, sizeof(probe->loader));
+
+        const char *compression = NULL;
+        probe->compression[0] = '\0';
+        if (vips_image_get_typeof(out, "heif-compression") &&
+            vips_image_get_string(out, "heif-compression", &compression) == 0) {
+            g_strlcpy(probe->compression, compression, sizeof(probe->compression));
+        }
+        g_object_unref(out);
+        result = 0;
+    }
+
+    vips_object_unref_outputs(VIPS_OBJECT(op));
+    g_object_unref(op);
+    return result;
+}
+
+static int cvips_probe_file_run(const char *filename, CVIPSImageProbe *probe) {
+    // Sniffs the file's magic bytes
+    const char *loader = vips_foreign_find_load(filename);
+    if (loader == NULL) {
+        return -1;
+    }
+    VipsOperation *op = vips_operation_new(loader);
+    if (op == NULL) {
+        return -1;
+    }
+    g_object_set(op, "filename", filename, "access", VIPS_ACCESS_SEQUENTIAL, NULL);
+    return cvips_probe_run(op, loader, probe);
+}
+
+int cvips_probe_file(const char *filename, CVIPSImageProbe *probe) {
+    CVIPS_PROFILED_LOAD(0, NULL, cvips_probe_file_run(filename, probe));
+}
+
+static int cvips_probe_buffer_run(const void *data, size_t length, CVIPSImageProbe *probe) {
+    const char *loader = vips_foreign_find_load_buffer(data, length);
+    if (loader == NULL) {
+        return -1;
+    }
+    VipsOperation *op = vips_operation_new(loader);
+    if (op == NULL) {
+        return -1;
+    }
+    VipsBlob *blob = vips_blob_new(NULL, data, length);
+    g_object_set(op, "buffer", blob, "access", VIPS_ACCESS_SEQUENTIAL, NULL);
+    vips_area_unref(VIPS_AREA(blob));
+    return cvips_probe_run(op, loader, probe);
+}
+
+int cvips_probe_buffer(const void *data, size_t length, CVIPSImageProbe *probe) {
+    CVIPS_PROFILED_LOAD(length, NULL, cvips_probe_buffer_run(data, length, probe));
 }
 
 // =============================================================================
@@ -45,11 +520,11 @@ int cvips_thumbnail_image(VipsImage *in, VipsImage **out, int width, int height)
 // =============================================================================
 
 int cvips_resize(VipsImage *in, VipsImage **out, double scale, VipsKernel kernel) {
-    return vips_resize(in, out, scale, "kernel", kernel, NULL);
+    CVIPS_PROFILED_BUILD(in, out, vips_resize(in, out, scale, "kernel", kernel, NULL));
 }
 
 int cvips_resize_wh(VipsImage *in, VipsImage **out, double hscale, double vscale) {
-    return vips_resize(in, out, hscale, "vscale", vscale, NULL);
+    CVIPS_PROFILED_BUILD(in, out, vips_resize(in, out, hscale, "vscale", vscale, NULL));
 }
 
 // =============================================================================
@@ -57,31 +532,31 @@ int cvips_resize_wh(VipsImage *in, VipsImage **out, double hscale, double vscale
 // =============================================================================
 
 int cvips_crop(VipsImage *in, VipsImage **out, int left, int top, int width, int height) {
-    return vips_crop(in, out, left, top, width, height, NULL);
+    CVIPS_PROFILED_BUILD(in, out, vips_crop(in, out, left, top, width, height, NULL));
 }
 
 int cvips_rot(VipsImage *in, VipsImage **out, VipsAngle angle) {
-    return vips_rot(in, out, angle, NULL);
+    CVIPS_PROFILED_BUILD(in, out, vips_rot(in, out, angle, NULL));
 }
 
 int cvips_flip(VipsImage *in, VipsImage **out, VipsDirection direction) {
-    return vips_flip(in, out, direction, NULL);
+    CVIPS_PROFILED_BUILD(in, out, vips_flip(in, out, direction, NULL));
 }
 
 int cvips_autorot(VipsImage *in, VipsImage **out) {
-    return vips_autorot(in, out, NULL);
+    CVIPS_PROFILED_BUILD(in, out, vips_autorot(in, out, NULL));
 }
 
 int cvips_smartcrop(VipsImage *in, VipsImage **out, int width, int height, VipsInteresting interesting) {
-    return vips_smartcrop(in, out, width, height, "interesting", interesting, NULL);
+    CVIPS_PROFILED(CVIPS_PROFILE_COMPUTE, in, 0, out, NULL, vips_smartcrop(in, out, width, height, "interesting", interesting, NULL));
 }
 
 int cvips_extract_area(VipsImage *in, VipsImage **out, int left, int top, int width, int height) {
-    return vips_extract_area(in, out, left, top, width, height, NULL);
+    CVIPS_PROFILED_BUILD(in, out, vips_extract_area(in, out, left, top, width, height, NULL));
 }
 
 int cvips_extract_band(VipsImage *in, VipsImage **out, int band, int n) {
-    return vips_extract_band(in, out, band, "n", n, NULL);
+    CVIPS_PROFILED_BUILD(in, out, vips_extract_band(in, out, band, "n", n, NULL));
 }
 
 // =============================================================================
@@ -89,30 +564,156 @@ int cvips_extract_band(VipsImage *in, VipsImage **out, int band, int n) {
 // =============================================================================
 
 int cvips_colourspace(VipsImage *in, VipsImage **out, VipsInterpretation space) {
-    return vips_colourspace(in, out, space, NULL);
+    CVIPS_PROFILED_BUILD(in, out, vips_colourspace(in, out, space, NULL));
 }
 
 int cvips_flatten(VipsImage *in, VipsImage **out, double r, double g, double b) {
+    CVIPS_PROFILE_BEGIN(in, 0);
     VipsArrayDouble *background = vips_array_double_newv(3, r, g, b);
     int result = vips_flatten(in, out, "background", background, NULL);
     vips_area_unref(VIPS_AREA(background));
+    CVIPS_PROFILE_END(CVIPS_PROFILE_BUILD, result, out, NULL);
     return result;
 }
 
 int cvips_invert(VipsImage *in, VipsImage **out) {
-    return vips_invert(in, out, NULL);
+    CVIPS_PROFILED_BUILD(in, out, vips_invert(in, out, NULL));
 }
 
 int cvips_linear(VipsImage *in, VipsImage **out, const double *a, const double *b, int n) {
-    return vips_linear(in, out, a, b, n, NULL);
+    CVIPS_PROFILED_BUILD(in, out, vips_linear(in, out, a, b, n, NULL));
 }
 
 int cvips_gamma(VipsImage *in, VipsImage **out, double exponent) {
-    return vips_gamma(in, out, "exponent", exponent, NULL);
+    CVIPS_PROFILED_BUILD(in, out, vips_gamma(in, out, "exponent", exponent, NULL));
 }
 
 int cvips_cast_uchar(VipsImage *in, VipsImage **out) {
-    return vips_cast_uchar(in, out, NULL);
+    CVIPS_PROFILED_BUILD(in, out, vips_cast_uchar(in, out, NULL));
+}
+
+int cvips_cast(VipsImage *in, VipsImage **out, VipsBandFormat format) {
+    CVIPS_PROFILED_BUILD(in, out, vips_cast(in, out, format, NULL));
+}
+
+// =============================================================================
+// Tone adjustment
+// =============================================================================
+
+// Fixed-point precision of the saturation matrix.
+#define CVIPS_TONE_SHIFT 12
+
+typedef struct {
+    VipsImage *in;
+    int bands;          // total bands, including alpha
+    int colour_bands;   // leading bands the curve applies to, excluding alpha and K
+    int saturate;       // apply the matrix to the first three bands
+    VipsPel lut[256];
+    int matrix[9];      // row-major, scaled by 1 << CVIPS_TONE_SHIFT
+} CVIPSTone;
+
+static inline VipsPel cvips_tone_fixed_to_uchar(int v) {
+    v = (v + (1 << (CVIPS_TONE_SHIFT - 1))) >> CVIPS_TONE_SHIFT;
+    return (VipsPel)(v < 0 ? 0 : v > 255 ? 255 : v);
+}
+
+// One pass per pixel: look each colour band up in the curve, optionally mix the
+// result through the saturation matrix, and copy the remaining bands as-is.
+static int cvips_tone_gen(VipsRegion *out_region, void *seq, void *a, void *b, gboolean *stop) {
+    VipsRegion *ir = (VipsRegion *)seq;
+    const CVIPSTone *tone = (const CVIPSTone *)b;
+    const VipsRect *r = &out_region->valid;
+    if (vips_region_prepare(ir, r)) {
+        return -1;
+    }
+
+    const int *m = tone->matrix;
+    for (int y = 0; y < r->height; y++) {
+        const VipsPel *p = VIPS_REGION_ADDR(ir, r->left, r->top + y);
+        VipsPel *q = VIPS_REGION_ADDR(out_region, r->left, r->top + y);
+        for (int x = 0; x < r->width; x++) {
+            if (tone->saturate) {
+                int red = tone->lut[p[0]], green = tone->lut[p[1]], blue = tone->lut[p[2]];
+                q[0] = cvips_tone_fixed_to_uchar(m[0] * red + m[1] * green + m[2] * blue);
+                q[1] = cvips_tone_fixed_to_uchar(m[3] * red + m[4] * green + m[5] * blue);
+                q[2] = cvips_tone_fixed_to_uchar(m[6] * red + m[7] * green + m[8] * blue);
+            } else {
+                for (int i = 0; i < tone->colour_bands; i++) {
+                    q[i] = tone->lut[p[i]];
+                }
+            }
+            for (int i = tone->colour_bands; i < tone->bands; i++) {
+                q[i] = p[i];
+            }
+            p += tone->bands;
+            q += tone->bands;
+        }
+    }
+    return 0;
+}
+
+static void cvips_tone_free(VipsImage *image, CVIPSTone *tone) {
+    g_object_unref(tone->in);
+    g_free(tone);
+}
+
+static int cvips_tone_adjust_run(VipsImage *in, VipsImage **out, double brightness, double contrast,
+                                 double gamma, double saturation) {
+    if (in->BandFmt != VIPS_FORMAT_UCHAR || in->Coding != VIPS_CODING_NONE) {
+        vips_error("cvips_tone_adjust", "image must be uncoded 8-bit");
+        return -1;
+    }
+
+    CVIPSTone *tone = g_new0(CVIPSTone, 1);
+    tone->in = in;
+    tone->bands = in->Bands;
+    // CMYK curves C, M and Y only; black is copied through like alpha
+    tone->colour_bands = in->Type == VIPS_INTERPRETATION_CMYK && in->Bands >= 4
+        ? 3 : in->Bands - (vips_image_hasalpha(in) ? 1 : 0);
+    tone->saturate = tone->colour_bands == 3 && fabs(saturation - 1.0) > 1e-6;
+
+    // The same curve adjust(brightness:contrast:) and adjustGamma(_:) apply in
+    // float, evaluated once per input value
+    double offset = 127.5 * (1.0 - contrast) + brightness * 255.0;
+    for (int i = 0; i < 256; i++) {
+        double v = fmin(fmax(contrast * i + offset, 0.0), 255.0);
+        if (gamma != 1.0) {
+            v = 255.0 * pow(v / 255.0, gamma);
+        }
+        tone->lut[i] = (VipsPel)lround(v);
+    }
+
+    // Move each colour towards or away from its Rec. 601 luma:
+    // out = luma + s * (c - luma), i.e. s * I + (1 - s) * [w; w; w]
+    static const double luma[3] = { 0.299, 0.587, 0.114 };
+    for (int row = 0; row < 3; row++) {
+        for (int col = 0; col < 3; col++) {
+            double v = (1.0 - saturation) * luma[col] + (row == col ? saturation : 0.0);
+            tone->matrix[row * 3 + col] = (int)lround(v * (1 << CVIPS_TONE_SHIFT));
+        }
+    }
+
+    *out = vips_image_new();
+    if (vips_image_pipelinev(*out, VIPS_DEMAND_STYLE_THINSTRIP, in, NULL)) {
+        g_free(tone);
+        g_object_unref(*out);
+        *out = NULL;
+        return -1;
+    }
+    // The output keeps the input and the tables alive until it closes
+    g_object_ref(in);
+    g_signal_connect(*out, "close", G_CALLBACK(cvips_tone_free), tone);
+    if (vips_image_generate(*out, vips_start_one, cvips_tone_gen, vips_stop_one, in, tone)) {
+        g_object_unref(*out);
+        *out = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+int cvips_tone_adjust(VipsImage *in, VipsImage **out, double brightness, double contrast,
+                      double gamma, double saturation) {
+    CVIPS_PROFILED_BUILD(in, out, cvips_tone_adjust_run(in, out, brightness, contrast, gamma, saturation));
 }
 
 // =============================================================================
@@ -120,19 +721,19 @@ int cvips_cast_uchar(VipsImage *in, VipsImage **out) {
 // =============================================================================
 
 int cvips_gaussblur(VipsImage *in, VipsImage **out, double sigma) {
-    return vips_gaussblur(in, out, sigma, NULL);
+    CVIPS_PROFILED_BUILD(in, out, vips_gaussblur(in, out, sigma, NULL));
 }
 
 int cvips_sharpen(VipsImage *in, VipsImage **out, double sigma) {
-    return vips_sharpen(in, out, "sigma", sigma, NULL);
+    CVIPS_PROFILED_BUILD(in, out, vips_sharpen(in, out, "sigma", sigma, NULL));
 }
 
 int cvips_sobel(VipsImage *in, VipsImage **out) {
-    return vips_sobel(in, out, NULL);
+    CVIPS_PROFILED_BUILD(in, out, vips_sobel(in, out, NULL));
 }
 
 int cvips_canny(VipsImage *in, VipsImage **out, double sigma) {
-    return vips_canny(in, out, "sigma", sigma, NULL);
+    CVIPS_PROFILED_BUILD(in, out, vips_canny(in, out, "sigma", sigma, NULL));
 }
 
 // =============================================================================
@@ -140,7 +741,7 @@ int cvips_canny(VipsImage *in, VipsImage **out, double sigma) {
 // =============================================================================
 
 int cvips_composite2(VipsImage *base, VipsImage *overlay, VipsImage **out, VipsBlendMode mode, int x, int y) {
-    return vips_composite2(base, overlay, out, mode, "x", x, "y", y, NULL);
+    CVIPS_PROFILED_BUILD(base, out, vips_composite2(base, overlay, out, mode, "x", x, "y", y, NULL));
 }
 
 // =============================================================================
@@ -148,49 +749,637 @@ int cvips_composite2(VipsImage *base, VipsImage *overlay, VipsImage **out, VipsB
 // =============================================================================
 
 int cvips_find_trim(VipsImage *in, int *left, int *top, int *width, int *height, double threshold) {
-    return vips_find_trim(in, left, top, width, height, "threshold", threshold, NULL);
+    CVIPS_PROFILED_COMPUTE(in, vips_find_trim(in, left, top, width, height, "threshold", threshold, NULL));
 }
 
 int cvips_find_trim_bg(VipsImage *in, int *left, int *top, int *width, int *height, double threshold, double *background, int bg_count) {
+    CVIPS_PROFILE_BEGIN(in, 0);
     VipsArrayDouble *bgArray = vips_array_double_new(background, bg_count);
     int result = vips_find_trim(in, left, top, width, height,
                                 "threshold", threshold,
                                 "background", bgArray,
                                 NULL);
     vips_area_unref(VIPS_AREA(bgArray));
+    CVIPS_PROFILE_END(CVIPS_PROFILE_COMPUTE, result, NULL, NULL);
     return result;
 }
 
 int cvips_min(VipsImage *in, double *out) {
-    return vips_min(in, out, NULL);
+    CVIPS_PROFILED_COMPUTE(in, vips_min(in, out, NULL));
 }
 
 int cvips_max(VipsImage *in, double *out) {
-    return vips_max(in, out, NULL);
+    CVIPS_PROFILED_COMPUTE(in, vips_max(in, out, NULL));
 }
 
 int cvips_avg(VipsImage *in, double *out) {
-    return vips_avg(in, out, NULL);
+    CVIPS_PROFILED_COMPUTE(in, vips_avg(in, out, NULL));
 }
 
 int cvips_deviate(VipsImage *in, double *out) {
-    return vips_deviate(in, out, NULL);
+    CVIPS_PROFILED_COMPUTE(in, vips_deviate(in, out, NULL));
 }
 
 int cvips_stats(VipsImage *in, VipsImage **out) {
-    return vips_stats(in, out, NULL);
+    CVIPS_PROFILED(CVIPS_PROFILE_COMPUTE, in, 0, out, NULL, vips_stats(in, out, NULL));
 }
 
 int cvips_subtract(VipsImage *in, VipsImage *other, VipsImage **out) {
-    return vips_subtract(in, other, out, NULL);
+    CVIPS_PROFILED_BUILD(in, out, vips_subtract(in, other, out, NULL));
 }
 
 int cvips_abs(VipsImage *in, VipsImage **out) {
-    return vips_abs(in, out, NULL);
+    CVIPS_PROFILED_BUILD(in, out, vips_abs(in, out, NULL));
 }
 
 int cvips_join(VipsImage *in1, VipsImage *in2, VipsImage **out, VipsDirection direction) {
-    return vips_join(in1, in2, out, direction, NULL);
+    CVIPS_PROFILED_BUILD(in1, out, vips_join(in1, in2, out, direction, NULL));
+}
+
+static int cvips_stats_summary_run(VipsImage *in, double *out, int rows) {
+    // A single vips_stats pass yields every per-band statistic at once, so the
+    // input pipeline is evaluated only one time.
+    VipsImage *stats;
+    if (vips_stats(in, &stats, NULL) != 0) {
+        return -1;
+    }
+    if (rows > stats->Ysize) {
+        vips_error("cvips_stats_summary", "requested %d rows, stats has %d", rows, stats->Ysize);
+        g_object_unref(stats);
+        return -1;
+    }
+
+    for (int y = 0; y < rows; y++) {
+        for (int x = 0; x < CVIPS_STATS_COLUMNS; x++) {
+            out[y * CVIPS_STATS_COLUMNS + x] = *VIPS_MATRIX(stats, x, y);
+        }
+    }
+    g_object_unref(stats);
+    return 0;
+}
+
+int cvips_stats_summary(VipsImage *in, double *out, int rows) {
+    CVIPS_PROFILED_COMPUTE(in, cvips_stats_summary_run(in, out, rows));
+}
+
+// =============================================================================
+// Evaluation counting (diagnostics)
+// =============================================================================
+
+static void cvips_count_preeval(VipsImage *image, VipsProgress *progress, int *counter) {
+    *counter += 1;
+}
+
+gulong cvips_image_count_evaluations(VipsImage *in, int *counter) {
+    vips_image_set_progress(in, TRUE);
+    return g_signal_connect(in, "preeval", G_CALLBACK(cvips_count_preeval), counter);
+}
+
+void cvips_image_stop_counting(VipsImage *in, gulong handler) {
+    g_signal_handler_disconnect(in, handler);
+    vips_image_set_progress(in, FALSE);
+}
+
+// =============================================================================
+// Edge color histogram
+// =============================================================================
+
+// Rows fetched per region request by each worker.
+#define CVIPS_EDGE_CHUNK 64
+
+typedef struct {
+    VipsImage *in;
+    const VipsRect *rects;
+    int n_rects;
+    int index;
+    int n_workers;
+    int result;
+    guint64 counts[CVIPS_EDGE_BUCKETS];
+    guint64 sums[CVIPS_EDGE_BUCKETS * 4];
+} CVIPSEdgeWorker;
+
+// `bands` is always a literal at the call sites so each loop is specialized.
+static inline void cvips_edge_accumulate(CVIPSEdgeWorker *worker, const VipsPel *p, int n, const int bands) {
+    guint64 *counts = worker->counts;
+    guint64 *sums = worker->sums;
+    for (int x = 0; x < n; x++, p += bands) {
+        int key;
+        if (bands >= 3) {
+            key = ((p[0] >> 5) << 6) | ((p[1] >> 5) << 3) | (p[2] >> 5);
+        } else if (bands == 2) {
+            key = ((p[0] >> 5) << 3) | (p[1] >> 5);
+        } else {
+            key = p[0] >> 5;
+        }
+        counts[key]++;
+        guint64 *s = sums + key * 4;
+        for (int b = 0; b < bands; b++) {
+            s[b] += p[b];
+        }
+    }
+}
+
+static gpointer cvips_edge_worker(gpointer data) {
+    CVIPSEdgeWorker *worker = (CVIPSEdgeWorker *)data;
+    VipsRegion *region = vips_region_new(worker->in);
+    if (region == NULL) {
+        worker->result = -1;
+        return NULL;
+    }
+    int bands = worker->in->Bands;
+
+    for (int i = 0; i < worker->n_rects && worker->result == 0; i++) {
+        const VipsRect *rect = &worker->rects[i];
+        int top = rect->top + (int)((gint64)rect->height * worker->index / worker->n_workers);
+        int bottom = rect->top + (int)((gint64)rect->height * (worker->index + 1) / worker->n_workers);
+
+        for (int y = top; y < bottom; y += CVIPS_EDGE_CHUNK) {
+            int rows = VIPS_MIN(CVIPS_EDGE_CHUNK, bottom - y);
+            VipsPel *p;
+            size_t stride;
+            if (cvips_region_prepare_area(region, rect->left, y, rect->width, rows, &p, &stride) != 0) {
+                worker->result = -1;
+                break;
+            }
+            for (int row = 0; row < rows; row++, p += stride) {
+                switch (bands) {
+                case 1: cvips_edge_accumulate(worker, p, rect->width, 1); break;
+                case 2: cvips_edge_accumulate(worker, p, rect->width, 2); break;
+                case 3: cvips_edge_accumulate(worker, p, rect->width, 3); break;
+                default: cvips_edge_accumulate(worker, p, rect->width, 4); break;
+                }
+            }
+        }
+    }
+
+    g_object_unref(region);
+    return NULL;
+}
+
+static int cvips_edge_histogram_run(VipsImage *in, int strip_width, int threads, guint64 *counts, double *sums) {
+    if (in->BandFmt != VIPS_FORMAT_UCHAR || in->Bands < 1 || in->Bands > 4) {
+        vips_error("cvips_edge_histogram", "expected a 1 to 4 band uchar image");
+        return -1;
+    }
+
+    // Top and bottom strips span the full width; the side strips fill the gap
+    // between them so corners are only counted once. Images too small to hold
+    // four strips are sampled in full.
+    int w = in->Xsize;
+    int h = in->Ysize;
+    int sw = VIPS_MAX(1, strip_width);
+    VipsRect rects[4];
+    int n_rects = 0;
+    if (w <= sw * 2 || h <= sw * 2) {
+        rects[n_rects++] = (VipsRect){ 0, 0, w, h };
+    } else {
+        rects[n_rects++] = (VipsRect){ 0, 0, w, sw };
+        rects[n_rects++] = (VipsRect){ 0, h - sw, w, sw };
+        rects[n_rects++] = (VipsRect){ 0, sw, sw, h - 2 * sw };
+        rects[n_rects++] = (VipsRect){ w - sw, sw, sw, h - 2 * sw };
+    }
+
+    // Split rows across workers, keeping enough rows per worker to be worthwhile.
+    int total_rows = 0;
+    for (int i = 0; i < n_rects; i++) {
+        total_rows += rects[i].height;
+    }
+    int n_workers = VIPS_CLIP(1, VIPS_MIN(threads, total_rows / CVIPS_EDGE_CHUNK), 64);
+
+    CVIPSEdgeWorker *workers = g_new0(CVIPSEdgeWorker, n_workers);
+    GThread **handles = g_new0(GThread *, n_workers);
+    for (int i = 0; i < n_workers; i++) {
+        workers[i].in = in;
+        workers[i].rects = rects;
+        workers[i].n_rects = n_rects;
+        workers[i].index = i;
+        workers[i].n_workers = n_workers;
+    }
+
+    // Worker 0 runs on the calling thread
+    for (int i = 1; i < n_workers; i++) {
+        handles[i] = vips_g_thread_new("cvips_edge", cvips_edge_worker, &workers[i]);
+        if (handles[i] == NULL) {
+            cvips_edge_worker(&workers[i]);
+        }
+    }
+    cvips_edge_worker(&workers[0]);
+
+    int result = 0;
+    int bands = in->Bands;
+    memset(counts, 0, sizeof(guint64) * CVIPS_EDGE_BUCKETS);
+    memset(sums, 0, sizeof(double) * CVIPS_EDGE_BUCKETS * bands);
+    for (int i = 0; i < n_workers; i++) {
+        if (handles[i] != NULL) {
+            g_thread_join(handles[i]);
+        }
+        if (workers[i].result != 0) {
+            result = -1;
+        }
+        for (int key = 0; key < CVIPS_EDGE_BUCKETS; key++) {
+            counts[key] += workers[i].counts[key];
+            for (int b = 0; b < bands; b++) {
+                sums[key * bands + b] += (double)workers[i].sums[key * 4 + b];
+            }
+        }
+    }
+
+    g_free(handles);
+    g_free(workers);
+    return result;
+}
+
+int cvips_edge_histogram(VipsImage *in, int strip_width, int threads, guint64 *counts, double *sums) {
+    CVIPS_PROFILED_COMPUTE(in, cvips_edge_histogram_run(in, strip_width, threads, counts, sums));
+}
+
+// =============================================================================
+// Perceptual hashing
+// =============================================================================
+
+// Shrink to a luminance grid of exactly width x height, ignoring aspect ratio,
+// and return it as doubles. Alpha is flattened onto white first.
+static double *cvips_hash_grid(VipsImage *in, int width, int height) {
+    VipsImage *base = vips_image_new();
+    VipsImage **t = (VipsImage **)vips_object_local_array(VIPS_OBJECT(base), 4);
+    VipsImage *x = in;
+
+    if (vips_image_hasalpha(x)) {
+        double white[1] = { 255.0 };
+        if (vips_flatten(x, &t[0], "background", vips_array_double_new(white, 1), NULL)) {
+            g_object_unref(base);
+            return NULL;
+        }
+        x = t[0];
+    }
+    if (x->Bands > 1) {
+        int failed = vips_colourspace_issupported(x)
+            ? vips_colourspace(x, &t[1], VIPS_INTERPRETATION_B_W, NULL)
+            : vips_extract_band(x, &t[1], 0, NULL);
+        if (failed) {
+            g_object_unref(base);
+            return NULL;
+        }
+        x = t[1];
+    }
+    if (vips_thumbnail_image(x, &t[2], width, "height", height, "size", VIPS_SIZE_FORCE, NULL) ||
+        vips_cast(t[2], &t[3], VIPS_FORMAT_DOUBLE, NULL)) {
+        g_object_unref(base);
+        return NULL;
+    }
+
+    size_t size;
+    double *grid = (double *)vips_image_write_to_memory(t[3], &size);
+    g_object_unref(base);
+    if (grid != NULL && size != sizeof(double) * width * height) {
+        vips_error("cvips_perceptual_hash", "unexpected grid size");
+        g_free(grid);
+        return NULL;
+    }
+    return grid;
+}
+
+static int cvips_compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// 64 bits, one per value, set where the value is above the threshold.
+static guint64 cvips_hash_bits(const double *values, double threshold) {
+    guint64 hash = 0;
+    for (int i = 0; i < 64; i++) {
+        hash = (hash << 1) | (values[i] > threshold);
+    }
+    return hash;
+}
+
+static int cvips_perceptual_hash_run(VipsImage *in, CVIPSHashKind kind, guint64 *out) {
+    switch (kind) {
+    case CVIPS_HASH_AVERAGE: {
+        double *grid = cvips_hash_grid(in, 8, 8);
+        if (grid == NULL) {
+            return -1;
+        }
+        double mean = 0.0;
+        for (int i = 0; i < 64; i++) {
+            mean += grid[i];
+        }
+        *out = cvips_hash_bits(grid, mean / 64.0);
+        g_free(grid);
+        return 0;
+    }
+
+    case CVIPS_HASH_DIFFERENCE: {
+        // One bit per horizontally adjacent pair, set where brightness falls
+        double *grid = cvips_hash_grid(in, 9, 8);
+        if (grid == NULL) {
+            return -1;
+        }
+        double gradients[64];
+        for (int y = 0; y < 8; y++) {
+            for (int x = 0; x < 8; x++) {
+                gradients[y * 8 + x] = grid[y * 9 + x] - grid[y * 9 + x + 1];
+            }
+        }
+        *out = cvips_hash_bits(gradients, 0.0);
+        g_free(grid);
+        return 0;
+    }
+
+    case CVIPS_HASH_PERCEPTUAL: {
+        // The lowest 8 x 8 frequencies of a 32 x 32 DCT-II, thresholded at their median
+        double *grid = cvips_hash_grid(in, 32, 32);
+        if (grid == NULL) {
+            return -1;
+        }
+        double basis[8][32];
+        for (int u = 0; u < 8; u++) {
+            for (int x = 0; x < 32; x++) {
+                basis[u][x] = cos(M_PI * u * (2 * x + 1) / 64.0);
+            }
+        }
+        double rows[32][8];
+        for (int y = 0; y < 32; y++) {
+            for (int u = 0; u < 8; u++) {
+                double sum = 0.0;
+                for (int x = 0; x < 32; x++) {
+                    sum += grid[y * 32 + x] * basis[u][x];
+                }
+                rows[y][u] = sum;
+            }
+        }
+        double coefficients[64];
+        for (int v = 0; v < 8; v++) {
+            for (int u = 0; u < 8; u++) {
+                double sum = 0.0;
+                for (int y = 0; y < 32; y++) {
+                    sum += rows[y][u] * basis[v][y];
+                }
+                coefficients[v * 8 + u] = sum;
+            }
+        }
+        double sorted[64];
+        memcpy(sorted, coefficients, sizeof(sorted));
+        qsort(sorted, 64, sizeof(double), cvips_compare_doubles);
+        *out = cvips_hash_bits(coefficients, (sorted[31] + sorted[32]) / 2.0);
+        g_free(grid);
+        return 0;
+    }
+    }
+
+    vips_error("cvips_perceptual_hash", "unknown hash kind %d", (int)kind);
+    return -1;
+}
+
+int cvips_perceptual_hash(VipsImage *in, CVIPSHashKind kind, guint64 *out) {
+    CVIPS_PROFILED_COMPUTE(in, cvips_perceptual_hash_run(in, kind, out));
+}
+
+// Plain scalar loops over XOR and popcount, with no allocation or call per hash.
+void cvips_hamming_distances(guint64 query, const guint64 *hashes, size_t count, guint8 *out) {
+    for (size_t i = 0; i < count; i++) {
+        out[i] = (guint8)__builtin_popcountll(query ^ hashes[i]);
+    }
+}
+
+size_t cvips_hamming_within(guint64 query, const guint64 *hashes, size_t count, int max_distance,
+                            size_t *indices) {
+    size_t n = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (__builtin_popcountll(query ^ hashes[i]) <= max_distance) {
+            indices[n++] = i;
+        }
+    }
+    return n;
+}
+
+// =============================================================================
+// Image diff
+// =============================================================================
+
+typedef struct {
+    VipsImage *a;
+    VipsImage *b;
+    int tile_size;
+    int tiles_across;
+    int n_tiles;
+    double tolerance;
+    int max_changed;
+    int next_tile;          // atomic
+    int n_changed;          // atomic
+    int stop;               // atomic; set once max_changed is exceeded or on error
+    int result;
+    GMutex lock;
+    int *boxes;             // left, top, width, height per changed tile
+    int capacity;
+    int n_boxes;
+} CVIPSDiffJob;
+
+// Returns 1 at the end of the first row in which any sample differs by more than `tolerance`.
+static int cvips_diff_rows_uchar(const VipsPel *pa, size_t stride_a, const VipsPel *pb, size_t stride_b,
+                                 int samples, int rows, int tolerance) {
+    for (int y = 0; y < rows; y++, pa += stride_a, pb += stride_b) {
+        int worst = 0;
+        // Branch-free inner loop so the compiler can vectorize it; check once per row
+        for (int i = 0; i < samples; i++) {
+            int d = VIPS_ABS((int)pa[i] - (int)pb[i]);
+            worst = d > worst ? d : worst;
+        }
+        if (worst > tolerance) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int cvips_diff_rows_float(const VipsPel *pa, size_t stride_a, const VipsPel *pb, size_t stride_b,
+                                 int samples, int rows, double tolerance) {
+    for (int y = 0; y < rows; y++, pa += stride_a, pb += stride_b) {
+        const float *fa = (const float *)pa;
+        const float *fb = (const float *)pb;
+        float worst = 0.0f;
+        for (int i = 0; i < samples; i++) {
+            float d = fabsf(fa[i] - fb[i]);
+            worst = d > worst ? d : worst;
+        }
+        if (worst > tolerance) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static gpointer cvips_diff_worker(gpointer data) {
+    CVIPSDiffJob *job = (CVIPSDiffJob *)data;
+    VipsRegion *ra = vips_region_new(job->a);
+    VipsRegion *rb = vips_region_new(job->b);
+    if (ra == NULL || rb == NULL) {
+        job->result = -1;
+        g_atomic_int_set(&job->stop, 1);
+        if (ra != NULL) {
+            g_object_unref(ra);
+        }
+        if (rb != NULL) {
+            g_object_unref(rb);
+        }
+        return NULL;
+    }
+    VipsRect bounds = { 0, 0, job->a->Xsize, job->a->Ysize };
+    int uchar = job->a->BandFmt == VIPS_FORMAT_UCHAR;
+
+    while (!g_atomic_int_get(&job->stop)) {
+        int index = g_atomic_int_add(&job->next_tile, 1);
+        if (index >= job->n_tiles) {
+            break;
+        }
+        VipsRect tile = {
+            (index % job->tiles_across) * job->tile_size,
+            (index / job->tiles_across) * job->tile_size,
+            job->tile_size, job->tile_size
+        };
+        vips_rect_intersectrect(&tile, &bounds, &tile);
+
+        if (vips_region_prepare(ra, &tile) || vips_region_prepare(rb, &tile)) {
+            job->result = -1;
+            g_atomic_int_set(&job->stop, 1);
+            break;
+        }
+        const VipsPel *pa = VIPS_REGION_ADDR(ra, tile.left, tile.top);
+        const VipsPel *pb = VIPS_REGION_ADDR(rb, tile.left, tile.top);
+        int samples = tile.width * job->a->Bands;
+        int changed = uchar
+            ? cvips_diff_rows_uchar(pa, VIPS_REGION_LSKIP(ra), pb, VIPS_REGION_LSKIP(rb), samples, tile.height,
+                                    (int)floor(job->tolerance))
+            : cvips_diff_rows_float(pa, VIPS_REGION_LSKIP(ra), pb, VIPS_REGION_LSKIP(rb), samples, tile.height,
+                                    job->tolerance);
+        if (!changed) {
+            continue;
+        }
+
+        g_mutex_lock(&job->lock);
+        if (job->n_boxes < job->capacity) {
+            int *box = job->boxes + job->n_boxes * 4;
+            box[0] = tile.left;
+            box[1] = tile.top;
+            box[2] = tile.width;
+            box[3] = tile.height;
+            job->n_boxes++;
+        }
+        g_mutex_unlock(&job->lock);
+
+        if (g_atomic_int_add(&job->n_changed, 1) >= job->max_changed && job->max_changed >= 0) {
+            g_atomic_int_set(&job->stop, 1);
+        }
+    }
+
+    g_object_unref(ra);
+    g_object_unref(rb);
+    return NULL;
+}
+
+static int cvips_diff_tiles_run(VipsImage *a, VipsImage *b, int tile_size, double tolerance, int max_changed,
+                                int threads, int *boxes, int capacity, int *n_boxes, int *exceeded) {
+    if (a->Xsize != b->Xsize || a->Ysize != b->Ysize || a->Bands != b->Bands) {
+        vips_error("cvips_diff_tiles", "images must have the same size and number of bands");
+        return -1;
+    }
+    if (tile_size < 1) {
+        vips_error("cvips_diff_tiles", "tile size must be positive");
+        return -1;
+    }
+
+    // 8-bit pairs are compared directly; anything else is compared as float
+    VipsImage *base = vips_image_new();
+    VipsImage **t = (VipsImage **)vips_object_local_array(VIPS_OBJECT(base), 2);
+    if (a->BandFmt == VIPS_FORMAT_UCHAR && b->BandFmt == VIPS_FORMAT_UCHAR) {
+        t[0] = a;
+        t[1] = b;
+        g_object_ref(a);
+        g_object_ref(b);
+    } else if (vips_cast(a, &t[0], VIPS_FORMAT_FLOAT, NULL) || vips_cast(b, &t[1], VIPS_FORMAT_FLOAT, NULL)) {
+        g_object_unref(base);
+        return -1;
+    }
+
+    int tiles_across = (a->Xsize + tile_size - 1) / tile_size;
+    int tiles_down = (a->Ysize + tile_size - 1) / tile_size;
+    CVIPSDiffJob job = {
+        .a = t[0],
+        .b = t[1],
+        .tile_size = tile_size,
+        .tiles_across = tiles_across,
+        .n_tiles = tiles_across * tiles_down,
+        .tolerance = tolerance,
+        .max_changed = max_changed,
+        .boxes = boxes,
+        .capacity = capacity,
+    };
+    g_mutex_init(&job.lock);
+
+    int n_workers = VIPS_CLIP(1, VIPS_MIN(threads, job.n_tiles), 64);
+    GThread **handles = g_new0(GThread *, n_workers);
+
+    // Worker 0 runs on the calling thread
+    for (int i = 1; i < n_workers; i++) {
+        handles[i] = vips_g_thread_new("cvips_diff", cvips_diff_worker, &job);
+    }
+    cvips_diff_worker(&job);
+    for (int i = 1; i < n_workers; i++) {
+        if (handles[i] != NULL) {
+            g_thread_join(handles[i]);
+        }
+    }
+
+    g_free(handles);
+    g_mutex_clear(&job.lock);
+    g_object_unref(base);
+
+    *n_boxes = job.n_boxes;
+    *exceeded = max_changed >= 0 && job.n_changed > max_changed;
+    return job.result;
+}
+
+int cvips_diff_tiles(VipsImage *a, VipsImage *b, int tile_size, double tolerance, int max_changed, int threads,
+                     int *boxes, int capacity, int *n_boxes, int *exceeded) {
+    CVIPS_PROFILED_COMPUTE(a, cvips_diff_tiles_run(a, b, tile_size, tolerance, max_changed, threads,
+                                                   boxes, capacity, n_boxes, exceeded));
+}
+
+// =============================================================================
+// Analysis previews
+// =============================================================================
+
+int cvips_preview(const char *filename, VipsImage **out, int size) {
+    CVIPS_PROFILED_LOAD(0, out, vips_thumbnail(filename, out, size, "height", size,
+                                               "size", VIPS_SIZE_DOWN, "no_rotate", TRUE, NULL));
+}
+
+int cvips_preview_buffer(const void *data, size_t length, VipsImage **out, int size) {
+    CVIPS_PROFILED_LOAD(length, out, vips_thumbnail_buffer((void *)data, length, out, size, "height", size,
+                                                           "size", VIPS_SIZE_DOWN, "no_rotate", TRUE, NULL));
+}
+
+int cvips_preview_image(VipsImage *in, VipsImage **out, int size) {
+    CVIPS_PROFILED_BUILD(in, out, vips_thumbnail_image(in, out, size, "height", size,
+                                                       "size", VIPS_SIZE_DOWN, "no_rotate", TRUE, NULL));
+}
+
+static int cvips_smartcrop_rect_run(VipsImage *in, int width, int height, VipsInteresting interesting,
+                                    int *left, int *top) {
+    VipsImage *out;
+    if (vips_smartcrop(in, &out, width, height, "interesting", interesting, NULL)) {
+        return -1;
+    }
+    // The window is chosen while building and vips_extract_area records its
+    // origin as a negative offset; the crop itself is never computed
+    *left = -out->Xoffset;
+    *top = -out->Yoffset;
+    g_object_unref(out);
+    return 0;
+}
+
+int cvips_smartcrop_rect(VipsImage *in, int width, int height, VipsInteresting interesting, int *left, int *top) {
+    CVIPS_PROFILED_COMPUTE(in, cvips_smartcrop_rect_run(in, width, height, interesting, left, top));
 }
 
 // =============================================================================
@@ -198,31 +1387,31 @@ int cvips_join(VipsImage *in1, VipsImage *in2, VipsImage **out, VipsDirection di
 // =============================================================================
 
 int cvips_write_to_file(VipsImage *in, const char *filename) {
-    return vips_image_write_to_file(in, filename, NULL);
+    CVIPS_PROFILED_SAVE(in, NULL, vips_image_write_to_file(in, filename, NULL));
 }
 
 int cvips_jpegsave(VipsImage *in, const char *filename, int quality) {
-    return vips_jpegsave(in, filename, "Q", quality, NULL);
+    CVIPS_PROFILED_SAVE(in, NULL, vips_jpegsave(in, filename, "Q", quality, NULL));
 }
 
 int cvips_pngsave(VipsImage *in, const char *filename) {
-    return vips_pngsave(in, filename, NULL);
+    CVIPS_PROFILED_SAVE(in, NULL, vips_pngsave(in, filename, NULL));
 }
 
 int cvips_webpsave(VipsImage *in, const char *filename, int quality) {
-    return vips_webpsave(in, filename, "Q", quality, NULL);
+    CVIPS_PROFILED_SAVE(in, NULL, vips_webpsave(in, filename, "Q", quality, NULL));
 }
 
 int cvips_webpsave_lossless(VipsImage *in, const char *filename) {
-    return vips_webpsave(in, filename, "lossless", TRUE, NULL);
+    CVIPS_PROFILED_SAVE(in, NULL, vips_webpsave(in, filename, "lossless", TRUE, NULL));
 }
 
 int cvips_jxlsave(VipsImage *in, const char *filename, int quality) {
-    return vips_jxlsave(in, filename, "Q", quality, NULL);
+    CVIPS_PROFILED_SAVE(in, NULL, vips_jxlsave(in, filename, "Q", quality, NULL));
 }
 
 int cvips_jxlsave_lossless(VipsImage *in, const char *filename) {
-    return vips_jxlsave(in, filename, "lossless", TRUE, NULL);
+    CVIPS_PROFILED_SAVE(in, NULL, vips_jxlsave(in, filename, "lossless", TRUE, NULL));
 }
 
 // =============================================================================
@@ -230,7 +1419,7 @@ int cvips_jxlsave_lossless(VipsImage *in, const char *filename) {
 // =============================================================================
 
 int cvips_hist_equal(VipsImage *in, VipsImage **out) {
-    return vips_hist_equal(in, out, NULL);
+    CVIPS_PROFILED(CVIPS_PROFILE_COMPUTE, in, 0, out, NULL, vips_hist_equal(in, out, NULL));
 }
 
 // =============================================================================
@@ -238,7 +1427,7 @@ int cvips_hist_equal(VipsImage *in, VipsImage **out) {
 // =============================================================================
 
 int cvips_rotate(VipsImage *in, VipsImage **out, double angle) {
-    return vips_rotate(in, out, angle, NULL);
+    CVIPS_PROFILED_BUILD(in, out, vips_rotate(in, out, angle, NULL));
 }
 
 // =============================================================================
@@ -246,11 +1435,11 @@ int cvips_rotate(VipsImage *in, VipsImage **out, double angle) {
 // =============================================================================
 
 int cvips_embed(VipsImage *in, VipsImage **out, int x, int y, int width, int height, VipsExtend extend) {
-    return vips_embed(in, out, x, y, width, height, "extend", extend, NULL);
+    CVIPS_PROFILED_BUILD(in, out, vips_embed(in, out, x, y, width, height, "extend", extend, NULL));
 }
 
 int cvips_gravity(VipsImage *in, VipsImage **out, VipsCompassDirection direction, int width, int height, VipsExtend extend) {
-    return vips_gravity(in, out, direction, width, height, "extend", extend, NULL);
+    CVIPS_PROFILED_BUILD(in, out, vips_gravity(in, out, direction, width, height, "extend", extend, NULL));
 }
 
 // =============================================================================
@@ -258,15 +1447,15 @@ int cvips_gravity(VipsImage *in, VipsImage **out, VipsCompassDirection direction
 // =============================================================================
 
 int cvips_bandjoin2(VipsImage *in1, VipsImage *in2, VipsImage **out) {
-    return vips_bandjoin2(in1, in2, out, NULL);
+    CVIPS_PROFILED_BUILD(in1, out, vips_bandjoin2(in1, in2, out, NULL));
 }
 
 int cvips_bandjoin_const1(VipsImage *in, VipsImage **out, double c) {
-    return vips_bandjoin_const1(in, out, c, NULL);
+    CVIPS_PROFILED_BUILD(in, out, vips_bandjoin_const1(in, out, c, NULL));
 }
 
 int cvips_addalpha(VipsImage *in, VipsImage **out) {
-    return vips_addalpha(in, out, NULL);
+    CVIPS_PROFILED_BUILD(in, out, vips_addalpha(in, out, NULL));
 }
 
 // =============================================================================
@@ -274,11 +1463,11 @@ int cvips_addalpha(VipsImage *in, VipsImage **out) {
 // =============================================================================
 
 int cvips_premultiply(VipsImage *in, VipsImage **out) {
-    return vips_premultiply(in, out, NULL);
+    CVIPS_PROFILED_BUILD(in, out, vips_premultiply(in, out, NULL));
 }
 
 int cvips_unpremultiply(VipsImage *in, VipsImage **out) {
-    return vips_unpremultiply(in, out, NULL);
+    CVIPS_PROFILED_BUILD(in, out, vips_unpremultiply(in, out, NULL));
 }
 
 // =============================================================================
@@ -286,7 +1475,7 @@ int cvips_unpremultiply(VipsImage *in, VipsImage **out) {
 // =============================================================================
 
 int cvips_black(VipsImage **out, int width, int height, int bands) {
-    return vips_black(out, width, height, "bands", bands, NULL);
+    CVIPS_PROFILED_BUILD(NULL, out, vips_black(out, width, height, "bands", bands, NULL));
 }
 
 // =============================================================================
@@ -294,19 +1483,451 @@ int cvips_black(VipsImage **out, int width, int height, int bands) {
 // =============================================================================
 
 int cvips_draw_rect(VipsImage *image, double *ink, int n, int left, int top, int width, int height, int fill) {
-    return vips_draw_rect(image, ink, n, left, top, width, height, "fill", fill, NULL);
+    CVIPS_PROFILED_DRAW(image, vips_draw_rect(image, ink, n, left, top, width, height, "fill", fill, NULL));
 }
 
 int cvips_draw_line(VipsImage *image, double *ink, int n, int x1, int y1, int x2, int y2) {
-    return vips_draw_line(image, ink, n, x1, y1, x2, y2, NULL);
+    CVIPS_PROFILED_DRAW(image, vips_draw_line(image, ink, n, x1, y1, x2, y2, NULL));
 }
 
 int cvips_draw_circle(VipsImage *image, double *ink, int n, int cx, int cy, int radius, int fill) {
-    return vips_draw_circle(image, ink, n, cx, cy, radius, "fill", fill, NULL);
+    CVIPS_PROFILED_DRAW(image, vips_draw_circle(image, ink, n, cx, cy, radius, "fill", fill, NULL));
 }
 
 int cvips_draw_flood(VipsImage *image, double *ink, int n, int x, int y) {
-    return vips_draw_flood(image, ink, n, x, y, "equal", TRUE, NULL);
+    CVIPS_PROFILED_DRAW(image, vips_draw_flood(image, ink, n, x, y, "equal", TRUE, NULL));
+}
+
+// =============================================================================
+// Draw lists
+// =============================================================================
+
+// Commands are binned into square tiles; each tile is rasterized by one worker,
+// applying its commands in list order, so tiles never share pixels.
+#define CVIPS_DRAW_TILE 256
+
+// Vertical samples per row when antialiasing polygon fills.
+#define CVIPS_DRAW_SUBROWS 4
+
+typedef struct {
+    VipsImage *image;
+    const CVIPSDrawCommand *commands;
+    const double *points;
+    const double *inks;
+    int antialias;
+    int tiles_across;
+    int n_tiles;
+    const int *bin_start;   // n_tiles + 1 offsets into bin_commands
+    const int *bin_commands;
+    gint next_tile;
+} CVIPSDrawJob;
+
+typedef struct {
+    CVIPSDrawJob *job;
+    VipsRect tile;
+    const double *ink;
+    float *coverage;        // one row of polygon coverage, tile wide
+    double *crossings;
+    int crossings_capacity;
+} CVIPSDrawWorker;
+
+static inline void cvips_draw_blend(CVIPSDrawWorker *worker, int x, int y, double coverage) {
+    VipsImage *image = worker->job->image;
+    const double *ink = worker->ink;
+    VipsPel *p = VIPS_IMAGE_ADDR(image, x, y);
+    int bands = image->Bands;
+
+    switch (image->BandFmt) {
+    case VIPS_FORMAT_UCHAR:
+        for (int b = 0; b < bands; b++) {
+            double v = p[b] + (ink[b] - p[b]) * coverage;
+            p[b] = (VipsPel)VIPS_CLIP(0, v + 0.5, 255);
+        }
+        break;
+    case VIPS_FORMAT_USHORT: {
+        unsigned short *q = (unsigned short *)p;
+        for (int b = 0; b < bands; b++) {
+            double v = q[b] + (ink[b] - q[b]) * coverage;
+            q[b] = (unsigned short)VIPS_CLIP(0, v + 0.5, 65535);
+        }
+        break;
+    }
+    default: {
+        float *q = (float *)p;
+        for (int b = 0; b < bands; b++) {
+            q[b] = (float)(q[b] + (ink[b] - q[b]) * coverage);
+        }
+        break;
+    }
+    }
+}
+
+static inline void cvips_draw_plot(CVIPSDrawWorker *worker, int x, int y, double coverage) {
+    if (coverage > 0 && vips_rect_includespoint(&worker->tile, x, y)) {
+        cvips_draw_blend(worker, x, y, VIPS_MIN(coverage, 1.0));
+    }
+}
+
+// Pixel (x, y) covers [x, x + 1) x [y, y + 1), so integer rectangles land exactly
+// on pixel boundaries and antialiased edges get their fractional overlap.
+static void cvips_draw_area(CVIPSDrawWorker *worker, double left, double top, double width, double height) {
+    const VipsRect *tile = &worker->tile;
+    double right = left + width;
+    double bottom = top + height;
+    int x0 = VIPS_MAX(tile->left, (int)floor(left));
+    int x1 = VIPS_MIN(VIPS_RECT_RIGHT(tile), (int)ceil(right));
+    int y0 = VIPS_MAX(tile->top, (int)floor(top));
+    int y1 = VIPS_MIN(VIPS_RECT_BOTTOM(tile), (int)ceil(bottom));
+
+    for (int y = y0; y < y1; y++) {
+        double cy = VIPS_MIN(y + 1.0, bottom) - VIPS_MAX((double)y, top);
+        for (int x = x0; x < x1; x++) {
+            if (worker->job->antialias) {
+                double cx = VIPS_MIN(x + 1.0, right) - VIPS_MAX((double)x, left);
+                cvips_draw_plot(worker, x, y, cx * cy);
+            } else if (x + 0.5 >= left && x + 0.5 < right && y + 0.5 >= top && y + 0.5 < bottom) {
+                cvips_draw_blend(worker, x, y, 1.0);
+            }
+        }
+    }
+}
+
+// Lines address pixel centres, as vips_draw_line does. Only the part of the
+// line's major axis inside the tile is walked, and each step is computed from
+// the original endpoints, so the result does not depend on the tiling.
+static void cvips_draw_segment(CVIPSDrawWorker *worker, double x1, double y1, double x2, double y2) {
+    const VipsRect *tile = &worker->tile;
+    double dx = x2 - x1;
+    double dy = y2 - y1;
+    gboolean steep = fabs(dy) > fabs(dx);
+    double a1 = steep ? y1 : x1, b1 = steep ? x1 : y1;
+    double da = steep ? dy : dx, db = steep ? dx : dy;
+    int lo = steep ? tile->top : tile->left;
+    int hi = steep ? VIPS_RECT_BOTTOM(tile) : VIPS_RECT_RIGHT(tile);
+
+    int start = VIPS_MAX(lo, (int)floor(VIPS_MIN(a1, a1 + da) + 0.5));
+    int end = VIPS_MIN(hi - 1, (int)floor(VIPS_MAX(a1, a1 + da) + 0.5));
+    double slope = da != 0 ? db / da : 0;
+
+    for (int a = start; a <= end; a++) {
+        double b = b1 + (a - a1) * slope;
+        if (worker->job->antialias) {
+            int base = (int)floor(b);
+            double frac = b - base;
+            cvips_draw_plot(worker, steep ? base : a, steep ? a : base, 1.0 - frac);
+            cvips_draw_plot(worker, steep ? base + 1 : a, steep ? a : base + 1, frac);
+        } else {
+            int base = (int)floor(b + 0.5);
+            cvips_draw_plot(worker, steep ? base : a, steep ? a : base, 1.0);
+        }
+    }
+}
+
+static void cvips_draw_circle_in_tile(CVIPSDrawWorker *worker, double cx, double cy, double radius, int fill) {
+    const VipsRect *tile = &worker->tile;
+    int x0 = VIPS_MAX(tile->left, (int)floor(cx - radius - 1));
+    int x1 = VIPS_MIN(VIPS_RECT_RIGHT(tile) - 1, (int)ceil(cx + radius + 1));
+    int y0 = VIPS_MAX(tile->top, (int)floor(cy - radius - 1));
+    int y1 = VIPS_MIN(VIPS_RECT_BOTTOM(tile) - 1, (int)ceil(cy + radius + 1));
+
+    for (int y = y0; y <= y1; y++) {
+        for (int x = x0; x <= x1; x++) {
+            double d = sqrt((x - cx) * (x - cx) + (y - cy) * (y - cy));
+            double coverage;
+            if (worker->job->antialias) {
+                coverage = fill ? radius + 0.5 - d : 1.0 - fabs(d - radius);
+            } else {
+                coverage = (fill ? d <= radius + 0.5 : fabs(d - radius) < 0.5) ? 1.0 : 0.0;
+            }
+            cvips_draw_plot(worker, x, y, coverage);
+        }
+    }
+}
+
+// Even-odd scanline fill, sampled like rectangles (pixel centres at +0.5).
+static void cvips_draw_polygon_fill(CVIPSDrawWorker *worker, const double *points, int n) {
+    const VipsRect *tile = &worker->tile;
+    int subrows = worker->job->antialias ? CVIPS_DRAW_SUBROWS : 1;
+
+    if (worker->crossings_capacity < n) {
+        worker->crossings_capacity = n;
+        worker->crossings = g_renew(double, worker->crossings, n);
+    }
+    double *crossings = worker->crossings;
+
+    double top = points[1], bottom = points[1];
+    for (int i = 1; i < n; i++) {
+        top = VIPS_MIN(top, points[i * 2 + 1]);
+        bottom = VIPS_MAX(bottom, points[i * 2 + 1]);
+    }
+    int y0 = VIPS_MAX(tile->top, (int)floor(top));
+    int y1 = VIPS_MIN(VIPS_RECT_BOTTOM(tile), (int)ceil(bottom));
+
+    for (int y = y0; y < y1; y++) {
+        gboolean touched = FALSE;
+        for (int s = 0; s < subrows; s++) {
+            double sy = y + (s + 0.5) / subrows;
+            int n_crossings = 0;
+            for (int i = 0; i < n; i++) {
+                const double *p = points + i * 2;
+                const double *q = points + ((i + 1) % n) * 2;
+                if ((p[1] <= sy && sy < q[1]) || (q[1] <= sy && sy < p[1])) {
+                    double x = p[0] + (sy - p[1]) * (q[0] - p[0]) / (q[1] - p[1]);
+                    int j = n_crossings++;
+                    for (; j > 0 && crossings[j - 1] > x; j--) {
+                        crossings[j] = crossings[j - 1];
+                    }
+                    crossings[j] = x;
+                }
+            }
+
+            for (int i = 0; i + 1 < n_crossings; i += 2) {
+                double left = crossings[i];
+                double right = crossings[i + 1];
+                if (worker->job->antialias) {
+                    int x0 = VIPS_MAX(tile->left, (int)floor(left));
+                    int x1 = VIPS_MIN(VIPS_RECT_RIGHT(tile), (int)ceil(right));
+                    for (int x = x0; x < x1; x++) {
+                        double overlap = VIPS_MIN(x + 1.0, right) - VIPS_MAX((double)x, left);
+                        worker->coverage[x - tile->left] += (float)(overlap / subrows);
+                        touched = TRUE;
+                    }
+                } else {
+                    int x0 = VIPS_MAX(tile->left, (int)ceil(left - 0.5));
+                    int x1 = VIPS_MIN(VIPS_RECT_RIGHT(tile), (int)ceil(right - 0.5));
+                    for (int x = x0; x < x1; x++) {
+                        cvips_draw_blend(worker, x, y, 1.0);
+                    }
+                }
+            }
+        }
+
+        if (touched) {
+            for (int x = 0; x < tile->width; x++) {
+                if (worker->coverage[x] > 0) {
+                    cvips_draw_blend(worker, tile->left + x, y, VIPS_MIN(worker->coverage[x], 1.0f));
+                    worker->coverage[x] = 0;
+                }
+            }
+        }
+    }
+}
+
+static void cvips_draw_command(CVIPSDrawWorker *worker, const CVIPSDrawCommand *command) {
+    CVIPSDrawJob *job = worker->job;
+    const double *args = command->args;
+    const double *points = job->points + (size_t)command->first_point * 2;
+    int n = command->n_points;
+    worker->ink = job->inks + (size_t)command->ink * job->image->Bands;
+
+    switch (command->kind) {
+    case CVIPS_DRAW_RECT:
+        if (command->fill) {
+            cvips_draw_area(worker, args[0], args[1], args[2], args[3]);
+        } else {
+            // One pixel wide edges inside the rectangle, as vips_draw_rect draws them
+            cvips_draw_area(worker, args[0], args[1], args[2], 1);
+            cvips_draw_area(worker, args[0], args[1] + args[3] - 1, args[2], 1);
+            cvips_draw_area(worker, args[0], args[1] + 1, 1, args[3] - 2);
+            cvips_draw_area(worker, args[0] + args[2] - 1, args[1] + 1, 1, args[3] - 2);
+        }
+        break;
+    case CVIPS_DRAW_LINE:
+        cvips_draw_segment(worker, args[0], args[1], args[2], args[3]);
+        break;
+    case CVIPS_DRAW_CIRCLE:
+        cvips_draw_circle_in_tile(worker, args[0], args[1], args[2], command->fill);
+        break;
+    case CVIPS_DRAW_POLYGON:
+        if (command->fill && n >= 3) {
+            cvips_draw_polygon_fill(worker, points, n);
+            break;
+        }
+        // Outlined polygons are closed polylines
+        for (int i = 0; i < n; i++) {
+            const double *p = points + i * 2;
+            const double *q = points + ((i + 1) % n) * 2;
+            cvips_draw_segment(worker, p[0], p[1], q[0], q[1]);
+        }
+        break;
+    case CVIPS_DRAW_POLYLINE:
+        for (int i = 0; i + 1 < n; i++) {
+            cvips_draw_segment(worker, points[i * 2], points[i * 2 + 1], points[i * 2 + 2], points[i * 2 + 3]);
+        }
+        break;
+    }
+}
+
+static gpointer cvips_draw_worker(gpointer data) {
+    CVIPSDrawWorker *worker = (CVIPSDrawWorker *)data;
+    CVIPSDrawJob *job = worker->job;
+    VipsImage *image = job->image;
+
+    for (;;) {
+        int index = g_atomic_int_add(&job->next_tile, 1);
+        if (index >= job->n_tiles) {
+            break;
+        }
+        VipsRect tile = {
+            (index % job->tiles_across) * CVIPS_DRAW_TILE,
+            (index / job->tiles_across) * CVIPS_DRAW_TILE,
+            CVIPS_DRAW_TILE, CVIPS_DRAW_TILE
+        };
+        VipsRect bounds = { 0, 0, image->Xsize, image->Ysize };
+        vips_rect_intersectrect(&tile, &bounds, &worker->tile);
+
+        for (int i = job->bin_start[index]; i < job->bin_start[index + 1]; i++) {
+            cvips_draw_command(worker, &job->commands[job->bin_commands[i]]);
+        }
+    }
+    return NULL;
+}
+
+// The area a command can touch, including one pixel of antialiasing spill.
+static void cvips_draw_bounds(const CVIPSDrawCommand *command, const double *points, VipsRect *out) {
+    const double *args = command->args;
+    double left, top, right, bottom;
+
+    switch (command->kind) {
+    case CVIPS_DRAW_RECT:
+        left = args[0], top = args[1], right = args[0] + args[2], bottom = args[1] + args[3];
+        break;
+    case CVIPS_DRAW_LINE:
+        left = VIPS_MIN(args[0], args[2]), right = VIPS_MAX(args[0], args[2]);
+        top = VIPS_MIN(args[1], args[3]), bottom = VIPS_MAX(args[1], args[3]);
+        break;
+    case CVIPS_DRAW_CIRCLE:
+        left = args[0] - args[2], right = args[0] + args[2];
+        top = args[1] - args[2], bottom = args[1] + args[2];
+        break;
+    default: {
+        if (command->n_points < 1) {
+            *out = (VipsRect){ 0, 0, 0, 0 };
+            return;
+        }
+        const double *p = points + (size_t)command->first_point * 2;
+        left = right = p[0];
+        top = bottom = p[1];
+        for (int i = 1; i < command->n_points; i++) {
+            left = VIPS_MIN(left, p[i * 2]), right = VIPS_MAX(right, p[i * 2]);
+            top = VIPS_MIN(top, p[i * 2 + 1]), bottom = VIPS_MAX(bottom, p[i * 2 + 1]);
+        }
+        break;
+    }
+    }
+
+    int x0 = (int)floor(left) - 1;
+    int y0 = (int)floor(top) - 1;
+    *out = (VipsRect){ x0, y0, (int)ceil(right) + 2 - x0, (int)ceil(bottom) + 2 - y0 };
+}
+
+static int cvips_draw_list_run(VipsImage *image, const CVIPSDrawCommand *commands, int count,
+                               const double *points, const double *inks, int antialias, int threads) {
+    if (image->BandFmt != VIPS_FORMAT_UCHAR && image->BandFmt != VIPS_FORMAT_USHORT &&
+        image->BandFmt != VIPS_FORMAT_FLOAT) {
+        vips_error("cvips_draw_list", "expected a uchar, ushort or float image");
+        return -1;
+    }
+    if (vips_image_inplace(image)) {
+        return -1;
+    }
+    if (count <= 0) {
+        return 0;
+    }
+
+    int tiles_across = VIPS_ROUND_UP(image->Xsize, CVIPS_DRAW_TILE) / CVIPS_DRAW_TILE;
+    int tiles_down = VIPS_ROUND_UP(image->Ysize, CVIPS_DRAW_TILE) / CVIPS_DRAW_TILE;
+    int n_tiles = tiles_across * tiles_down;
+    VipsRect image_rect = { 0, 0, image->Xsize, image->Ysize };
+
+    // Bin in two passes: count the commands touching each tile, then fill a
+    // flat index array in list order.
+    int *bin_start = g_new0(int, n_tiles + 1);
+    VipsRect *tile_ranges = g_new(VipsRect, count);
+    for (int i = 0; i < count; i++) {
+        VipsRect bounds;
+        cvips_draw_bounds(&commands[i], points, &bounds);
+        vips_rect_intersectrect(&bounds, &image_rect, &bounds);
+        if (vips_rect_isempty(&bounds)) {
+            tile_ranges[i] = (VipsRect){ 0, 0, 0, 0 };
+            continue;
+        }
+        int tx0 = bounds.left / CVIPS_DRAW_TILE;
+        int ty0 = bounds.top / CVIPS_DRAW_TILE;
+        int tx1 = (VIPS_RECT_RIGHT(&bounds) - 1) / CVIPS_DRAW_TILE;
+        int ty1 = (VIPS_RECT_BOTTOM(&bounds) - 1) / CVIPS_DRAW_TILE;
+        tile_ranges[i] = (VipsRect){ tx0, ty0, tx1 - tx0 + 1, ty1 - ty0 + 1 };
+        for (int ty = ty0; ty <= ty1; ty++) {
+            for (int tx = tx0; tx <= tx1; tx++) {
+                bin_start[ty * tiles_across + tx + 1]++;
+            }
+        }
+    }
+    for (int t = 0; t < n_tiles; t++) {
+        bin_start[t + 1] += bin_start[t];
+    }
+    int *bin_commands = g_new(int, VIPS_MAX(1, bin_start[n_tiles]));
+    int *fill = g_new(int, n_tiles);
+    memcpy(fill, bin_start, sizeof(int) * n_tiles);
+    for (int i = 0; i < count; i++) {
+        const VipsRect *r = &tile_ranges[i];
+        for (int ty = r->top; ty < VIPS_RECT_BOTTOM(r); ty++) {
+            for (int tx = r->left; tx < VIPS_RECT_RIGHT(r); tx++) {
+                bin_commands[fill[ty * tiles_across + tx]++] = i;
+            }
+        }
+    }
+    g_free(fill);
+    g_free(tile_ranges);
+
+    CVIPSDrawJob job = {
+        .image = image,
+        .commands = commands,
+        .points = points,
+        .inks = inks,
+        .antialias = antialias,
+        .tiles_across = tiles_across,
+        .n_tiles = n_tiles,
+        .bin_start = bin_start,
+        .bin_commands = bin_commands,
+        .next_tile = 0,
+    };
+
+    int n_workers = VIPS_CLIP(1, VIPS_MIN(threads, n_tiles), 64);
+    CVIPSDrawWorker *workers = g_new0(CVIPSDrawWorker, n_workers);
+    GThread **handles = g_new0(GThread *, n_workers);
+    for (int i = 0; i < n_workers; i++) {
+        workers[i].job = &job;
+        workers[i].coverage = g_new0(float, CVIPS_DRAW_TILE);
+    }
+
+    // Worker 0 runs on the calling thread
+    for (int i = 1; i < n_workers; i++) {
+        handles[i] = vips_g_thread_new("cvips_draw", cvips_draw_worker, &workers[i]);
+    }
+    cvips_draw_worker(&workers[0]);
+
+    for (int i = 0; i < n_workers; i++) {
+        if (handles[i] != NULL) {
+            g_thread_join(handles[i]);
+        }
+        g_free(workers[i].coverage);
+        g_free(workers[i].crossings);
+    }
+
+    g_free(handles);
+    g_free(workers);
+    g_free(bin_commands);
+    g_free(bin_start);
+
+    // Drawing bypasses the pipeline, so tell any downstream images to recompute
+    vips_image_invalidate_all(image);
+    return 0;
+}
+
+int cvips_draw_list(VipsImage *image, const CVIPSDrawCommand *commands, int count,
+                    const double *points, const double *inks, int antialias, int threads) {
+    CVIPS_PROFILED_DRAW(image, cvips_draw_list_run(image, commands, count, points, inks, antialias, threads));
 }
 
 // =============================================================================
@@ -314,7 +1935,295 @@ int cvips_draw_flood(VipsImage *image, double *ink, int n, int x, int y) {
 // =============================================================================
 
 int cvips_getpoint(VipsImage *in, double **vector, int *n, int x, int y) {
-    return vips_getpoint(in, vector, n, x, y, NULL);
+    CVIPS_PROFILED_COMPUTE(in, vips_getpoint(in, vector, n, x, y, NULL));
+}
+
+// =============================================================================
+// Direct memory access
+// =============================================================================
+
+const void *cvips_image_peek_memory(VipsImage *in) {
+    // Only report pixels that are already resident; never trigger evaluation.
+    switch (in->dtype) {
+    case VIPS_IMAGE_SETBUF:
+    case VIPS_IMAGE_SETBUF_FOREIGN:
+    case VIPS_IMAGE_MMAPIN:
+        return in->data;
+    default:
+        return NULL;
+    }
+}
+
+// =============================================================================
+// Raw memory import / export
+// =============================================================================
+
+typedef struct {
+    CVIPSReleaseCallback release;
+    void *context;
+} CVIPSMemoryOwner;
+
+// Runs once the last image reading the caller's memory has been closed.
+static void cvips_memory_owner_release(VipsObject *object, gpointer data) {
+    CVIPSMemoryOwner *owner = (CVIPSMemoryOwner *)data;
+    owner->release(owner->context);
+    g_free(owner);
+}
+
+static void cvips_memory_free(VipsObject *object, gpointer data) {
+    g_free(data);
+}
+
+// libvips has no half-float format, so half samples travel as 32-bit float.
+static inline float cvips_half_to_float(guint16 h) {
+    const union { guint32 u; float f; } magic = { 113u << 23 };
+    const guint32 shifted_exp = 0x7c00u << 13;
+    union { guint32 u; float f; } out;
+    out.u = (guint32)(h & 0x7fffu) << 13;
+    guint32 exp = shifted_exp & out.u;
+    out.u += (guint32)(127 - 15) << 23;
+    if (exp == shifted_exp) {
+        out.u += (guint32)(128 - 16) << 23;  // Inf / NaN
+    } else if (exp == 0) {
+        out.u += 1u << 23;                   // Subnormal
+        out.f -= magic.f;
+    }
+    out.u |= (guint32)(h & 0x8000u) << 16;
+    return out.f;
+}
+
+// Round to nearest even; out-of-range values become infinity.
+static inline guint16 cvips_float_to_half(float value) {
+    const guint32 f32_infinity = 255u << 23;
+    const guint32 f16_limit = (127u + 16u) << 23;
+    const union { guint32 u; float f; } denormal_magic = { ((127u - 15u) + (23u - 10u) + 1u) << 23 };
+    union { float f; guint32 u; } in = { value };
+    guint32 sign = in.u & 0x80000000u;
+    guint16 out;
+
+    in.u ^= sign;
+    if (in.u >= f16_limit) {
+        out = in.u > f32_infinity ? 0x7e00 : 0x7c00;
+    } else if (in.u < (113u << 23)) {
+        in.f += denormal_magic.f;
+        out = (guint16)(in.u - denormal_magic.u);
+    } else {
+        guint32 odd = (in.u >> 13) & 1;
+        in.u += ((guint32)(15 - 127) << 23) + 0xfff;
+        in.u += odd;
+        out = (guint16)(in.u >> 13);
+    }
+    return out | (guint16)(sign >> 16);
+}
+
+// Wrap a packed buffer that libvips will g_free when the image closes.
+static VipsImage *cvips_image_new_from_packed(void *packed, int width, int height, int bands,
+                                              VipsBandFormat format, VipsInterpretation interpretation) {
+    size_t size = (size_t)width * height * bands * vips_format_sizeof(format);
+    VipsImage *image = vips_image_new_from_memory(packed, size, width, height, bands, format);
+    if (image == NULL) {
+        g_free(packed);
+        return NULL;
+    }
+    image->Type = interpretation;
+    g_signal_connect(image, "postclose", G_CALLBACK(cvips_memory_free), packed);
+    return image;
+}
+
+static VipsImage *cvips_image_new_from_memory_owned_run(const void *data, size_t stride, int width, int height, int bands,
+                                                        VipsBandFormat format, VipsInterpretation interpretation,
+                                                        CVIPSReleaseCallback release, void *context) {
+    size_t pel = (size_t)bands * vips_format_sizeof(format);
+    size_t row = pel * width;
+    if (stride < row) {
+        vips_error("cvips_image_new_from_memory_owned", "row stride is smaller than a row of pixels");
+        release(context);
+        return NULL;
+    }
+
+    // A stride that is not a whole number of pixels cannot be expressed as a
+    // wider image, so pack the rows into a buffer libvips owns instead.
+    if (stride % pel != 0) {
+        VipsPel *packed = g_try_malloc(row * height);
+        if (packed == NULL) {
+            vips_error("cvips_image_new_from_memory_owned", "out of memory");
+            release(context);
+            return NULL;
+        }
+        for (int y = 0; y < height; y++) {
+            memcpy(packed + row * y, (const VipsPel *)data + stride * y, row);
+        }
+        release(context);
+        return cvips_image_new_from_packed(packed, width, height, bands, format, interpretation);
+    }
+
+    // Padded rows are wrapped as a wider image and cropped, so the padding is
+    // never read and nothing is copied. The crop holds a reference to the
+    // wrapper, which keeps the owner alive for as long as either is in use.
+    int wrap_width = (int)(stride / pel);
+    VipsImage *wrapper = vips_image_new_from_memory(data, stride * height, wrap_width, height, bands, format);
+    if (wrapper == NULL) {
+        release(context);
+        return NULL;
+    }
+    wrapper->Type = interpretation;
+    CVIPSMemoryOwner *owner = g_new(CVIPSMemoryOwner, 1);
+    owner->release = release;
+    owner->context = context;
+    g_signal_connect(wrapper, "postclose", G_CALLBACK(cvips_memory_owner_release), owner);
+
+    if (wrap_width == width) {
+        return wrapper;
+    }
+
+    // Build the crop directly rather than through vips_extract_area, which would
+    // leave the operation, and with it a reference to the wrapper, in the
+    // operation cache long after the caller has dropped the image.
+    VipsImage *cropped = NULL;
+    VipsOperation *op = vips_operation_new("extract_area");
+    if (op != NULL) {
+        g_object_set(op, "input", wrapper, "left", 0, "top", 0, "width", width, "height", height, NULL);
+        if (vips_object_build(VIPS_OBJECT(op)) == 0) {
+            g_object_get(op, "out", &cropped, NULL);
+        }
+        vips_object_unref_outputs(VIPS_OBJECT(op));
+        g_object_unref(op);
+    }
+    g_object_unref(wrapper);
+    return cropped;
+}
+
+VipsImage *cvips_image_new_from_memory_owned(const void *data, size_t stride, int width, int height, int bands,
+                                             VipsBandFormat format, VipsInterpretation interpretation,
+                                             CVIPSReleaseCallback release, void *context) {
+    CVIPS_PROFILED_NEW(stride * height, cvips_image_new_from_memory_owned_run(data, stride, width, height, bands,
+                                                                              format, interpretation, release, context));
+}
+
+static VipsImage *cvips_image_new_from_half_run(const void *data, size_t stride, int width, int height, int bands,
+                                                VipsInterpretation interpretation) {
+    size_t samples = (size_t)width * bands;
+    if (stride < samples * sizeof(guint16)) {
+        vips_error("cvips_image_new_from_half", "row stride is smaller than a row of pixels");
+        return NULL;
+    }
+    float *packed = g_try_malloc(samples * height * sizeof(float));
+    if (packed == NULL) {
+        vips_error("cvips_image_new_from_half", "out of memory");
+        return NULL;
+    }
+    for (int y = 0; y < height; y++) {
+        const guint16 *src = (const guint16 *)((const VipsPel *)data + stride * y);
+        float *dst = packed + samples * y;
+        for (size_t i = 0; i < samples; i++) {
+            dst[i] = cvips_half_to_float(src[i]);
+        }
+    }
+    return cvips_image_new_from_packed(packed, width, height, bands, VIPS_FORMAT_FLOAT, interpretation);
+}
+
+VipsImage *cvips_image_new_from_half(const void *data, size_t stride, int width, int height, int bands,
+                                     VipsInterpretation interpretation) {
+    CVIPS_PROFILED_NEW(stride * height, cvips_image_new_from_half_run(data, stride, width, height, bands, interpretation));
+}
+
+typedef struct {
+    VipsPel *buffer;
+    size_t stride;
+    int half;
+} CVIPSMemoryTarget;
+
+// vips_sink_disc computes strips in parallel and hands them here in order,
+// one at a time, so rows can be written straight into the caller's buffer.
+static int cvips_memory_target_write(VipsRegion *region, VipsRect *area, void *a) {
+    CVIPSMemoryTarget *target = (CVIPSMemoryTarget *)a;
+    int bands = region->im->Bands;
+    size_t row = (size_t)VIPS_IMAGE_SIZEOF_PEL(region->im) * area->width;
+    size_t samples = (size_t)area->width * bands;
+
+    for (int y = 0; y < area->height; y++) {
+        VipsPel *src = VIPS_REGION_ADDR(region, area->left, area->top + y);
+        VipsPel *dst = target->buffer + target->stride * (area->top + y);
+        if (target->half) {
+            const float *from = (const float *)src;
+            guint16 *to = (guint16 *)dst + (size_t)area->left * bands;
+            for (size_t i = 0; i < samples; i++) {
+                to[i] = cvips_float_to_half(from[i]);
+            }
+        } else {
+            memcpy(dst + (size_t)VIPS_IMAGE_SIZEOF_PEL(region->im) * area->left, src, row);
+        }
+    }
+    return 0;
+}
+
+static int cvips_image_write_to_memory_strided_run(VipsImage *in, void *buffer, size_t stride, int half) {
+    if (half && in->BandFmt != VIPS_FORMAT_FLOAT) {
+        vips_error("cvips_image_write_to_memory_strided", "half-float output needs a float image");
+        return -1;
+    }
+    size_t row = half ? (size_t)in->Xsize * in->Bands * sizeof(guint16) : (size_t)VIPS_IMAGE_SIZEOF_LINE(in);
+    if (stride < row) {
+        vips_error("cvips_image_write_to_memory_strided", "row stride is smaller than a row of pixels");
+        return -1;
+    }
+    CVIPSMemoryTarget target = { (VipsPel *)buffer, stride, half };
+    return vips_sink_disc(in, cvips_memory_target_write, &target);
+}
+
+int cvips_image_write_to_memory_strided(VipsImage *in, void *buffer, size_t stride, int half) {
+    CVIPS_PROFILED_COMPUTE(in, cvips_image_write_to_memory_strided_run(in, buffer, stride, half));
+}
+
+// =============================================================================
+// Region reading
+// =============================================================================
+
+static int cvips_region_prepare_area_run(VipsRegion *region, int left, int top, int width, int height, VipsPel **data, size_t *stride) {
+    VipsRect rect = { left, top, width, height };
+    if (vips_region_prepare(region, &rect) != 0) {
+        return -1;
+    }
+    if (!vips_rect_includesrect(&region->valid, &rect)) {
+        vips_error("cvips_region_prepare_area", "requested area lies outside the image");
+        return -1;
+    }
+    *data = VIPS_REGION_ADDR(region, left, top);
+    *stride = VIPS_REGION_LSKIP(region);
+    return 0;
+}
+
+int cvips_region_prepare_area(VipsRegion *region, int left, int top, int width, int height, VipsPel **data, size_t *stride) {
+    CVIPS_PROFILE_BEGIN(NULL, 0);
+    int result = cvips_region_prepare_area_run(region, left, top, width, height, data, stride);
+    size_t length = (size_t)VIPS_IMAGE_SIZEOF_PEL(region->im) * width * height;
+    CVIPS_PROFILE_END(CVIPS_PROFILE_READ, result, NULL, &length);
+    return result;
+}
+
+static int cvips_region_read_run(VipsRegion *region, int left, int top, int width, int height, void *buffer, size_t stride) {
+    VipsPel *src;
+    size_t src_stride;
+    if (cvips_region_prepare_area_run(region, left, top, width, height, &src, &src_stride) != 0) {
+        return -1;
+    }
+
+    size_t row_bytes = (size_t)VIPS_IMAGE_SIZEOF_PEL(region->im) * width;
+    VipsPel *dst = (VipsPel *)buffer;
+    for (int y = 0; y < height; y++) {
+        memcpy(dst, src, row_bytes);
+        src += src_stride;
+        dst += stride;
+    }
+    return 0;
+}
+
+int cvips_region_read(VipsRegion *region, int left, int top, int width, int height, void *buffer, size_t stride) {
+    CVIPS_PROFILE_BEGIN(NULL, 0);
+    int result = cvips_region_read_run(region, left, top, width, height, buffer, stride);
+    size_t length = (size_t)VIPS_IMAGE_SIZEOF_PEL(region->im) * width * height;
+    CVIPS_PROFILE_END(CVIPS_PROFILE_READ, result, NULL, &length);
+    return result;
 }
 
 // =============================================================================
@@ -322,11 +2231,11 @@ int cvips_getpoint(VipsImage *in, double **vector, int *n, int x, int y) {
 // =============================================================================
 
 int cvips_tiffsave(VipsImage *in, const char *filename) {
-    return vips_tiffsave(in, filename, NULL);
+    CVIPS_PROFILED_SAVE(in, NULL, vips_tiffsave(in, filename, NULL));
 }
 
 int cvips_tiffsave_buffer(VipsImage *in, void **buf, size_t *len) {
-    return vips_tiffsave_buffer(in, buf, len, NULL);
+    CVIPS_PROFILED_SAVE(in, len, vips_tiffsave_buffer(in, buf, len, NULL));
 }
 
 // =============================================================================
@@ -334,26 +2243,389 @@ int cvips_tiffsave_buffer(VipsImage *in, void **buf, size_t *len) {
 // =============================================================================
 
 int cvips_jpegsave_buffer(VipsImage *in, void **buf, size_t *len, int quality) {
-    return vips_jpegsave_buffer(in, buf, len, "Q", quality, NULL);
+    CVIPS_PROFILED_SAVE(in, len, vips_jpegsave_buffer(in, buf, len, "Q", quality, NULL));
 }
 
 int cvips_pngsave_buffer(VipsImage *in, void **buf, size_t *len) {
-    return vips_pngsave_buffer(in, buf, len, NULL);
+    CVIPS_PROFILED_SAVE(in, len, vips_pngsave_buffer(in, buf, len, NULL));
 }
 
 int cvips_webpsave_buffer(VipsImage *in, void **buf, size_t *len, int quality) {
-    return vips_webpsave_buffer(in, buf, len, "Q", quality, NULL);
+    CVIPS_PROFILED_SAVE(in, len, vips_webpsave_buffer(in, buf, len, "Q", quality, NULL));
 }
 
 int cvips_webpsave_buffer_lossless(VipsImage *in, void **buf, size_t *len) {
-    return vips_webpsave_buffer(in, buf, len, "lossless", TRUE, NULL);
+    CVIPS_PROFILED_SAVE(in, len, vips_webpsave_buffer(in, buf, len, "lossless", TRUE, NULL));
 }
 
 int cvips_jxlsave_buffer(VipsImage *in, void **buf, size_t *len, int quality) {
-    return vips_jxlsave_buffer(in, buf, len, "Q", quality, NULL);
+    CVIPS_PROFILED_SAVE(in, len, vips_jxlsave_buffer(in, buf, len, "Q", quality, NULL));
 }
 
 int cvips_jxlsave_buffer_lossless(VipsImage *in, void **buf, size_t *len) {
-    return vips_jxlsave_buffer(in, buf, len, "lossless", TRUE, NULL);
+    CVIPS_PROFILED_SAVE(in, len, vips_jxlsave_buffer(in, buf, len, "lossless", TRUE, NULL));
+}
+
+
+// =============================================================================
+// Save to target
+// =============================================================================
+
+typedef struct {
+    CVIPSWriteCallback write;
+    void *context;
+} CVIPSTargetCallback;
+
+static gint64 cvips_target_write(VipsTargetCustom *target, const void *data, gint64 length, void *user) {
+    CVIPSTargetCallback *callback = (CVIPSTargetCallback *)user;
+    return callback->write(data, length, callback->context);
+}
+
+static void cvips_target_callback_free(gpointer data, GClosure *closure) {
+    g_free(data);
+}
+
+VipsTarget *cvips_target_new_to_callback(CVIPSWriteCallback write, void *context) {
+    VipsTargetCustom *target = vips_target_custom_new();
+    CVIPSTargetCallback *callback = g_new(CVIPSTargetCallback, 1);
+    callback->write = write;
+    callback->context = context;
+    g_signal_connect_data(target, "write", G_CALLBACK(cvips_target_write),
+                          callback, cvips_target_callback_free, 0);
+    return VIPS_TARGET(target);
+}
+
+int cvips_jpegsave_target(VipsImage *in, VipsTarget *target, int quality) {
+    CVIPS_PROFILED_SAVE(in, NULL, vips_jpegsave_target(in, target, "Q", quality, NULL));
+}
+
+int cvips_pngsave_target(VipsImage *in, VipsTarget *target) {
+    CVIPS_PROFILED_SAVE(in, NULL, vips_pngsave_target(in, target, NULL));
+}
+
+int cvips_webpsave_target(VipsImage *in, VipsTarget *target, int quality) {
+    CVIPS_PROFILED_SAVE(in, NULL, vips_webpsave_target(in, target, "Q", quality, NULL));
+}
+
+int cvips_webpsave_target_lossless(VipsImage *in, VipsTarget *target) {
+    CVIPS_PROFILED_SAVE(in, NULL, vips_webpsave_target(in, target, "lossless", TRUE, NULL));
 }
 
+int cvips_jxlsave_target(VipsImage *in, VipsTarget *target, int quality) {
+    CVIPS_PROFILED_SAVE(in, NULL, vips_jxlsave_target(in, target, "Q", quality, NULL));
+}
+
+int cvips_jxlsave_target_lossless(VipsImage *in, VipsTarget *target) {
+    CVIPS_PROFILED_SAVE(in, NULL, vips_jxlsave_target(in, target, "lossless", TRUE, NULL));
+}
+
+int cvips_tiffsave_target(VipsImage *in, VipsTarget *target) {
+    CVIPS_PROFILED_SAVE(in, NULL, vips_tiffsave_target(in, target, NULL));
+}
+
+// =============================================================================
+// Save with options
+// =============================================================================
+
+// Encode the options as a saver suffix, e.g. ".webp[Q=80,effort=6,keep=icc]",
+// which libvips parses for every destination. Free with g_free.
+static char *cvips_save_suffix(CVIPSSaveFormat format, const CVIPSSaveOptions *options) {
+    static const char *extensions[] = { ".jpg", ".png", ".webp", ".jxl", ".tif" };
+    GString *suffix = g_string_new(extensions[format]);
+    g_string_append_printf(suffix, "[Q=%d", options->quality);
+
+    switch (format) {
+    case CVIPS_SAVE_JPEG:
+        g_string_append_printf(suffix, ",optimize_coding=%s,interlace=%s",
+                               options->optimize_coding ? "true" : "false", options->interlace ? "true" : "false");
+        if (options->subsample >= 0) {
+            g_string_append_printf(suffix, ",subsample_mode=%s", options->subsample ? "on" : "off");
+        }
+        break;
+    case CVIPS_SAVE_PNG:
+        g_string_append_printf(suffix, ",interlace=%s,palette=%s",
+                               options->interlace ? "true" : "false", options->palette ? "true" : "false");
+        if (options->compression >= 0) {
+            g_string_append_printf(suffix, ",compression=%d", options->compression);
+        }
+        if (options->effort >= 0) {
+            g_string_append_printf(suffix, ",effort=%d", options->effort);
+        }
+        break;
+    case CVIPS_SAVE_WEBP:
+    case CVIPS_SAVE_JXL:
+        g_string_append_printf(suffix, ",lossless=%s", options->lossless ? "true" : "false");
+        if (options->effort >= 0) {
+            g_string_append_printf(suffix, ",effort=%d", options->effort);
+        }
+        break;
+    case CVIPS_SAVE_TIFF:
+        g_string_append_printf(suffix, ",compression=%s",
+                               vips_enum_nick(VIPS_TYPE_FOREIGN_TIFF_COMPRESSION, options->tiff_compression));
+        if (options->tile_size > 0) {
+            g_string_append_printf(suffix, ",tile=true,tile_width=%d,tile_height=%d",
+                                   options->tile_size, options->tile_size);
+        }
+        break;
+    }
+
+#if VIPS_MAJOR_VERSION > 8 || (VIPS_MAJOR_VERSION == 8 && VIPS_MINOR_VERSION >= 15)
+    static const char *keep[] = { "all", "icc", "none" };
+    g_string_append_printf(suffix, ",keep=%s]", keep[options->keep]);
+#else
+    // Before 8.15 metadata is all or nothing
+    g_string_append_printf(suffix, ",strip=%s]", options->keep == CVIPS_KEEP_NONE ? "true" : "false");
+#endif
+    return g_string_free(suffix, FALSE);
+}
+
+static int cvips_save_target_run(VipsImage *in, VipsTarget *target, CVIPSSaveFormat format,
+                                 const CVIPSSaveOptions *options) {
+    char *suffix = cvips_save_suffix(format, options);
+    int result = vips_image_write_to_target(in, suffix, target, NULL);
+    g_free(suffix);
+    return result;
+}
+
+static int cvips_save_file_run(VipsImage *in, const char *filename, CVIPSSaveFormat format,
+                               const CVIPSSaveOptions *options) {
+    // Through a target, so options never have to be parsed out of the filename
+    VipsTarget *target = vips_target_new_to_file(filename);
+    if (target == NULL) {
+        return -1;
+    }
+    int result = cvips_save_target_run(in, target, format, options);
+    g_object_unref(target);
+    return result;
+}
+
+static int cvips_save_buffer_run(VipsImage *in, void **buf, size_t *len, CVIPSSaveFormat format,
+                                 const CVIPSSaveOptions *options) {
+    char *suffix = cvips_save_suffix(format, options);
+    int result = vips_image_write_to_buffer(in, suffix, buf, len, NULL);
+    g_free(suffix);
+    return result;
+}
+
+int cvips_save_file(VipsImage *in, const char *filename, CVIPSSaveFormat format, const CVIPSSaveOptions *options) {
+    CVIPS_PROFILED_SAVE(in, NULL, cvips_save_file_run(in, filename, format, options));
+}
+
+int cvips_save_buffer(VipsImage *in, void **buf, size_t *len, CVIPSSaveFormat format,
+                      const CVIPSSaveOptions *options) {
+    CVIPS_PROFILED_SAVE(in, len, cvips_save_buffer_run(in, buf, len, format, options));
+}
+
+int cvips_save_target(VipsImage *in, VipsTarget *target, CVIPSSaveFormat format, const CVIPSSaveOptions *options) {
+    CVIPS_PROFILED_SAVE(in, NULL, cvips_save_target_run(in, target, format, options));
+}
+
+// =============================================================================
+// Concurrency
+// =============================================================================
+
+// The libvips worker count is process-wide. Saves that ask for more threads
+// raise it while they run; the configured value is restored when the last one
+// finishes. Setting the count while a save is running updates the value to
+// restore, so the raise never outlives the save or overwrites the caller.
+static GMutex cvips_concurrency_lock;
+static int cvips_concurrency_users = 0;
+static int cvips_concurrency_saved = 0;
+
+int cvips_concurrency_get(void) {
+    g_mutex_lock(&cvips_concurrency_lock);
+    int threads = cvips_concurrency_users > 0 ? cvips_concurrency_saved : vips_concurrency_get();
+    g_mutex_unlock(&cvips_concurrency_lock);
+    return threads;
+}
+
+void cvips_concurrency_set(int threads) {
+    g_mutex_lock(&cvips_concurrency_lock);
+    vips_concurrency_set(threads);
+    if (cvips_concurrency_users > 0) {
+        cvips_concurrency_saved = vips_concurrency_get();
+    }
+    g_mutex_unlock(&cvips_concurrency_lock);
+}
+
+// Returns whether the count was raised, and so must be restored.
+static gboolean cvips_concurrency_raise(int threads) {
+    if (threads <= 0) {
+        return FALSE;
+    }
+    g_mutex_lock(&cvips_concurrency_lock);
+    if (cvips_concurrency_users++ == 0) {
+        cvips_concurrency_saved = vips_concurrency_get();
+    }
+    if (threads > vips_concurrency_get()) {
+        vips_concurrency_set(threads);
+    }
+    g_mutex_unlock(&cvips_concurrency_lock);
+    return TRUE;
+}
+
+static void cvips_concurrency_restore(void) {
+    g_mutex_lock(&cvips_concurrency_lock);
+    if (--cvips_concurrency_users == 0) {
+        vips_concurrency_set(cvips_concurrency_saved);
+    }
+    g_mutex_unlock(&cvips_concurrency_lock);
+}
+
+// =============================================================================
+// Pyramids
+// =============================================================================
+
+static int cvips_dzsave_run(VipsImage *in, const char *basename, VipsForeignDzLayout layout, int tile_size,
+                            int overlap, const char *suffix, int threads) {
+    gboolean raised = cvips_concurrency_raise(threads);
+    int result = vips_dzsave(in, basename, "layout", layout, "tile_size", tile_size, "overlap", overlap,
+                             "suffix", suffix, NULL);
+    if (raised) {
+        cvips_concurrency_restore();
+    }
+    return result;
+}
+
+int cvips_dzsave(VipsImage *in, const char *basename, VipsForeignDzLayout layout, int tile_size, int overlap,
+                 const char *suffix, int threads) {
+    CVIPS_PROFILED_SAVE(in, NULL, cvips_dzsave_run(in, basename, layout, tile_size, overlap, suffix, threads));
+}
+
+// =============================================================================
+// Pipeline
+// =============================================================================
+
+// Scale and offset the colour bands, leaving any alpha band untouched.
+// 8-bit images stay 8-bit rather than being promoted to float.
+static int cvips_pipeline_linear(VipsImage *in, VipsImage **out, double a, double b) {
+    int bands = in->Bands;
+    int colour = vips_image_hasalpha(in) ? bands - 1 : bands;
+    double *av = g_new(double, bands * 2);
+    double *bv = av + bands;
+    for (int i = 0; i < bands; i++) {
+        av[i] = i < colour ? a : 1.0;
+        bv[i] = i < colour ? b : 0.0;
+    }
+    int result = vips_linear(in, out, av, bv, bands, "uchar", in->BandFmt == VIPS_FORMAT_UCHAR, NULL);
+    g_free(av);
+    return result;
+}
+
+static int cvips_pipeline_saturation(VipsImage *in, VipsImage **out, double saturation) {
+    VipsImage *lch;
+    if (vips_colourspace(in, &lch, VIPS_INTERPRETATION_LCH, NULL) != 0) {
+        return -1;
+    }
+
+    // Extra bands such as alpha are carried through the LCh conversion
+    int bands = lch->Bands;
+    double *av = g_new(double, bands * 2);
+    double *bv = av + bands;
+    for (int i = 0; i < bands; i++) {
+        av[i] = i == 1 ? saturation : 1.0;
+        bv[i] = 0.0;
+    }
+    VipsImage *scaled;
+    int result = vips_linear(lch, &scaled, av, bv, bands, NULL);
+    g_free(av);
+    g_object_unref(lch);
+    if (result != 0) {
+        return -1;
+    }
+
+    result = vips_colourspace(scaled, out, VIPS_INTERPRETATION_sRGB, NULL);
+    g_object_unref(scaled);
+    return result;
+}
+
+// Apply one step. Leaves *out NULL when the step would not change the image.
+static int cvips_pipeline_step(VipsImage *in, const CVIPSPipelineStep *step, VipsImage **out) {
+    const double *args = step->args;
+    int has_alpha = vips_image_hasalpha(in);
+    *out = NULL;
+
+    switch (step->kind) {
+    case CVIPS_STEP_CROP: {
+        int left = (int)args[0], top = (int)args[1], width = (int)args[2], height = (int)args[3];
+        if (left == 0 && top == 0 && width == in->Xsize && height == in->Ysize) {
+            return 0;
+        }
+        return vips_crop(in, out, left, top, width, height, NULL);
+    }
+    case CVIPS_STEP_RESIZE:
+        if (args[0] == 1.0 && args[1] == 1.0) {
+            return 0;
+        }
+        return vips_resize(in, out, args[0], "vscale", args[1], "kernel", (VipsKernel)args[2], NULL);
+    case CVIPS_STEP_THUMBNAIL: {
+        int width = (int)args[0], height = (int)args[1];
+        // Already fitted: one edge touches the box and the other lies inside it
+        if ((in->Xsize == width && in->Ysize <= height) || (in->Ysize == height && in->Xsize <= width)) {
+            return 0;
+        }
+        return vips_thumbnail_image(in, out, width, "height", height, NULL);
+    }
+    case CVIPS_STEP_LINEAR:
+        if (args[0] == 1.0 && args[1] == 0.0) {
+            return 0;
+        }
+        return cvips_pipeline_linear(in, out, args[0], args[1]);
+    case CVIPS_STEP_SATURATION:
+        // Chroma is meaningless without at least three colour bands
+        if (args[0] == 1.0 || in->Bands - has_alpha < 3) {
+            return 0;
+        }
+        return cvips_pipeline_saturation(in, out, args[0]);
+    case CVIPS_STEP_GAMMA:
+        if (args[0] == 1.0) {
+            return 0;
+        }
+        return vips_gamma(in, out, "exponent", args[0], NULL);
+    case CVIPS_STEP_SHARPEN:
+        return vips_sharpen(in, out, "sigma", args[0], NULL);
+    case CVIPS_STEP_FLATTEN: {
+        if (!has_alpha) {
+            return 0;
+        }
+        VipsArrayDouble *background = vips_array_double_newv(3, args[0], args[1], args[2]);
+        int result = vips_flatten(in, out, "background", background, NULL);
+        vips_area_unref(VIPS_AREA(background));
+        return result;
+    }
+    case CVIPS_STEP_COLOURSPACE: {
+        VipsInterpretation space = (VipsInterpretation)args[0];
+        if (vips_image_guess_interpretation(in) == space) {
+            return 0;
+        }
+        return vips_colourspace(in, out, space, NULL);
+    }
+    }
+
+    vips_error("cvips_pipeline_run", "unknown step kind %d", (int)step->kind);
+    return -1;
+}
+
+static int cvips_pipeline_build(VipsImage *in, const CVIPSPipelineStep *steps, int count, VipsImage **out) {
+    // Each step's output holds a reference to its input, so only the
+    // newest image needs to be owned here as the graph is built.
+    VipsImage *current = in;
+    g_object_ref(current);
+    for (int i = 0; i < count; i++) {
+        VipsImage *next;
+        if (cvips_pipeline_step(current, &steps[i], &next) != 0) {
+            g_object_unref(current);
+            return -1;
+        }
+        if (next != NULL) {
+            g_object_unref(current);
+            current = next;
+        }
+    }
+    *out = current;
+    return 0;
+}
+
+int cvips_pipeline_run(VipsImage *in, const CVIPSPipelineStep *steps, int count, VipsImage **out) {
+    CVIPS_PROFILED_BUILD(in, out, cvips_pipeline_build(in, steps, count, out));
+}
@@ -4,7 +4,8 @@
 //
 //  Non-variadic C wrappers for libvips functions.
 //  Swift cannot call variadic C functions, so this thin shim provides
-//  non-variadic equivalents that Swift calls instead.
+//  non-variadic equivalents that Swift calls instead. Every wrapper can
+//  also record a timing event for VIPSProfiler.
 //
 
 #ifndef CVIPS_H
@@ -12,6 +13,45 @@
 
 #include <vips/vips.h>
 
+// =============================================================================
+// Profiling
+// =============================================================================
+
+typedef enum {
+    CVIPS_PROFILE_LOAD,     // decode or header read
+    CVIPS_PROFILE_BUILD,    // lazy graph construction, no pixels computed
+    CVIPS_PROFILE_COMPUTE,  // eager pixel evaluation (statistics, trim, histograms)
+    CVIPS_PROFILE_SAVE,     // encode to a file, buffer or target
+    CVIPS_PROFILE_DRAW,     // in-place drawing
+    CVIPS_PROFILE_READ      // region reads into caller memory
+} CVIPSProfileKind;
+
+typedef enum {
+    CVIPS_CACHE_NONE,
+    CVIPS_CACHE_HIT,
+    CVIPS_CACHE_MISS
+} CVIPSProfileCache;
+
+typedef struct {
+    const char *name;       // wrapper function name, static storage
+    CVIPSProfileKind kind;
+    int thread;             // small per-thread id, starting at 1
+    gint64 start;           // CLOCK_MONOTONIC nanoseconds
+    gint64 duration;        // nanoseconds
+    guint64 pixels_in;
+    guint64 pixels_out;
+    guint64 bytes_in;
+    guint64 bytes_out;
+    CVIPSProfileCache cache;
+    int failed;
+} CVIPSProfileEvent;
+
+void cvips_profile_set_enabled(int enabled);
+int cvips_profile_is_enabled(void);
+// Copy of the recorded events; free with g_free. NULL when there are none.
+CVIPSProfileEvent *cvips_profile_copy_events(int *count, guint64 *dropped);
+void cvips_profile_reset(void);
+
 // =============================================================================
 // Loading
 // =============================================================================
@@ -24,6 +64,60 @@ int cvips_thumbnail(const char *filename, VipsImage **out, int width, int height
 int cvips_thumbnail_buffer(const void *data, size_t length, VipsImage **out, int width, int height);
 int cvips_thumbnail_image(VipsImage *in, VipsImage **out, int width, int height);
 
+// Fit to a width only, never upscaling.
+int cvips_thumbnail_width(const char *filename, VipsImage **out, int width);
+int cvips_thumbnail_buffer_width(const void *data, size_t length, VipsImage **out, int width);
+int cvips_thumbnail_image_width(VipsImage *in, VipsImage **out, int width);
+
+// =============================================================================
+// Load from source
+// =============================================================================
+
+// Fills up to `length` bytes of `buffer`. Returns the number of bytes read,
+// 0 at end of stream, or -1 on error.
+typedef gint64 (*CVIPSReadCallback)(void *buffer, gint64 length, void *context);
+// Called once when the source no longer needs `context`.
+typedef void (*CVIPSReleaseCallback)(void *context);
+
+VipsSource *cvips_source_new_from_callback(CVIPSReadCallback read, CVIPSReleaseCallback release, void *context);
+VipsImage *cvips_image_new_from_source(VipsSource *source);
+VipsImage *cvips_image_new_from_source_sequential(VipsSource *source);
+int cvips_thumbnail_source(VipsSource *source, VipsImage **out, int width, int height);
+
+// =============================================================================
+// Page ranges
+// =============================================================================
+
+// Load or thumbnail `n` pages starting at `page` (n = -1 for all remaining
+// pages). Single-page formats ignore `n` and only accept page 0.
+VipsImage *cvips_image_new_from_file_pages(const char *filename, int page, int n);
+VipsImage *cvips_image_new_from_buffer_pages(const void *data, size_t length, int page, int n);
+int cvips_thumbnail_pages(const char *filename, VipsImage **out, int width, int height, int page, int n);
+int cvips_thumbnail_buffer_pages(const void *data, size_t length, VipsImage **out, int width, int height,
+                                 int page, int n);
+// Stacks equally sized pages vertically and sets page-height, n-pages and
+// per-page delays so the result saves as a multi-page or animated image.
+int cvips_join_pages(VipsImage **pages, int n, VipsImage **out);
+// Crops page `index` out of a multi-page image, keeping that page's frame delay.
+int cvips_extract_page(VipsImage *in, int index, VipsImage **out);
+
+// =============================================================================
+// Header probing
+// =============================================================================
+
+typedef struct {
+    int width;
+    int height;
+    int bands;
+    int pages;
+    int orientation;        // 0 when the image has no orientation tag
+    char loader[64];        // Loader nickname, e.g. "jpegload"
+    char compression[16];   // HEIF compression, e.g. "av1", or empty
+} CVIPSImageProbe;
+
+int cvips_probe_file(const char *filename, CVIPSImageProbe *probe);
+int cvips_probe_buffer(const void *data, size_t length, CVIPSImageProbe *probe);
+
 // =============================================================================
 // Resize
 // =============================================================================
@@ -53,6 +147,17 @@ int cvips_invert(VipsImage *in, VipsImage **out);
 int cvips_linear(VipsImage *in, VipsImage **out, const double *a, const double *b, int n);
 int cvips_gamma(VipsImage *in, VipsImage **out, double exponent);
 int cvips_cast_uchar(VipsImage *in, VipsImage **out);
+int cvips_cast(VipsImage *in, VipsImage **out, VipsBandFormat format);
+
+// =============================================================================
+// Tone adjustment
+// =============================================================================
+
+// Brightness, contrast and gamma folded into one 256-entry curve, then an optional
+// fixed-point saturation matrix, in a single uchar-to-uchar pass. Alpha is copied
+// unchanged. Fails unless `in` is uncoded 8-bit.
+int cvips_tone_adjust(VipsImage *in, VipsImage **out, double brightness, double contrast,
+                      double gamma, double saturation);
 
 // =============================================================================
 // Filter
@@ -84,6 +189,71 @@ int cvips_subtract(VipsImage *in, VipsImage *other, VipsImage **out);
 int cvips_abs(VipsImage *in, VipsImage **out);
 int cvips_join(VipsImage *in1, VipsImage *in2, VipsImage **out, VipsDirection direction);
 
+// Columns copied per row by cvips_stats_summary: min, max, sum, sum2, mean, sigma.
+// Row 0 covers all bands; row n covers band n - 1.
+#define CVIPS_STATS_COLUMNS 6
+
+int cvips_stats_summary(VipsImage *in, double *out, int rows);
+
+// =============================================================================
+// Edge color histogram
+// =============================================================================
+
+// Colors are quantized to 8 levels per channel on up to 3 bands (8 x 8 x 8 buckets).
+#define CVIPS_EDGE_BUCKETS 512
+
+int cvips_edge_histogram(VipsImage *in, int strip_width, int threads, guint64 *counts, double *sums);
+
+// =============================================================================
+// Perceptual hashing
+// =============================================================================
+
+typedef enum {
+    CVIPS_HASH_AVERAGE,     // 8 x 8 luminance grid against its mean
+    CVIPS_HASH_DIFFERENCE,  // 9 x 8 grid, horizontal gradient signs
+    CVIPS_HASH_PERCEPTUAL   // low 8 x 8 frequencies of a 32 x 32 DCT against their median
+} CVIPSHashKind;
+
+// Hashes are most stable when `in` is already a small thumbnail.
+int cvips_perceptual_hash(VipsImage *in, CVIPSHashKind kind, guint64 *out);
+void cvips_hamming_distances(guint64 query, const guint64 *hashes, size_t count, guint8 *out);
+// Writes the indices of hashes within `max_distance` of `query`; returns how many.
+size_t cvips_hamming_within(guint64 query, const guint64 *hashes, size_t count, int max_distance,
+                            size_t *indices);
+
+// =============================================================================
+// Image diff
+// =============================================================================
+
+// Compares `a` and `b` tile by tile, marking a tile changed when any sample
+// differs by more than `tolerance`. Stops once more than `max_changed` tiles
+// have changed (-1 to compare everything) and sets `exceeded`. Up to `capacity`
+// changed tiles are written to `boxes` as left, top, width, height, in no
+// particular order.
+int cvips_diff_tiles(VipsImage *a, VipsImage *b, int tile_size, double tolerance, int max_changed, int threads,
+                     int *boxes, int capacity, int *n_boxes, int *exceeded);
+
+// =============================================================================
+// Analysis previews
+// =============================================================================
+
+// Shrink-on-load to fit within size x size, never upscaling. Unlike the
+// thumbnail functions, EXIF orientation is not applied, so preview coordinates
+// map straight back onto the unrotated source.
+int cvips_preview(const char *filename, VipsImage **out, int size);
+int cvips_preview_buffer(const void *data, size_t length, VipsImage **out, int size);
+int cvips_preview_image(VipsImage *in, VipsImage **out, int size);
+
+// The window vips_smartcrop would extract, without extracting it.
+int cvips_smartcrop_rect(VipsImage *in, int width, int height, VipsInteresting interesting, int *left, int *top);
+
+// =============================================================================
+// Evaluation counting (diagnostics)
+// =============================================================================
+
+gulong cvips_image_count_evaluations(VipsImage *in, int *counter);
+void cvips_image_stop_counting(VipsImage *in, gulong handler);
+
 // =============================================================================
 // Save to file
 // =============================================================================
@@ -145,12 +315,71 @@ int cvips_draw_line(VipsImage *image, double *ink, int n, int x1, int y1, int x2
 int cvips_draw_circle(VipsImage *image, double *ink, int n, int cx, int cy, int radius, int fill);
 int cvips_draw_flood(VipsImage *image, double *ink, int n, int x, int y);
 
+// =============================================================================
+// Draw lists
+// =============================================================================
+
+typedef enum {
+    CVIPS_DRAW_RECT,        // args: left, top, width, height
+    CVIPS_DRAW_LINE,        // args: x1, y1, x2, y2
+    CVIPS_DRAW_CIRCLE,      // args: cx, cy, radius
+    CVIPS_DRAW_POLYLINE,    // vertices in points
+    CVIPS_DRAW_POLYGON      // vertices in points, implicitly closed
+} CVIPSDrawKind;
+
+typedef struct {
+    CVIPSDrawKind kind;
+    int fill;
+    int ink;                // index into the ink palette
+    int first_point;        // offset of the first vertex in points, in vertices
+    int n_points;
+    double args[4];
+} CVIPSDrawCommand;
+
+// Draws every command in order. `points` holds x, y pairs; `inks` holds one
+// entry of image->Bands values per palette index. Supports uchar, ushort and
+// float images.
+int cvips_draw_list(VipsImage *image, const CVIPSDrawCommand *commands, int count,
+                    const double *points, const double *inks, int antialias, int threads);
+
 // =============================================================================
 // Pixel reading
 // =============================================================================
 
 int cvips_getpoint(VipsImage *in, double **vector, int *n, int x, int y);
 
+// =============================================================================
+// Direct memory access
+// =============================================================================
+
+const void *cvips_image_peek_memory(VipsImage *in);
+
+// =============================================================================
+// Raw memory import / export
+// =============================================================================
+
+// Wrap caller memory whose rows are `stride` bytes apart without copying it.
+// `release` is called with `context` once libvips has closed every image that
+// reads the memory, including outputs of operations still in the operation
+// cache (or immediately, if the rows had to be packed into a copy or the call
+// fails), and may run on any thread.
+VipsImage *cvips_image_new_from_memory_owned(const void *data, size_t stride, int width, int height, int bands,
+                                             VipsBandFormat format, VipsInterpretation interpretation,
+                                             CVIPSReleaseCallback release, void *context);
+// Convert half-float samples into a new float image. `data` is not retained.
+VipsImage *cvips_image_new_from_half(const void *data, size_t stride, int width, int height, int bands,
+                                     VipsInterpretation interpretation);
+// Render `in` into caller memory whose rows are `stride` bytes apart. When
+// `half` is set, `in` must be float and is written as half-float samples.
+int cvips_image_write_to_memory_strided(VipsImage *in, void *buffer, size_t stride, int half);
+
+// =============================================================================
+// Region reading
+// =============================================================================
+
+int cvips_region_prepare_area(VipsRegion *region, int left, int top, int width, int height, VipsPel **data, size_t *stride);
+int cvips_region_read(VipsRegion *region, int left, int top, int width, int height, void *buffer, size_t stride);
+
 // =============================================================================
 // TIFF I/O
 // =============================================================================
@@ -169,4 +398,105 @@ int cvips_webpsave_buffer_lossless(VipsImage *in, void **buf, size_t *len);
 int cvips_jxlsave_buffer(VipsImage *in, void **buf, size_t *len, int quality);
 int cvips_jxlsave_buffer_lossless(VipsImage *in, void **buf, size_t *len);
 
+// =============================================================================
+// Save to target
+// =============================================================================
+
+// Receives each chunk of encoded output. Returns the number of bytes consumed,
+// or -1 to abort the save.
+typedef gint64 (*CVIPSWriteCallback)(const void *data, gint64 length, void *context);
+
+VipsTarget *cvips_target_new_to_callback(CVIPSWriteCallback write, void *context);
+int cvips_jpegsave_target(VipsImage *in, VipsTarget *target, int quality);
+int cvips_pngsave_target(VipsImage *in, VipsTarget *target);
+int cvips_webpsave_target(VipsImage *in, VipsTarget *target, int quality);
+int cvips_webpsave_target_lossless(VipsImage *in, VipsTarget *target);
+int cvips_jxlsave_target(VipsImage *in, VipsTarget *target, int quality);
+int cvips_jxlsave_target_lossless(VipsImage *in, VipsTarget *target);
+int cvips_tiffsave_target(VipsImage *in, VipsTarget *target);
+
+// =============================================================================
+// Save with options
+// =============================================================================
+
+typedef enum {
+    CVIPS_SAVE_JPEG,
+    CVIPS_SAVE_PNG,
+    CVIPS_SAVE_WEBP,
+    CVIPS_SAVE_JXL,
+    CVIPS_SAVE_TIFF
+} CVIPSSaveFormat;
+
+typedef enum {
+    CVIPS_KEEP_ALL,         // every metadata item
+    CVIPS_KEEP_ICC,         // only the ICC profile
+    CVIPS_KEEP_NONE
+} CVIPSKeep;
+
+// Fields that do not apply to the chosen format are ignored.
+typedef struct {
+    int quality;                                // 1-100
+    int lossless;                               // WebP, JPEG XL
+    int effort;                                 // -1 for the default; WebP 0-6, JPEG XL 1-9, PNG palette 1-10
+    CVIPSKeep keep;
+    int interlace;                              // progressive JPEG, interlaced PNG
+    int optimize_coding;                        // JPEG
+    int subsample;                              // JPEG chroma: -1 automatic, 0 off (4:4:4), 1 on (4:2:0)
+    int compression;                            // PNG zlib level 0-9, -1 for the default
+    int palette;                                // PNG
+    VipsForeignTiffCompression tiff_compression;
+    int tile_size;                              // TIFF tiles; 0 for strips
+} CVIPSSaveOptions;
+
+int cvips_save_file(VipsImage *in, const char *filename, CVIPSSaveFormat format, const CVIPSSaveOptions *options);
+int cvips_save_buffer(VipsImage *in, void **buf, size_t *len, CVIPSSaveFormat format,
+                      const CVIPSSaveOptions *options);
+int cvips_save_target(VipsImage *in, VipsTarget *target, CVIPSSaveFormat format, const CVIPSSaveOptions *options);
+
+// =============================================================================
+// Concurrency
+// =============================================================================
+
+// The configured libvips worker count, excluding any temporary raise by a
+// running save. Setting it while a save runs also changes the value restored
+// when the save finishes.
+int cvips_concurrency_get(void);
+void cvips_concurrency_set(int threads);
+
+// =============================================================================
+// Pyramids
+// =============================================================================
+
+// `suffix` selects the tile format and its save options, e.g. ".jpg[Q=85]".
+// Tiles are encoded on the libvips threadpool. A positive `threads` raises its
+// process-wide size to at least that for the duration of the save; 0 leaves it
+// unchanged.
+int cvips_dzsave(VipsImage *in, const char *basename, VipsForeignDzLayout layout, int tile_size, int overlap,
+                 const char *suffix, int threads);
+
+// =============================================================================
+// Pipeline
+// =============================================================================
+
+// Steps understood by cvips_pipeline_run. Arguments are packed into
+// CVIPSPipelineStep.args in the order listed.
+typedef enum {
+    CVIPS_STEP_CROP,         // left, top, width, height
+    CVIPS_STEP_RESIZE,       // hscale, vscale, VipsKernel
+    CVIPS_STEP_THUMBNAIL,    // width, height
+    CVIPS_STEP_LINEAR,       // a, b (applied to colour bands; alpha passes through)
+    CVIPS_STEP_SATURATION,   // chroma multiplier
+    CVIPS_STEP_GAMMA,        // exponent
+    CVIPS_STEP_SHARPEN,      // sigma
+    CVIPS_STEP_FLATTEN,      // r, g, b
+    CVIPS_STEP_COLOURSPACE,  // VipsInterpretation
+} CVIPSStepKind;
+
+typedef struct {
+    CVIPSStepKind kind;
+    double args[4];
+} CVIPSPipelineStep;
+
+int cvips_pipeline_run(VipsImage *in, const CVIPSPipelineStep *steps, int count, VipsImage **out);
+
 #endif /* CVIPS_H */
@@ -0,0 +1,268 @@
+import Foundation
+internal import vips
+internal import CVIPS
+
+/// Generates encoded thumbnails for many images on a fixed pool of worker threads.
+///
+/// The async APIs on ``VIPSImage`` each spawn their own detached task, so submitting
+/// thousands of them at once either oversubscribes memory or, because libvips itself
+/// runs with a single thread, leaves cores idle. A batch processor instead runs a fixed
+/// number of workers (one per core by default), each processing one image at a time,
+/// and pauses new work while libvips' tracked memory is above an optional budget.
+///
+/// Results are streamed back in completion order, followed by a ``Report`` describing
+/// the throughput and peak memory of the batch.
+///
+/// ```swift
+/// let processor = VIPSBatchProcessor(memoryBudget: 512 * 1024 * 1024)
+/// let spec = VIPSBatchProcessor.Specification(width: 256, height: 256, format: .webP, quality: 80)
+/// for await event in processor.process(paths.map { .file($0) }, specification: spec) {
+///     switch event {
+///     case .completed(let output): handle(output)
+///     case .finished(let report):  print(report.itemsPerSecond)
+///     }
+/// }
+/// ```
+public final class VIPSBatchProcessor: Sendable {
+
+    /// An image to process.
+    public enum Source: Sendable {
+        /// An image file on disk
+        case file(String)
+        /// Encoded image data in memory
+        case data(Data)
+    }
+
+    /// The thumbnail size and output encoding applied to every image in a batch.
+    public struct Specification: Sendable {
+        /// The maximum width of each thumbnail
+        public var width: Int
+        /// The maximum height of each thumbnail
+        public var height: Int
+        /// The format to encode each thumbnail as
+        public var format: VIPSImageFormat
+        /// The encoding quality (1-100). Ignored for PNG and TIFF.
+        public var quality: Int
+        /// Whether to encode losslessly. Only meaningful for WebP and JPEG-XL.
+        public var lossless: Bool
+
+        /// Create a batch specification.
+        /// - Parameters:
+        ///   - width: The maximum width of each thumbnail
+        ///   - height: The maximum height of each thumbnail
+        ///   - format: The format to encode each thumbnail as (default is JPEG)
+        ///   - quality: The encoding quality (1-100, default is 85)
+        ///   - lossless: Whether to encode losslessly (default is false)
+        public init(width: Int, height: Int, format: VIPSImageFormat = .jpeg,
+                    quality: Int = 85, lossless: Bool = false) {
+            self.width = width
+            self.height = height
+            self.format = format
+            self.quality = quality
+            self.lossless = lossless
+        }
+    }
+
+    /// The result of processing a single source.
+    public struct Output: Sendable {
+        /// The position of the source in the submitted array
+        public let index: Int
+        /// The encoded thumbnail, or the error that prevented it from being produced
+        public let result: Result<Data, VIPSError>
+        /// The wall-clock time spent processing this source, in seconds
+        public let duration: TimeInterval
+    }
+
+    /// Throughput and memory measurements for a completed batch.
+    public struct Report: Sendable {
+        /// The number of sources that were processed
+        public let itemCount: Int
+        /// The number of sources that failed to process
+        public let failureCount: Int
+        /// The wall-clock duration of the batch, in seconds
+        public let duration: TimeInterval
+        /// The highest libvips tracked memory usage observed during the batch, in bytes
+        public let peakMemory: Int
+
+        /// The number of sources processed per second.
+        public var itemsPerSecond: Double {
+            duration > 0 ? Double(itemCount) / duration : 0
+        }
+    }
+
+    /// An event emitted while a batch is running.
+    public enum Event: Sendable {
+        /// A source finished processing
+        case completed(Output)
+        /// Every source has been processed; this is always the final event
+        case finished(Report)
+    }
+
+    /// The number of worker threads used to process a batch.
+    public let maxConcurrency: Int
+
+    /// The libvips tracked memory level, in bytes, above which workers wait for
+    /// in-flight images to finish before starting new ones. `nil` disables back-pressure.
+    public let memoryBudget: Int?
+
+    /// Create a batch processor.
+    /// - Parameters:
+    ///   - maxConcurrency: The number of worker threads (default is the number of active processor cores)
+    ///   - memoryBudget: The libvips tracked memory level in bytes above which new work is
+    ///     deferred, or `nil` for no limit (default)
+    public init(maxConcurrency: Int = ProcessInfo.processInfo.activeProcessorCount, memoryBudget: Int? = nil) {
+        self.maxConcurrency = max(1, maxConcurrency)
+        self.memoryBudget = memoryBudget
+    }
+
+    /// Thumbnail and encode every source, streaming results back as they complete.
+    ///
+    /// Terminating the stream early (for example by breaking out of the loop)
+    /// stops workers from starting any further sources.
+    /// - Parameters:
+    ///   - sources: The images to process
+    ///   - specification: The thumbnail size and encoding to apply
+    /// - Returns: A stream of ``Event`` values ending with ``Event/finished(_:)``
+    public func process(_ sources: [Source], specification: Specification) -> AsyncStream<Event> {
+        AsyncStream { continuation in
+            let run = BatchRun(sources: sources, specification: specification,
+                               memoryBudget: memoryBudget, continuation: continuation)
+            continuation.onTermination = { _ in run.cancel() }
+            run.start(workers: min(maxConcurrency, max(1, sources.count)))
+        }
+    }
+}
+
+// MARK: - Batch Execution
+
+/// Shared state for one running batch. All mutable state is guarded by `condition`.
+private final class BatchRun: @unchecked Sendable {
+    private let sources: [VIPSBatchProcessor.Source]
+    private let specification: VIPSBatchProcessor.Specification
+    private let memoryBudget: Int?
+    private let continuation: AsyncStream<VIPSBatchProcessor.Event>.Continuation
+    private let condition = NSCondition()
+    private let startTime = DispatchTime.now()
+    private let startHighWater = Int(vips_tracked_get_mem_highwater())
+
+    private var nextIndex = 0
+    private var inFlight = 0
+    private var activeWorkers = 0
+    private var completed = 0
+    private var failures = 0
+    private var peakMemory = Int(vips_tracked_get_mem())
+    private var cancelled = false
+
+    init(sources: [VIPSBatchProcessor.Source], specification: VIPSBatchProcessor.Specification,
+         memoryBudget: Int?, continuation: AsyncStream<VIPSBatchProcessor.Event>.Continuation) {
+        self.sources = sources
+        self.specification = specification
+        self.memoryBudget = memoryBudget
+        self.continuation = continuation
+    }
+
+    func start(workers: Int) {
+        activeWorkers = workers
+        for i in 0..<workers {
+            let thread = Thread { [self] in work() }
+            thread.name = "VIPSBatchProcessor.\(i)"
+            // Give codecs generous stack space on secondary threads
+            thread.stackSize = 8 * 1024 * 1024
+            thread.start()
+        }
+    }
+
+    func cancel() {
+        condition.lock()
+        cancelled = true
+        condition.broadcast()
+        condition.unlock()
+    }
+
+    private func work() {
+        while let index = claimNext() {
+            let started = DispatchTime.now()
+            let result: Result<Data, VIPSError>
+            do {
+                result = .success(try render(sources[index]))
+            } catch {
+                result = .failure(error as? VIPSError ?? VIPSError("\(error)"))
+            }
+            let output = VIPSBatchProcessor.Output(index: index, result: result,
+                                                   duration: seconds(since: started))
+            complete(output)
+        }
+        workerExited()
+    }
+
+    /// Claim the next source, waiting while memory is over budget and other
+    /// images are still in flight. Returns `nil` when no work remains.
+    private func claimNext() -> Int? {
+        condition.lock()
+        defer { condition.unlock() }
+        while true {
+            guard !cancelled, nextIndex < sources.count else { return nil }
+            if let memoryBudget, inFlight > 0, Int(vips_tracked_get_mem()) > memoryBudget {
+                condition.wait()
+                continue
+            }
+            let index = nextIndex
+            nextIndex += 1
+            inFlight += 1
+            return index
+        }
+    }
+
+    private func render(_ source: VIPSBatchProcessor.Source) throws -> Data {
+        let spec = specification
+        let thumbnail: VIPSImage
+        switch source {
+        case .file(let path):
+            thumbnail = try VIPSImage.thumbnail(fromFile: path, width: spec.width, height: spec.height)
+        case .data(let data):
+            thumbnail = try VIPSImage.thumbnail(fromData: data, width: spec.width, height: spec.height)
+        }
+        let encoded = try thumbnail.data(format: spec.format, quality: spec.quality, lossless: spec.lossless)
+
+        // Sample while this image's buffers are still alive
+        recordMemory()
+        return encoded
+    }
+
+    private func recordMemory() {
+        let current = Int(vips_tracked_get_mem())
+        condition.lock()
+        peakMemory = max(peakMemory, current)
+        condition.unlock()
+    }
+
+    private func complete(_ output: VIPSBatchProcessor.Output) {
+        condition.lock()
+        inFlight -= 1
+        completed += 1
+        if case .failure = output.result { failures += 1 }
+        condition.broadcast()
+        condition.unlock()
+        continuation.yield(.completed(output))
+    }
+
+    private func workerExited() {
+        condition.lock()
+        activeWorkers -= 1
+        let isLast = activeWorkers == 0
+        condition.unlock()
+        guard isLast else { return }
+
+        // The libvips high-water mark only rises, so any increase happened during this batch
+        let highWater = Int(vips_tracked_get_mem_highwater())
+        let peak = highWater > startHighWater ? max(peakMemory, highWater) : peakMemory
+        let report = VIPSBatchProcessor.Report(itemCount: completed, failureCount: failures,
+                                               duration: seconds(since: startTime), peakMemory: peak)
+        continuation.yield(.finished(report))
+        continuation.finish()
+    }
+
+    private func seconds(since start: DispatchTime) -> TimeInterval {
+        Double(DispatchTime.now().uptimeNanoseconds - start.uptimeNanoseconds) / 1_000_000_000
+    }
+}
@@ -0,0 +1,213 @@
+internal import vips
+internal import CVIPS
+
+/// Encoder settings for saving and exporting images, trading encode time
+/// against output size and controlling which metadata is written.
+///
+/// Settings shared by every format live at the top level; the rest are grouped
+/// by format and ignored when saving in another format. Start from a preset and
+/// adjust as needed:
+///
+/// ```swift
+/// var options = VIPSEncodeOptions.smallest
+/// options.quality = 75
+/// let data = try image.data(format: .webP, options: options)
+/// ```
+public struct VIPSEncodeOptions: Sendable, Equatable {
+
+    /// Which metadata is written to the output.
+    public enum Metadata: Int, Sendable {
+        /// Write everything the image carries, including EXIF, XMP, IPTC, and ICC data
+        case all = 0
+        /// Write only the ICC color profile, so colors still render correctly.
+        /// With libvips older than 8.15, this writes everything.
+        case colorProfile
+        /// Write no metadata
+        case none
+    }
+
+    /// JPEG chroma subsampling.
+    public enum ChromaSubsampling: Int, Sendable {
+        /// Subsample (4:2:0) below quality 90, otherwise keep full color resolution
+        case automatic = -1
+        /// Keep full color resolution (4:4:4)
+        case off = 0
+        /// Halve color resolution in both directions (4:2:0)
+        case on = 1
+    }
+
+    /// TIFF compression schemes.
+    public enum TIFFCompression: Int, Sendable {
+        /// Uncompressed
+        case none = 0
+        /// Lossy JPEG compression, using ``VIPSEncodeOptions/quality``
+        case jpeg
+        /// Lossless deflate (zip) compression
+        case deflate
+        /// Lossless LZW compression
+        case lzw = 5
+        /// Lossy WebP compression, using ``VIPSEncodeOptions/quality``
+        case webP = 6
+        /// Lossless Zstandard compression
+        case zstd = 7
+
+        /// The corresponding libvips `VipsForeignTiffCompression` value.
+        internal var vipsValue: VipsForeignTiffCompression {
+            VipsForeignTiffCompression(rawValue: UInt32(rawValue))
+        }
+    }
+
+    /// JPEG settings.
+    public struct JPEG: Sendable, Equatable {
+        /// Compute optimal Huffman tables, for slightly smaller files at some extra
+        /// encode time (default is false)
+        public var optimizeCoding = false
+        /// Write a progressive JPEG, which is usually smaller but slower to encode
+        /// and decode (default is false)
+        public var progressive = false
+        /// Chroma subsampling (default is automatic)
+        public var chromaSubsampling = ChromaSubsampling.automatic
+
+        public init() {}
+    }
+
+    /// PNG settings.
+    public struct PNG: Sendable, Equatable {
+        /// The zlib compression level, from 0 (fastest) to 9 (smallest). PNG is always
+        /// lossless, so this only trades time against size. (Default is 6)
+        public var compression = 6
+        /// Write an interlaced (Adam7) PNG (default is false)
+        public var interlaced = false
+        /// Quantize to an 8-bit palette, which is lossy but much smaller, using
+        /// ``VIPSEncodeOptions/quality`` (default is false)
+        public var palette = false
+        /// Palette quantization effort, from 1 (fastest) to 10 (best) (default is 7)
+        public var effort = 7
+
+        public init() {}
+    }
+
+    /// WebP settings.
+    public struct WebP: Sendable, Equatable {
+        /// Encoder effort, from 0 (fastest) to 6 (smallest) (default is 4)
+        public var effort = 4
+
+        public init() {}
+    }
+
+    /// JPEG XL settings.
+    public struct JXL: Sendable, Equatable {
+        /// Encoder effort, from 1 (fastest) to 9 (smallest) (default is 7)
+        public var effort = 7
+
+        public init() {}
+    }
+
+    /// TIFF settings.
+    public struct TIFF: Sendable, Equatable {
+        /// The compression scheme (default is none)
+        public var compression = TIFFCompression.none
+        /// Write square tiles of this size instead of strips, which allows random
+        /// access into large images. Must be a multiple of 16. (Default is `nil`, strips)
+        public var tileSize: Int? = nil
+
+        public init() {}
+    }
+
+    /// The encoding quality (1-100). Used by lossy JPEG, WebP, and JPEG XL encodes,
+    /// PNG palettes, and lossy TIFF compression. (Default is 85)
+    public var quality = 85
+    /// Encode WebP and JPEG XL losslessly (default is false)
+    public var lossless = false
+    /// Which metadata to write (default is all)
+    public var metadata = Metadata.all
+    /// JPEG settings
+    public var jpeg = JPEG()
+    /// PNG settings
+    public var png = PNG()
+    /// WebP settings
+    public var webP = WebP()
+    /// JPEG XL settings
+    public var jxl = JXL()
+    /// TIFF settings
+    public var tiff = TIFF()
+
+    /// Create options matching the `quality`/`lossless` save methods' defaults:
+    /// quality 85 (rather than libvips' 75), lossy, and the libvips defaults for
+    /// every format-specific setting.
+    public init() {}
+
+    // MARK: - Presets
+    //
+    // Presets only change effort and metadata, never quality, so they produce
+    // the same visual result at different speeds and sizes. All three keep the
+    // ICC profile and drop other metadata, which is what most derived images want.
+
+    /// The lowest encode time: minimum effort, no extra entropy-coding passes,
+    /// light PNG compression, and uncompressed TIFF.
+    public static let fastest: VIPSEncodeOptions = {
+        var options = VIPSEncodeOptions()
+        options.metadata = .colorProfile
+        options.png.compression = 1
+        options.webP.effort = 0
+        options.jxl.effort = 1
+        return options
+    }()
+
+    /// A middle ground: optimized JPEG coding, default PNG and WebP effort, reduced
+    /// JPEG XL effort, and LZW-compressed TIFF.
+    public static let balanced: VIPSEncodeOptions = {
+        var options = VIPSEncodeOptions()
+        options.metadata = .colorProfile
+        options.jpeg.optimizeCoding = true
+        options.jxl.effort = 5
+        options.tiff.compression = .lzw
+        return options
+    }()
+
+    /// The smallest output: progressive optimized JPEG, maximum PNG compression,
+    /// maximum WebP and JPEG XL effort, and deflate-compressed TIFF. Encoding can be
+    /// several times slower than ``fastest``.
+    public static let smallest: VIPSEncodeOptions = {
+        var options = VIPSEncodeOptions()
+        options.metadata = .colorProfile
+        options.jpeg.optimizeCoding = true
+        options.jpeg.progressive = true
+        options.png.compression = 9
+        options.webP.effort = 6
+        options.jxl.effort = 9
+        options.tiff.compression = .deflate
+        return options
+    }()
+
+    /// The options in the form the C shim expects, with effort and interlacing
+    /// taken from the settings for `format`.
+    internal func cValue(for format: CVIPSSaveFormat) -> CVIPSSaveOptions {
+        var options = CVIPSSaveOptions()
+        options.quality = Int32(max(1, min(100, quality)))
+        options.lossless = lossless ? 1 : 0
+        options.keep = CVIPSKeep(rawValue: UInt32(metadata.rawValue))
+        options.optimize_coding = jpeg.optimizeCoding ? 1 : 0
+        options.subsample = Int32(jpeg.chromaSubsampling.rawValue)
+        options.compression = Int32(max(0, min(9, png.compression)))
+        options.palette = png.palette ? 1 : 0
+        options.tiff_compression = tiff.compression.vipsValue
+        options.tile_size = Int32(tiff.tileSize ?? 0)
+        options.effort = -1
+
+        switch format {
+        case CVIPS_SAVE_JPEG:
+            options.interlace = jpeg.progressive ? 1 : 0
+        case CVIPS_SAVE_PNG:
+            options.interlace = png.interlaced ? 1 : 0
+            options.effort = Int32(max(1, min(10, png.effort)))
+        case CVIPS_SAVE_WEBP:
+            options.effort = Int32(max(0, min(6, webP.effort)))
+        case CVIPS_SAVE_JXL:
+            options.effort = Int32(max(1, min(9, jxl.effort)))
+        default:
+            break
+        }
+        return options
+    }
+}
@@ -30,39 +30,33 @@ extension VIPSImage {
         return CGRect(x: Int(left), y: Int(top), width: Int(width), height: Int(height))
     }
 
-    /// Compute basic statistics across all bands of the image.
+    /// Compute basic statistics across all bands of the image, along with
+    /// per-band measurements. The image pipeline is evaluated only once.
     /// - Returns: A ``VIPSImageStatistics`` value containing the min, max, mean, and standard deviation
     public func statistics() throws -> VIPSImageStatistics {
-        var min: Double = 0, max: Double = 0, mean: Double = 0, stddev: Double = 0
-        guard cvips_min(pointer, &min) == 0 else { throw VIPSError.fromVips() }
-        guard cvips_max(pointer, &max) == 0 else { throw VIPSError.fromVips() }
-        guard cvips_avg(pointer, &mean) == 0 else { throw VIPSError.fromVips() }
-        guard cvips_deviate(pointer, &stddev) == 0 else { throw VIPSError.fromVips() }
-        return VIPSImageStatistics(min: min, max: max, mean: mean, standardDeviation: stddev)
+        let rows = bands + 1
+        let columns = Int(CVIPS_STATS_COLUMNS)
+        var summary = [Double](repeating: 0, count: rows * columns)
+        guard cvips_stats_summary(pointer, &summary, Int32(rows)) == 0 else {
+            throw VIPSError.fromVips()
+        }
+
+        // Each row holds min, max, sum, sum2, mean, sigma; row 0 covers all bands
+        func value(_ row: Int, _ column: Int) -> Double { summary[row * columns + column] }
+
+        let perBand = (1..<rows).map { row in
+            VIPSImageStatistics.Band(min: value(row, 0), max: value(row, 1), sum: value(row, 2),
+                                     mean: value(row, 4), standardDeviation: value(row, 5))
+        }
+        return VIPSImageStatistics(min: value(0, 0), max: value(0, 1), mean: value(0, 4),
+                                   standardDeviation: value(0, 5), bands: perBand)
     }
 
     /// Calculate the average color of the image as per-band mean values.
     /// For an RGB image, this returns a 3-band color `[R, G, B]`. For RGBA, `[R, G, B, A]`.
     /// - Returns: A ``VIPSColor`` containing the mean value for each band
     public func averageColor() throws -> VIPSColor {
-        var statsImage: UnsafeMutablePointer<VipsImage>?
-        guard cvips_stats(pointer, &statsImage) == 0, let statsImage else {
-            throw VIPSError.fromVips()
-        }
-        defer { g_object_unref(gpointer(statsImage)) }
-
-        let numBands = Int(vips_image_get_bands(pointer))
-        guard let pixel = vips_image_get_data(statsImage) else {
-            throw VIPSError("Failed to read stats data")
-        }
-
-        let data = pixel.assumingMemoryBound(to: Double.self)
-        let statsWidth = Int(vips_image_get_width(statsImage))
-        var result: [Double] = []
-        for band in 1...numBands {
-            result.append(data[4 + (statsWidth * band)])
-        }
-        return VIPSColor(values: result)
+        VIPSColor(values: try statistics().bands.map(\.mean))
     }
 
     /// Detect the background color of the image.
@@ -153,60 +147,100 @@ extension VIPSImage {
         return VIPSColor(values: weightedSum.map { $0 / Double(totalPixels) })
     }
 
-    /// Find the most prominent color along the image edges by quantizing pixels
-    /// into color buckets and returning the average color of the most frequent bucket.
+    /// Find the most prominent color along the image edges, falling back to
+    /// the overall average color if no edge pixels could be sampled.
     private func prominentEdgeColor(stripWidth sw: Int) throws -> VIPSColor {
-        let w = width
-        let h = height
-        let numBands = bands
-        let step = 32
-        let levels = (255 / step) + 1
-
-        // Collect edge strips
-        var strips = [VIPSImage]()
-        strips.append(try crop(x: 0, y: 0, width: w, height: sw))
-        strips.append(try crop(x: 0, y: h - sw, width: w, height: sw))
-        if h > sw * 2 {
-            strips.append(try crop(x: 0, y: sw, width: sw, height: h - 2 * sw))
-            strips.append(try crop(x: w - sw, y: sw, width: sw, height: h - 2 * sw))
+        guard let top = try prominentEdgeColors(count: 1, stripWidth: sw).first else {
+            return try averageColor()
         }
+        return top.color
+    }
 
-        // Count quantized color occurrences and accumulate actual values
-        var bucketCounts = [Int: Int]()
-        var bucketSums = [Int: [Double]]()
-
-        for strip in strips {
-            try strip.withPixelData { buffer in
-                for y in 0..<buffer.height {
-                    let rowBase = y * buffer.bytesPerRow
-                    for x in 0..<buffer.width {
-                        let offset = rowBase + x * numBands
-
-                        // Quantize on up to 3 bands (RGB) to build a bucket key
-                        var key = 0
-                        for b in 0..<min(numBands, 3) {
-                            key = key * levels + Int(buffer.data[offset + b]) / step
-                        }
-
-                        bucketCounts[key, default: 0] += 1
-                        if bucketSums[key] == nil {
-                            bucketSums[key] = [Double](repeating: 0, count: numBands)
-                        }
-                        for b in 0..<numBands {
-                            bucketSums[key]![b] += Double(buffer.data[offset + b])
-                        }
-                    }
-                }
-            }
+    /// Find the most prominent colors along the image edges.
+    ///
+    /// Pixels in strips along all four edges are quantized into 8×8×8 color buckets
+    /// in a single native pass, with rows split across threads. Each returned color
+    /// is the average of the actual pixel values that fell into its bucket.
+    ///
+    /// - Parameters:
+    ///   - count: The maximum number of colors to return (default is 5)
+    ///   - stripWidth: The width of the edge strip to sample in pixels (default is 10).
+    ///     Images too small to hold four strips are sampled in full.
+    /// - Returns: Up to `count` colors ordered from most to least frequent, each paired
+    ///   with the fraction of sampled edge pixels (0.0–1.0) it covers
+    public func prominentEdgeColors(count: Int = 5, stripWidth: Int = 10) throws -> [(color: VIPSColor, coverage: Double)] {
+        let prepared = try pixelAccessImage()
+        defer { g_object_unref(gpointer(prepared)) }
+
+        let numBands = Int(vips_image_get_bands(prepared))
+        let buckets = Int(CVIPS_EDGE_BUCKETS)
+        var counts = [UInt64](repeating: 0, count: buckets)
+        var sums = [Double](repeating: 0, count: buckets * numBands)
+        let threads = ProcessInfo.processInfo.activeProcessorCount
+        guard cvips_edge_histogram(prepared, Int32(max(1, stripWidth)), Int32(threads), &counts, &sums) == 0 else {
+            throw VIPSError.fromVips()
         }
 
-        guard let (topKey, topCount) = bucketCounts.max(by: { $0.value < $1.value }),
-              topCount > 0,
-              let sums = bucketSums[topKey] else {
-            return try averageColor()
+        let total = counts.reduce(0) { $0 + Int($1) }
+        guard total > 0, count > 0 else { return [] }
+
+        let ranked = counts.indices
+            .filter { counts[$0] > 0 }
+            .sorted { counts[$0] != counts[$1] ? counts[$0] > counts[$1] : $0 < $1 }
+        return ranked.prefix(count).map { key in
+            let n = Double(counts[key])
+            let values = (0..<numBands).map { sums[key * numBands + $0] / n }
+            return (VIPSColor(values: values), n / Double(total))
         }
+    }
+
+    // MARK: - Comparison
+
+    /// Find the tiles that differ between this image and another.
+    ///
+    /// Both images are read tile by tile across the available cores, and reading
+    /// stops as soon as more than `maxChangedTiles` tiles have changed, so a
+    /// mismatch is usually found without decoding the whole image. Within a tile,
+    /// comparison stops at the end of the first differing row.
+    /// - Parameters:
+    ///   - other: The image to compare against. Must have the same size and number of bands.
+    ///   - tileSize: The width and height of each compared tile in pixels (default is 64)
+    ///   - tolerance: How far a band value may differ before its tile counts as changed
+    ///     (default is 0, which treats any difference as a change)
+    ///   - maxChangedTiles: Stop once more tiles than this have changed. `nil` (default)
+    ///     compares every tile.
+    /// - Returns: The changed tiles, and whether the limit was exceeded
+    public func difference(from other: VIPSImage, tileSize: Int = 64, tolerance: Double = 0,
+                           maxChangedTiles: Int? = nil) throws -> VIPSImageDifference {
+        guard tileSize > 0 else { throw VIPSError("Tile size must be positive") }
+        let tileCount = ((width + tileSize - 1) / tileSize) * ((height + tileSize - 1) / tileSize)
+        var boxes = [Int32](repeating: 0, count: tileCount * 4)
+        var found: Int32 = 0
+        var exceeded: Int32 = 0
+        let limit = maxChangedTiles.map { Int32(clamping: max(0, $0)) } ?? -1
+        let threads = Int32(ProcessInfo.processInfo.activeProcessorCount)
+        guard cvips_diff_tiles(pointer, other.pointer, Int32(tileSize), tolerance, limit, threads,
+                               &boxes, Int32(tileCount), &found, &exceeded) == 0 else {
+            throw VIPSError.fromVips()
+        }
+
+        let tiles = (0..<Int(found)).map { i in
+            CGRect(x: Int(boxes[i * 4]), y: Int(boxes[i * 4 + 1]),
+                   width: Int(boxes[i * 4 + 2]), height: Int(boxes[i * 4 + 3]))
+        }
+        // Workers finish tiles in any order
+        let sorted = tiles.sorted { ($0.minY, $0.minX) < ($1.minY, $1.minX) }
+        return VIPSImageDifference(changedTiles: sorted, exceededLimit: exceeded != 0)
+    }
 
-        return VIPSColor(values: sums.map { $0 / Double(topCount) })
+    /// Check whether this image matches another to within a tolerance, stopping at
+    /// the first differing tile.
+    /// - Parameters:
+    ///   - other: The image to compare against. Must have the same size and number of bands.
+    ///   - tolerance: How far a band value may differ and still match (default is 0)
+    /// - Returns: `true` if no band value differs by more than `tolerance`
+    public func matches(_ other: VIPSImage, tolerance: Double = 0) throws -> Bool {
+        try difference(from: other, tolerance: tolerance, maxChangedTiles: 0).isIdentical
     }
 
     // MARK: - Arithmetic
@@ -287,4 +321,36 @@ extension VIPSImage {
             try self.detectBackgroundColor(stripWidth: stripWidth)
         }.value
     }
+
+    /// Find the most prominent colors along the image edges.
+    /// The work is performed off the calling actor via `Task.detached`.
+    /// - Parameters:
+    ///   - count: The maximum number of colors to return (default is 5)
+    ///   - stripWidth: The width of the edge strip to sample in pixels (default is 10).
+    ///     Images too small to hold four strips are sampled in full.
+    /// - Returns: Up to `count` colors ordered from most to least frequent, each paired
+    ///   with the fraction of sampled edge pixels (0.0–1.0) it covers
+    public func prominentEdgeColors(count: Int = 5, stripWidth: Int = 10) async throws -> [(color: VIPSColor, coverage: Double)] {
+        try await Task.detached {
+            try self.prominentEdgeColors(count: count, stripWidth: stripWidth)
+        }.value
+    }
+
+    /// Find the tiles that differ between this image and another.
+    /// The work is performed off the calling actor via `Task.detached`.
+    /// - Parameters:
+    ///   - other: The image to compare against. Must have the same size and number of bands.
+    ///   - tileSize: The width and height of each compared tile in pixels (default is 64)
+    ///   - tolerance: How far a band value may differ before its tile counts as changed
+    ///     (default is 0, which treats any difference as a change)
+    ///   - maxChangedTiles: Stop once more tiles than this have changed. `nil` (default)
+    ///     compares every tile.
+    /// - Returns: The changed tiles, and whether the limit was exceeded
+    public func difference(from other: VIPSImage, tileSize: Int = 64, tolerance: Double = 0,
+                           maxChangedTiles: Int? = nil) async throws -> VIPSImageDifference {
+        try await Task.detached {
+            try self.difference(from: other, tileSize: tileSize, tolerance: tolerance,
+                                maxChangedTiles: maxChangedTiles)
+        }.value
+    }
 }
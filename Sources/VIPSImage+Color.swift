@@ -154,6 +154,43 @@ extension VIPSImage {
         return VIPSImage(pointer: out)
     }
 
+    /// Apply brightness, contrast, gamma, and saturation to an 8-bit image in a single
+    /// pass that stays 8-bit throughout.
+    ///
+    /// Brightness, contrast, and gamma are folded into one 256-entry lookup table and
+    /// saturation into a fixed-point color matrix, so each pixel is read and written
+    /// once with no float intermediate. Alpha is left untouched. On CMYK images the
+    /// curve applies to the C, M, and Y ink values, so positive brightness adds ink,
+    /// and K is left untouched. Saturation scales each color's distance from its
+    /// Rec. 601 luma rather than LCH chroma, so it differs slightly from
+    /// ``adjustSaturation(_:)``. Images that are not 8-bit fall back to
+    /// ``adjust(brightness:contrast:saturation:)``, ``adjustGamma(_:)``, and
+    /// ``adjustSaturation(_:)``, applied in the same order: brightness and contrast,
+    /// then gamma, then saturation.
+    /// - Parameters:
+    ///   - brightness: The brightness adjustment (-1.0 to 1.0, where 0 is unchanged)
+    ///   - contrast: The contrast multiplier (0.5 to 2.0, where 1.0 is unchanged)
+    ///   - gamma: The gamma exponent (less than 1.0 lightens, greater darkens, 1.0 is unchanged)
+    ///   - saturation: The saturation multiplier (0 = grayscale, 1.0 = unchanged, >1.0 = more saturated)
+    /// - Returns: A new image with all adjustments applied
+    public func adjustTone(brightness: Double = 0, contrast: Double = 1.0, gamma: Double = 1.0,
+                           saturation: Double = 1.0) throws -> VIPSImage {
+        guard gamma > 0 else { throw VIPSError("Gamma must be greater than zero") }
+        guard vips_image_get_format(pointer) == VIPS_FORMAT_UCHAR else {
+            var adjusted = try adjust(brightness: brightness, contrast: contrast)
+            if gamma != 1.0 {
+                adjusted = try adjusted.adjustGamma(gamma)
+            }
+            return abs(saturation - 1.0) < 0.001 ? adjusted : try adjusted.adjustSaturation(saturation)
+        }
+
+        var out: UnsafeMutablePointer<VipsImage>?
+        guard cvips_tone_adjust(pointer, &out, brightness, contrast, gamma, saturation) == 0, let out else {
+            throw VIPSError.fromVips()
+        }
+        return VIPSImage(pointer: out)
+    }
+
     // MARK: - Async
 
     /// Convert the image to grayscale (single-band luminance).
@@ -240,4 +277,20 @@ extension VIPSImage {
             try self.adjust(brightness: brightness, contrast: contrast, saturation: saturation)
         }.value
     }
+
+    /// Apply brightness, contrast, gamma, and saturation to an 8-bit image in a single
+    /// pass that stays 8-bit throughout.
+    /// The work is performed off the calling actor via `Task.detached`.
+    /// - Parameters:
+    ///   - brightness: The brightness adjustment (-1.0 to 1.0, where 0 is unchanged)
+    ///   - contrast: The contrast multiplier (0.5 to 2.0, where 1.0 is unchanged)
+    ///   - gamma: The gamma exponent (less than 1.0 lightens, greater darkens, 1.0 is unchanged)
+    ///   - saturation: The saturation multiplier (0 = grayscale, 1.0 = unchanged, >1.0 = more saturated)
+    /// - Returns: A new image with all adjustments applied
+    public func toneAdjusted(brightness: Double = 0, contrast: Double = 1.0, gamma: Double = 1.0,
+                             saturation: Double = 1.0) async throws -> VIPSImage {
+        try await Task.detached {
+            try self.adjustTone(brightness: brightness, contrast: contrast, gamma: gamma, saturation: saturation)
+        }.value
+    }
 }
@@ -1,5 +1,6 @@
 import Foundation
 internal import vips
+internal import CVIPS
 
 // MARK: - Debug Description
 
@@ -64,6 +65,21 @@ extension VIPSImage: CustomDebugStringConvertible {
         return lines.joined(separator: "\n")
     }
 
+    // MARK: - Evaluation Counting
+
+    /// Run `body` and count how many times libvips evaluated this image's pipeline
+    /// while it ran. Used to verify that operations compute their input only once.
+    internal func countingEvaluations<T>(_ body: () throws -> T) rethrows -> (result: T, evaluations: Int) {
+        let counter = UnsafeMutablePointer<Int32>.allocate(capacity: 1)
+        counter.initialize(to: 0)
+        defer { counter.deallocate() }
+
+        let handler = cvips_image_count_evaluations(pointer, counter)
+        defer { cvips_image_stop_counting(pointer, handler) }
+        let result = try body()
+        return (result, Int(counter.pointee))
+    }
+
     // MARK: - Debug Label Helpers
 
     private static func interpretationLabel(_ interp: VipsInterpretation) -> String {
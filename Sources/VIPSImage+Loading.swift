@@ -12,42 +12,59 @@ extension VIPSImage {
     /// - Parameter path: The file path of the image to inspect
     /// - Returns: A tuple containing the image width, height, and detected format
     public static func imageInfo(atPath path: String) throws -> (width: Int, height: Int, format: VIPSImageFormat) {
-        guard let image = cvips_image_new_from_file_sequential(path) else {
-            throw VIPSError.fromVips()
+        let info = try header(atPath: path)
+        return (info.width, info.height, info.format)
+    }
+
+    /// Read the header of an image file without decoding its pixels.
+    ///
+    /// The loader is chosen by sniffing the file's magic bytes and only the header is
+    /// parsed. The probe also bypasses the libvips operation cache, so scanning very
+    /// large catalogues does not grow it.
+    /// - Parameter path: The file path of the image to inspect
+    /// - Returns: The image's dimensions, band and page counts, orientation, and format
+    public static func header(atPath path: String) throws -> VIPSImageHeader {
+        var probe = CVIPSImageProbe()
+        guard cvips_probe_file(path, &probe) == 0 else { throw VIPSError.fromVips() }
+        return VIPSImageHeader(probe: probe)
+    }
+
+    /// Read the header of encoded image data without decoding its pixels.
+    /// - Parameter data: The encoded image data
+    /// - Returns: The image's dimensions, band and page counts, orientation, and format
+    public static func header(data: Data) throws -> VIPSImageHeader {
+        var probe = CVIPSImageProbe()
+        let result = data.withUnsafeBytes { buffer in
+            cvips_probe_buffer(buffer.baseAddress, buffer.count, &probe)
         }
-        defer { g_object_unref(gpointer(image)) }
-
-        let w = Int(vips_image_get_width(image))
-        let h = Int(vips_image_get_height(image))
-
-        var format: VIPSImageFormat = .unknown
-        var loader: UnsafePointer<CChar>?
-        if vips_image_get_string(image, VIPS_META_LOADER, &loader) == 0, let loader {
-            let name = String(cString: loader)
-            if name.hasPrefix("jpeg") || name.hasPrefix("jpg") {
-                format = .jpeg
-            } else if name.hasPrefix("png") {
-                format = .png
-            } else if name.hasPrefix("webp") {
-                format = .webP
-            } else if name.hasPrefix("heif") {
-                var compression: UnsafePointer<CChar>?
-                if vips_image_get_string(image, "heif-compression", &compression) == 0,
-                   let compression, strcmp(compression, "av1") == 0 {
-                    format = .avif
-                } else {
-                    format = .heif
+        guard result == 0 else { throw VIPSError.fromVips() }
+        return VIPSImageHeader(probe: probe)
+    }
+
+    /// Read the headers of many image files in parallel.
+    /// - Parameters:
+    ///   - paths: The file paths of the images to inspect
+    ///   - maxConcurrency: The number of files probed at once (default is the number of active processor cores)
+    /// - Returns: One result per path, in the same order as `paths`
+    public static func headers(atPaths paths: [String],
+                               maxConcurrency: Int = ProcessInfo.processInfo.activeProcessorCount)
+        -> [Result<VIPSImageHeader, VIPSError>] {
+        var results = [Result<VIPSImageHeader, VIPSError>](repeating: .failure(VIPSError("Not probed")),
+                                                           count: paths.count)
+        let workers = max(1, min(maxConcurrency, paths.count))
+        results.withUnsafeMutableBufferPointer { slots in
+            // Each worker takes every `workers`-th path, keeping the thread count bounded
+            DispatchQueue.concurrentPerform(iterations: workers) { worker in
+                for index in stride(from: worker, to: paths.count, by: workers) {
+                    do {
+                        slots[index] = .success(try header(atPath: paths[index]))
+                    } catch {
+                        slots[index] = .failure(error as? VIPSError ?? VIPSError("\(error)"))
+                    }
                 }
-            } else if name.hasPrefix("jxl") {
-                format = .jxl
-            } else if name.hasPrefix("gif") {
-                format = .gif
-            } else if name.hasPrefix("tiff") {
-                format = .tiff
             }
         }
-
-        return (w, h, format)
+        return results
     }
 
     // MARK: - File Loading
@@ -139,6 +156,8 @@ extension VIPSImage {
 
     /// Create an image from a raw pixel buffer containing 8-bit unsigned data.
     /// The buffer is copied, so the caller may release it after initialization.
+    /// To wrap the memory without copying it, use
+    /// ``init(noCopyBuffer:width:height:bands:bytesPerRow:format:interpretation:owner:)``.
     /// - Parameters:
     ///   - buffer: A pointer to the raw pixel data
     ///   - width: The image width in pixels
@@ -155,6 +174,160 @@ extension VIPSImage {
         self.init(pointer: image)
     }
 
+    /// Wrap raw pixel memory, such as a camera frame or decoder output, as an image
+    /// without copying it.
+    ///
+    /// libvips reads directly from `buffer` whenever pixels are computed, which may be
+    /// long after this initializer returns. `owner` is therefore retained until libvips
+    /// has closed every image that reads the memory, and is released on whichever thread
+    /// closes the last one. Pass the object that owns the allocation, and do not modify
+    /// the memory while it is retained.
+    ///
+    /// The image itself stays out of the libvips operation cache, so an image with no
+    /// derived images releases `owner` as soon as it is deallocated. Operations applied
+    /// to it, such as a resize or a pixel read, are cached along with a reference to
+    /// their input, and keep `owner` alive until they are evicted. Call
+    /// ``Cache/clear()`` to release it sooner, or lower ``Cache/maxOperations`` when
+    /// wrapping a stream of frames.
+    ///
+    /// Padded rows are skipped without copying when `bytesPerRow` is a whole number of
+    /// pixels; otherwise the rows are packed into a copy. `.float16` samples are always
+    /// converted into a 32-bit float copy, since libvips has no half-float format. In
+    /// both of those cases `owner` is released before this initializer returns.
+    /// - Parameters:
+    ///   - buffer: The raw samples, covering `bytesPerRow * height` bytes including the
+    ///     padding after the last row
+    ///   - width: The image width in pixels
+    ///   - height: The image height in pixels
+    ///   - bands: The number of bands (channels) per pixel (e.g., 3 for RGB, 4 for RGBA)
+    ///   - bytesPerRow: The distance between the starts of consecutive rows, in bytes
+    ///     (default is `width * bands * format.bytesPerSample`)
+    ///   - format: The sample format (default is `.uint8`)
+    ///   - interpretation: How the bands should be interpreted. When nil, one or two bands
+    ///     are grayscale and more are colour, in the range the format implies: sRGB for
+    ///     8-bit, RGB16 for 16-bit and scRGB for float samples (default is nil)
+    ///   - owner: An object that keeps `buffer` valid for as long as it is retained
+    public convenience init(noCopyBuffer buffer: UnsafeRawBufferPointer, width: Int, height: Int, bands: Int,
+                            bytesPerRow: Int? = nil, format: VIPSPixelFormat = .uint8,
+                            interpretation: VIPSInterpretation? = nil, owner: AnyObject) throws {
+        guard width > 0, height > 0, bands > 0 else {
+            throw VIPSError("Width, height and bands must be positive")
+        }
+        let rowBytes = width * bands * format.bytesPerSample
+        let stride = bytesPerRow ?? rowBytes
+        guard stride >= rowBytes else { throw VIPSError("bytesPerRow is smaller than a row of pixels") }
+        // libvips is given the whole stride * height region, last row's padding included
+        guard let base = buffer.baseAddress, buffer.count >= stride * height else {
+            throw VIPSError("Buffer is too small for the given dimensions")
+        }
+
+        let space = (interpretation ?? .default(bands: bands, format: format)).vipsValue
+        let image: UnsafeMutablePointer<VipsImage>?
+        if format == .float16 {
+            image = cvips_image_new_from_half(base, stride, Int32(width), Int32(height), Int32(bands), space)
+        } else {
+            // The retain is balanced by the release callback, which the shim always calls exactly once
+            image = cvips_image_new_from_memory_owned(base, stride, Int32(width), Int32(height), Int32(bands),
+                                                      format.vipsValue, space, { context in
+                Unmanaged<AnyObject>.fromOpaque(context!).release()
+            }, Unmanaged.passRetained(owner).toOpaque())
+        }
+        guard let image else { throw VIPSError.fromVips() }
+        self.init(pointer: image)
+    }
+
+    // MARK: - Stream Loading
+
+    /// Load an image by reading from an open file descriptor (a file, pipe, or socket).
+    /// Bytes are pulled on demand, so the header is parsed as soon as it arrives
+    /// rather than after the whole payload has been buffered.
+    /// The descriptor is not closed.
+    /// - Parameters:
+    ///   - descriptor: An open, readable file descriptor
+    ///   - sequential: If true, load with sequential (top-to-bottom) access, which
+    ///     avoids buffering the whole stream for formats that need it (default is false)
+    public convenience init(fileDescriptor descriptor: Int32, sequential: Bool = false) throws {
+        guard let source = vips_source_new_from_descriptor(descriptor) else {
+            throw VIPSError.fromVips()
+        }
+        defer { g_object_unref(gpointer(source)) }
+        let image = sequential ? cvips_image_new_from_source_sequential(source) : cvips_image_new_from_source(source)
+        guard let image else { throw VIPSError.fromVips() }
+        self.init(pointer: image)
+    }
+
+    /// Load an image by pulling encoded bytes from a read closure, such as a network
+    /// or object-store client. Bytes are requested on demand, so decoding can begin
+    /// before the whole payload has arrived.
+    ///
+    /// Because decoding is lazy, `reader` is retained and may be called again, from any
+    /// thread, until libvips has finished with the image.
+    /// - Parameters:
+    ///   - reader: Fills the supplied buffer with up to `buffer.count` bytes and returns the
+    ///     number of bytes written, or 0 at the end of the stream. Throwing aborts the load.
+    ///   - sequential: If true, load with sequential (top-to-bottom) access, which
+    ///     avoids buffering the whole stream for formats that need it (default is false)
+    public convenience init(reader: @escaping @Sendable (UnsafeMutableRawBufferPointer) throws -> Int,
+                            sequential: Bool = false) throws {
+        let (source, stream) = Self.makeSource(reader)
+        defer { g_object_unref(gpointer(source)) }
+        let image = sequential ? cvips_image_new_from_source_sequential(source) : cvips_image_new_from_source(source)
+        guard let image else { throw stream.failure() }
+        self.init(pointer: image)
+    }
+
+    /// Create a thumbnail by reading from an open file descriptor, using shrink-on-load.
+    /// The descriptor is not closed.
+    /// - Parameters:
+    ///   - descriptor: An open, readable file descriptor
+    ///   - width: The maximum width of the thumbnail
+    ///   - height: The maximum height of the thumbnail
+    /// - Returns: A new thumbnail image that fits within the specified dimensions
+    public static func thumbnail(fromFileDescriptor descriptor: Int32, width: Int, height: Int) throws -> VIPSImage {
+        guard let source = vips_source_new_from_descriptor(descriptor) else {
+            throw VIPSError.fromVips()
+        }
+        defer { g_object_unref(gpointer(source)) }
+        var out: UnsafeMutablePointer<VipsImage>?
+        guard cvips_thumbnail_source(source, &out, Int32(width), Int32(height)) == 0, let out else {
+            throw VIPSError.fromVips()
+        }
+        return VIPSImage(pointer: out)
+    }
+
+    /// Create a thumbnail by pulling encoded bytes from a read closure, using shrink-on-load.
+    /// `reader` is retained and may be called from any thread until libvips has
+    /// finished with the thumbnail.
+    /// - Parameters:
+    ///   - reader: Fills the supplied buffer and returns the number of bytes written,
+    ///     or 0 at the end of the stream. Throwing aborts the load.
+    ///   - width: The maximum width of the thumbnail
+    ///   - height: The maximum height of the thumbnail
+    /// - Returns: A new thumbnail image that fits within the specified dimensions
+    public static func thumbnail(fromReader reader: @escaping @Sendable (UnsafeMutableRawBufferPointer) throws -> Int,
+                                 width: Int, height: Int) throws -> VIPSImage {
+        let (source, stream) = makeSource(reader)
+        defer { g_object_unref(gpointer(source)) }
+        var out: UnsafeMutablePointer<VipsImage>?
+        guard cvips_thumbnail_source(source, &out, Int32(width), Int32(height)) == 0, let out else {
+            throw stream.failure()
+        }
+        return VIPSImage(pointer: out)
+    }
+
+    /// Wrap a read closure in a libvips custom source. The source owns a reference
+    /// to the returned reader and releases it when libvips finalizes the source.
+    private static func makeSource(_ reader: @escaping @Sendable (UnsafeMutableRawBufferPointer) throws -> Int)
+        -> (source: UnsafeMutablePointer<VipsSource>, reader: SourceReader) {
+        let stream = SourceReader(reader)
+        let source = cvips_source_new_from_callback({ buffer, length, context in
+            Unmanaged<SourceReader>.fromOpaque(context!).takeUnretainedValue().read(buffer, length)
+        }, { context in
+            Unmanaged<SourceReader>.fromOpaque(context!).release()
+        }, Unmanaged.passRetained(stream).toOpaque())
+        return (source!, stream)
+    }
+
     // MARK: - Async
 
     /// Get the dimensions and format of an image file without decoding its pixels.
@@ -168,6 +341,40 @@ extension VIPSImage {
         }.value
     }
 
+    /// Read the header of an image file without decoding its pixels.
+    /// The work is performed off the calling actor via `Task.detached`.
+    /// - Parameter path: The file path of the image to inspect
+    /// - Returns: The image's dimensions, band and page counts, orientation, and format
+    public static func header(atPath path: String) async throws -> VIPSImageHeader {
+        try await Task.detached {
+            try Self.header(atPath: path)
+        }.value
+    }
+
+    /// Read the header of encoded image data without decoding its pixels.
+    /// The work is performed off the calling actor via `Task.detached`.
+    /// - Parameter data: The encoded image data
+    /// - Returns: The image's dimensions, band and page counts, orientation, and format
+    public static func header(data: Data) async throws -> VIPSImageHeader {
+        try await Task.detached {
+            try Self.header(data: data)
+        }.value
+    }
+
+    /// Read the headers of many image files in parallel.
+    /// The work is performed off the calling actor via `Task.detached`.
+    /// - Parameters:
+    ///   - paths: The file paths of the images to inspect
+    ///   - maxConcurrency: The number of files probed at once (default is the number of active processor cores)
+    /// - Returns: One result per path, in the same order as `paths`
+    public static func headers(atPaths paths: [String],
+                               maxConcurrency: Int = ProcessInfo.processInfo.activeProcessorCount)
+        async -> [Result<VIPSImageHeader, VIPSError>] {
+        await Task.detached {
+            Self.headers(atPaths: paths, maxConcurrency: maxConcurrency)
+        }.value
+    }
+
     /// Load an image from a file path, fully decoding it into memory.
     /// The work is performed off the calling actor via `Task.detached`.
     /// - Parameter path: The file path of the image to load
@@ -253,4 +460,112 @@ extension VIPSImage {
             try Self.thumbnail(fromData: data, size: size)
         }.value
     }
+
+    /// Load an image by reading from an open file descriptor (a file, pipe, or socket).
+    /// The descriptor is not closed.
+    /// The work is performed off the calling actor via `Task.detached`.
+    /// - Parameters:
+    ///   - descriptor: An open, readable file descriptor
+    ///   - sequential: If true, load with sequential (top-to-bottom) access (default is false)
+    /// - Returns: A new image read from the descriptor
+    public static func loaded(fromFileDescriptor descriptor: Int32, sequential: Bool = false) async throws -> VIPSImage {
+        try await Task.detached {
+            try VIPSImage(fileDescriptor: descriptor, sequential: sequential)
+        }.value
+    }
+
+    /// Load an image by pulling encoded bytes from a read closure.
+    /// The work is performed off the calling actor via `Task.detached`.
+    /// - Parameters:
+    ///   - reader: Fills the supplied buffer and returns the number of bytes written,
+    ///     or 0 at the end of the stream. Throwing aborts the load.
+    ///   - sequential: If true, load with sequential (top-to-bottom) access (default is false)
+    /// - Returns: A new image decoded from the stream
+    public static func loaded(fromReader reader: @escaping @Sendable (UnsafeMutableRawBufferPointer) throws -> Int,
+                              sequential: Bool = false) async throws -> VIPSImage {
+        try await Task.detached {
+            try VIPSImage(reader: reader, sequential: sequential)
+        }.value
+    }
+
+    /// Create a thumbnail by reading from an open file descriptor, using shrink-on-load.
+    /// The descriptor is not closed.
+    /// The work is performed off the calling actor via `Task.detached`.
+    /// - Parameters:
+    ///   - descriptor: An open, readable file descriptor
+    ///   - width: The maximum width of the thumbnail
+    ///   - height: The maximum height of the thumbnail
+    /// - Returns: A new thumbnail image that fits within the specified dimensions
+    public static func thumbnail(fromFileDescriptor descriptor: Int32, width: Int, height: Int) async throws -> VIPSImage {
+        try await Task.detached {
+            try Self.thumbnail(fromFileDescriptor: descriptor, width: width, height: height)
+        }.value
+    }
+
+    /// Create a thumbnail by pulling encoded bytes from a read closure, using shrink-on-load.
+    /// The work is performed off the calling actor via `Task.detached`.
+    /// - Parameters:
+    ///   - reader: Fills the supplied buffer and returns the number of bytes written,
+    ///     or 0 at the end of the stream. Throwing aborts the load.
+    ///   - width: The maximum width of the thumbnail
+    ///   - height: The maximum height of the thumbnail
+    /// - Returns: A new thumbnail image that fits within the specified dimensions
+    public static func thumbnail(fromReader reader: @escaping @Sendable (UnsafeMutableRawBufferPointer) throws -> Int,
+                                 width: Int, height: Int) async throws -> VIPSImage {
+        try await Task.detached {
+            try Self.thumbnail(fromReader: reader, width: width, height: height)
+        }.value
+    }
+}
+
+// MARK: - Header Probing
+
+extension VIPSImageHeader {
+
+    /// Convert a native header probe.
+    fileprivate init(probe: CVIPSImageProbe) {
+        let loader = withUnsafeBytes(of: probe.loader) { String(cString: $0.bindMemory(to: CChar.self).baseAddress!) }
+        let compression = withUnsafeBytes(of: probe.compression) {
+            String(cString: $0.bindMemory(to: CChar.self).baseAddress!)
+        }
+        self.init(width: Int(probe.width), height: Int(probe.height), bands: Int(probe.bands),
+                  pageCount: max(1, Int(probe.pages)),
+                  orientation: probe.orientation > 0 ? Int(probe.orientation) : nil,
+                  format: VIPSImageFormat(loader: loader, heifCompression: compression))
+    }
+}
+
+// MARK: - Stream Source
+
+/// Forwards reads from a libvips custom source to a Swift closure, recording
+/// the first error it throws so it can be surfaced instead of a generic libvips error.
+private final class SourceReader: @unchecked Sendable {
+    private let body: @Sendable (UnsafeMutableRawBufferPointer) throws -> Int
+    private let lock = NSLock()
+    private var error: Error?
+
+    init(_ body: @escaping @Sendable (UnsafeMutableRawBufferPointer) throws -> Int) {
+        self.body = body
+    }
+
+    func read(_ buffer: UnsafeMutableRawPointer?, _ length: gint64) -> gint64 {
+        do {
+            return gint64(try body(UnsafeMutableRawBufferPointer(start: buffer, count: Int(length))))
+        } catch {
+            lock.lock()
+            if self.error == nil { self.error = error }
+            lock.unlock()
+            return -1
+        }
+    }
+
+    /// The error that caused a load to fail: the reader's own error if it threw,
+    /// otherwise the libvips error.
+    func failure() -> Error {
+        lock.lock()
+        defer { lock.unlock() }
+        guard let error else { return VIPSError.fromVips() }
+        vips_error_clear()
+        return error
+    }
 }
@@ -0,0 +1,292 @@
+import Foundation
+internal import vips
+internal import CVIPS
+
+extension VIPSImage {
+
+    // MARK: - Page Ranges
+    //
+    // Multi-page images (TIFF, PDF, animated GIF and WebP, HEIF) load as a
+    // single tall image with pages stacked vertically, and `pageHeight` giving
+    // the height of each. These methods decode only the requested pages, so
+    // reading page 40 of a 300-page TIFF never touches the other 299.
+    // Single-page formats only accept a range starting at page 0.
+
+    /// Load a range of pages from a multi-page image file.
+    /// - Parameters:
+    ///   - path: The file path of the image to load
+    ///   - pages: The zero-based pages to load
+    /// - Returns: A new image with the pages stacked vertically
+    public convenience init(contentsOfFile path: String, pages: Range<Int>) throws {
+        try Self.validate(pages)
+        guard let image = cvips_image_new_from_file_pages(path, Int32(pages.lowerBound), Int32(pages.count)) else {
+            throw VIPSError.fromVips()
+        }
+        self.init(pointer: image)
+    }
+
+    /// Load a range of pages from multi-page image data.
+    /// - Parameters:
+    ///   - data: The encoded image data
+    ///   - pages: The zero-based pages to load
+    /// - Returns: A new image with the pages stacked vertically
+    public convenience init(data: Data, pages: Range<Int>) throws {
+        try Self.validate(pages)
+        let image: UnsafeMutablePointer<VipsImage>? = data.withUnsafeBytes { buffer in
+            cvips_image_new_from_buffer_pages(buffer.baseAddress, buffer.count,
+                                              Int32(pages.lowerBound), Int32(pages.count))
+        }
+        guard let image else { throw VIPSError.fromVips() }
+        self.init(pointer: image)
+    }
+
+    /// Create a thumbnail of a range of pages from a multi-page image file.
+    /// Each page is scaled to fit within the given size, using shrink-on-load
+    /// where the format supports it.
+    /// - Parameters:
+    ///   - path: The file path of the source image
+    ///   - width: The maximum width of each page
+    ///   - height: The maximum height of each page
+    ///   - pages: The zero-based pages to include
+    /// - Returns: A thumbnail with the scaled pages stacked vertically
+    public static func thumbnail(fromFile path: String, width: Int, height: Int,
+                                 pages: Range<Int>) throws -> VIPSImage {
+        try validate(pages)
+        var out: UnsafeMutablePointer<VipsImage>?
+        guard cvips_thumbnail_pages(path, &out, Int32(width), Int32(height),
+                                    Int32(pages.lowerBound), Int32(pages.count)) == 0,
+              let out else {
+            throw VIPSError.fromVips()
+        }
+        return VIPSImage(pointer: out)
+    }
+
+    /// Create a thumbnail of a range of pages from multi-page image data.
+    /// Each page is scaled to fit within the given size, using shrink-on-load
+    /// where the format supports it.
+    /// - Parameters:
+    ///   - data: The encoded image data
+    ///   - width: The maximum width of each page
+    ///   - height: The maximum height of each page
+    ///   - pages: The zero-based pages to include
+    /// - Returns: A thumbnail with the scaled pages stacked vertically
+    public static func thumbnail(fromData data: Data, width: Int, height: Int,
+                                 pages: Range<Int>) throws -> VIPSImage {
+        try validate(pages)
+        return try data.withUnsafeBytes { buffer in
+            var out: UnsafeMutablePointer<VipsImage>?
+            guard cvips_thumbnail_buffer_pages(buffer.baseAddress, buffer.count, &out, Int32(width), Int32(height),
+                                               Int32(pages.lowerBound), Int32(pages.count)) == 0,
+                  let out else {
+                throw VIPSError.fromVips()
+            }
+            return VIPSImage(pointer: out)
+        }
+    }
+
+    // MARK: - Per-Page Processing
+
+    /// Process the pages of a multi-page image file concurrently.
+    ///
+    /// For TIFF, PDF and HEIF, each worker decodes only its own page, applies
+    /// `transform`, and renders the result, so both decoding and processing run in
+    /// parallel. Frames of animated GIF and WebP images are composited over the
+    /// frames before them, so decoding one alone means decoding all of its
+    /// predecessors; those are instead decoded once, in order, into memory, and
+    /// only the transforms run in parallel. Combine the results with
+    /// ``joiningPages(_:)`` to save them as a multi-page or animated image.
+    /// - Parameters:
+    ///   - path: The file path of the source image
+    ///   - pages: The zero-based pages to process (default is every page)
+    ///   - maxConcurrency: The number of pages processed at once (default is the number of active processor cores)
+    ///   - transform: Called with each decoded page and its index; returns the processed page
+    /// - Returns: The processed pages, in page order, rendered into memory
+    public static func mapPages(ofFile path: String, pages: Range<Int>? = nil,
+                                maxConcurrency: Int = ProcessInfo.processInfo.activeProcessorCount,
+                                transform: (VIPSImage, Int) throws -> VIPSImage) throws -> [VIPSImage] {
+        let header = try header(atPath: path)
+        let range = pages ?? 0..<header.pageCount
+        if composesFrames(header.format) {
+            let frames = try VIPSImage(contentsOfFile: path, pages: range).copiedToMemory()
+            return try mapPages(range, maxConcurrency: maxConcurrency, transform: transform) { page in
+                try frames.extractedPage(page - range.lowerBound)
+            }
+        }
+        return try mapPages(range, maxConcurrency: maxConcurrency, transform: transform) { page in
+            try VIPSImage(contentsOfFile: path, pages: page..<page + 1)
+        }
+    }
+
+    /// Process the pages of multi-page image data concurrently.
+    ///
+    /// See ``mapPages(ofFile:pages:maxConcurrency:transform:)`` for details.
+    /// - Parameters:
+    ///   - data: The encoded image data
+    ///   - pages: The zero-based pages to process (default is every page)
+    ///   - maxConcurrency: The number of pages processed at once (default is the number of active processor cores)
+    ///   - transform: Called with each decoded page and its index; returns the processed page
+    /// - Returns: The processed pages, in page order, rendered into memory
+    public static func mapPages(ofData data: Data, pages: Range<Int>? = nil,
+                                maxConcurrency: Int = ProcessInfo.processInfo.activeProcessorCount,
+                                transform: (VIPSImage, Int) throws -> VIPSImage) throws -> [VIPSImage] {
+        let header = try header(data: data)
+        let range = pages ?? 0..<header.pageCount
+        if composesFrames(header.format) {
+            let frames = try VIPSImage(data: data, pages: range).copiedToMemory()
+            return try mapPages(range, maxConcurrency: maxConcurrency, transform: transform) { page in
+                try frames.extractedPage(page - range.lowerBound)
+            }
+        }
+        return try mapPages(range, maxConcurrency: maxConcurrency, transform: transform) { page in
+            try VIPSImage(data: data, pages: page..<page + 1)
+        }
+    }
+
+    /// Stack equally sized pages into one tall multi-page image, ready to save as
+    /// a multi-page TIFF or an animated GIF or WebP. Frame delays are carried over
+    /// from each page where present.
+    /// - Parameter pages: The pages, in order. All must have the same width and height.
+    /// - Returns: A new image with the pages stacked vertically and `pageHeight` set
+    public static func joiningPages(_ pages: [VIPSImage]) throws -> VIPSImage {
+        guard !pages.isEmpty else { throw VIPSError("At least one page is required") }
+        var pointers: [UnsafeMutablePointer<VipsImage>?] = pages.map { $0.pointer }
+        var out: UnsafeMutablePointer<VipsImage>?
+        let result = pointers.withUnsafeMutableBufferPointer { buffer in
+            cvips_join_pages(buffer.baseAddress, Int32(buffer.count), &out)
+        }
+        guard result == 0, let out else { throw VIPSError.fromVips() }
+        // Keep the pages alive until libvips has taken its own references
+        withExtendedLifetime(pages) {}
+        return VIPSImage(pointer: out)
+    }
+
+    private static func validate(_ pages: Range<Int>) throws {
+        guard !pages.isEmpty, pages.lowerBound >= 0 else {
+            throw VIPSError("Page range must be non-empty and start at page 0 or later")
+        }
+    }
+
+    /// Whether each frame of `format` is composited over the previous ones, so
+    /// decoding page `n` on its own decodes pages `0...n`.
+    private static func composesFrames(_ format: VIPSImageFormat) -> Bool {
+        format == .gif || format == .webP
+    }
+
+    /// Crop one page out of a multi-page image held in memory.
+    private func extractedPage(_ index: Int) throws -> VIPSImage {
+        var out: UnsafeMutablePointer<VipsImage>?
+        guard cvips_extract_page(pointer, Int32(index), &out) == 0, let out else {
+            throw VIPSError.fromVips()
+        }
+        return VIPSImage(pointer: out)
+    }
+
+    private static func mapPages(_ range: Range<Int>, maxConcurrency: Int,
+                                 transform: (VIPSImage, Int) throws -> VIPSImage,
+                                 load: (Int) throws -> VIPSImage) throws -> [VIPSImage] {
+        try validate(range)
+        var results = [Result<VIPSImage, Error>?](repeating: nil, count: range.count)
+        let workers = max(1, min(maxConcurrency, range.count))
+        results.withUnsafeMutableBufferPointer { slots in
+            // Each worker takes every `workers`-th page, keeping the thread count bounded
+            DispatchQueue.concurrentPerform(iterations: workers) { worker in
+                for offset in stride(from: worker, to: range.count, by: workers) {
+                    let page = range.lowerBound + offset
+                    // Render on this worker, so pages are not evaluated serially later
+                    slots[offset] = Result { try transform(try load(page), page).copiedToMemory() }
+                }
+            }
+        }
+        return try results.map { try $0!.get() }
+    }
+
+    // MARK: - Async
+
+    /// Load a range of pages from a multi-page image file.
+    /// The work is performed off the calling actor via `Task.detached`.
+    /// - Parameters:
+    ///   - path: The file path of the image to load
+    ///   - pages: The zero-based pages to load
+    /// - Returns: A new image with the pages stacked vertically
+    public static func loaded(fromFile path: String, pages: Range<Int>) async throws -> VIPSImage {
+        try await Task.detached {
+            try VIPSImage(contentsOfFile: path, pages: pages)
+        }.value
+    }
+
+    /// Load a range of pages from multi-page image data.
+    /// The work is performed off the calling actor via `Task.detached`.
+    /// - Parameters:
+    ///   - data: The encoded image data
+    ///   - pages: The zero-based pages to load
+    /// - Returns: A new image with the pages stacked vertically
+    public static func loaded(data: Data, pages: Range<Int>) async throws -> VIPSImage {
+        try await Task.detached {
+            try VIPSImage(data: data, pages: pages)
+        }.value
+    }
+
+    /// Create a thumbnail of a range of pages from a multi-page image file.
+    /// The work is performed off the calling actor via `Task.detached`.
+    /// - Parameters:
+    ///   - path: The file path of the source image
+    ///   - width: The maximum width of each page
+    ///   - height: The maximum height of each page
+    ///   - pages: The zero-based pages to include
+    /// - Returns: A thumbnail with the scaled pages stacked vertically
+    public static func thumbnail(fromFile path: String, width: Int, height: Int,
+                                 pages: Range<Int>) async throws -> VIPSImage {
+        try await Task.detached {
+            try Self.thumbnail(fromFile: path, width: width, height: height, pages: pages)
+        }.value
+    }
+
+    /// Create a thumbnail of a range of pages from multi-page image data.
+    /// The work is performed off the calling actor via `Task.detached`.
+    /// - Parameters:
+    ///   - data: The encoded image data
+    ///   - width: The maximum width of each page
+    ///   - height: The maximum height of each page
+    ///   - pages: The zero-based pages to include
+    /// - Returns: A thumbnail with the scaled pages stacked vertically
+    public static func thumbnail(fromData data: Data, width: Int, height: Int,
+                                 pages: Range<Int>) async throws -> VIPSImage {
+        try await Task.detached {
+            try Self.thumbnail(fromData: data, width: width, height: height, pages: pages)
+        }.value
+    }
+
+    /// Process the pages of a multi-page image file concurrently.
+    /// The work is performed off the calling actor via `Task.detached`.
+    /// - Parameters:
+    ///   - path: The file path of the source image
+    ///   - pages: The zero-based pages to process (default is every page)
+    ///   - maxConcurrency: The number of pages processed at once (default is the number of active processor cores)
+    ///   - transform: Called with each decoded page and its index; returns the processed page
+    /// - Returns: The processed pages, in page order, rendered into memory
+    public static func mapPages(ofFile path: String, pages: Range<Int>? = nil,
+                                maxConcurrency: Int = ProcessInfo.processInfo.activeProcessorCount,
+                                transform: @escaping @Sendable (VIPSImage, Int) throws -> VIPSImage)
+        async throws -> [VIPSImage] {
+        try await Task.detached {
+            try Self.mapPages(ofFile: path, pages: pages, maxConcurrency: maxConcurrency, transform: transform)
+        }.value
+    }
+
+    /// Process the pages of multi-page image data concurrently.
+    /// The work is performed off the calling actor via `Task.detached`.
+    /// - Parameters:
+    ///   - data: The encoded image data
+    ///   - pages: The zero-based pages to process (default is every page)
+    ///   - maxConcurrency: The number of pages processed at once (default is the number of active processor cores)
+    ///   - transform: Called with each decoded page and its index; returns the processed page
+    /// - Returns: The processed pages, in page order, rendered into memory
+    public static func mapPages(ofData data: Data, pages: Range<Int>? = nil,
+                                maxConcurrency: Int = ProcessInfo.processInfo.activeProcessorCount,
+                                transform: @escaping @Sendable (VIPSImage, Int) throws -> VIPSImage)
+        async throws -> [VIPSImage] {
+        try await Task.detached {
+            try Self.mapPages(ofData: data, pages: pages, maxConcurrency: maxConcurrency, transform: transform)
+        }.value
+    }
+}
@@ -0,0 +1,356 @@
+import Foundation
+import CoreGraphics
+internal import vips
+internal import CVIPS
+
+/// A reduced-resolution copy of an image used for analysis, with its scale.
+private struct AnalysisPreview {
+    let image: VIPSImage
+    let scaleX: Double
+    let scaleY: Double
+
+    /// How far, in source pixels, an edge found on the preview can be from the
+    /// true edge: one preview pixel of quantization plus the reach of the
+    /// Lanczos kernel used to shrink it.
+    var margin: Int { 3 * Int(max(scaleX, scaleY).rounded(.up)) }
+
+    /// Wrap `image` as a preview of a `width` x `height` source, or return nil
+    /// when it is not actually smaller.
+    init?(_ image: VIPSImage, sourceWidth width: Int, sourceHeight height: Int) {
+        guard image.width < width || image.height < height else { return nil }
+        self.image = image
+        scaleX = Double(width) / Double(image.width)
+        scaleY = Double(height) / Double(image.height)
+    }
+}
+
+extension VIPSImage {
+
+    // MARK: - Preview Analysis
+
+    /// Find the bounding box of non-background pixels, analyzing a reduced-resolution
+    /// preview and, if a tolerance is set, refining the edges at full resolution.
+    ///
+    /// Content that is fainter than `threshold` once shrunk into the preview, such as a
+    /// hairline on a wide margin, can be missed.
+    /// - Parameters:
+    ///   - threshold: How different a pixel must be from the background to count as
+    ///     content (default is 10.0)
+    ///   - background: An explicit background color. If `nil`, the libvips default is used.
+    ///   - preview: The preview size and accuracy tolerance
+    /// - Returns: A rectangle describing the bounding box of the content area, in source pixels
+    public func findTrim(threshold: Double = 10.0, background: VIPSColor? = nil,
+                         preview: VIPSPreviewOptions) throws -> CGRect {
+        try Self.findTrim(in: self, preview: try analysisPreview(size: preview.size),
+                          threshold: threshold, background: background, tolerance: preview.tolerance)
+    }
+
+    /// Find the bounding box of non-background pixels in an image file, analyzing a
+    /// shrink-on-load preview and optionally refining the edges at full resolution.
+    /// - Parameters:
+    ///   - path: The file path of the image
+    ///   - threshold: How different a pixel must be from the background to count as
+    ///     content (default is 10.0)
+    ///   - background: An explicit background color. If `nil`, the libvips default is used.
+    ///   - preview: The preview size and accuracy tolerance (default is ``VIPSPreviewOptions/init(size:tolerance:)``)
+    /// - Returns: A rectangle describing the bounding box of the content area, in source pixels
+    public static func findTrim(fromFile path: String, threshold: Double = 10.0, background: VIPSColor? = nil,
+                                preview: VIPSPreviewOptions = VIPSPreviewOptions()) throws -> CGRect {
+        let source = try VIPSImage(contentsOfFile: path)
+        return try findTrim(in: source, preview: try analysisPreview(fromFile: path, size: preview.size, of: source),
+                            threshold: threshold, background: background, tolerance: preview.tolerance)
+    }
+
+    /// Find the bounding box of non-background pixels in encoded image data, analyzing
+    /// a shrink-on-load preview and optionally refining the edges at full resolution.
+    /// - Parameters:
+    ///   - data: The encoded image data
+    ///   - threshold: How different a pixel must be from the background to count as
+    ///     content (default is 10.0)
+    ///   - background: An explicit background color. If `nil`, the libvips default is used.
+    ///   - preview: The preview size and accuracy tolerance (default is ``VIPSPreviewOptions/init(size:tolerance:)``)
+    /// - Returns: A rectangle describing the bounding box of the content area, in source pixels
+    public static func findTrim(fromData data: Data, threshold: Double = 10.0, background: VIPSColor? = nil,
+                                preview: VIPSPreviewOptions = VIPSPreviewOptions()) throws -> CGRect {
+        let source = try VIPSImage(data: data)
+        return try findTrim(in: source, preview: try analysisPreview(fromData: data, size: preview.size, of: source),
+                            threshold: threshold, background: background, tolerance: preview.tolerance)
+    }
+
+    /// Find the window a content-aware smart crop to the specified dimensions would keep,
+    /// without cropping.
+    /// - Parameters:
+    ///   - width: The target width in pixels
+    ///   - height: The target height in pixels
+    ///   - interesting: The strategy for selecting the interesting region
+    ///     (default is ``VIPSInteresting/attention``)
+    /// - Returns: The crop window in source pixels
+    public func smartCropRegion(toWidth width: Int, height: Int,
+                                interesting: VIPSInteresting = .attention) throws -> CGRect {
+        var left: Int32 = 0, top: Int32 = 0
+        guard cvips_smartcrop_rect(pointer, Int32(width), Int32(height), interesting.vipsValue, &left, &top) == 0 else {
+            throw VIPSError.fromVips()
+        }
+        return CGRect(x: Int(left), y: Int(top), width: width, height: height)
+    }
+
+    /// Find the window a content-aware smart crop would keep, choosing it on a
+    /// reduced-resolution preview and optionally refining its position at full resolution.
+    /// - Parameters:
+    ///   - width: The target width in pixels
+    ///   - height: The target height in pixels
+    ///   - interesting: The strategy for selecting the interesting region
+    ///     (default is ``VIPSInteresting/attention``)
+    ///   - preview: The preview size and accuracy tolerance
+    /// - Returns: The crop window in source pixels
+    public func smartCropRegion(toWidth width: Int, height: Int, interesting: VIPSInteresting = .attention,
+                                preview: VIPSPreviewOptions) throws -> CGRect {
+        try Self.smartCropRegion(in: self, preview: try analysisPreview(size: preview.size),
+                                 width: width, height: height, interesting: interesting,
+                                 tolerance: preview.tolerance)
+    }
+
+    /// Find the window a content-aware smart crop of an image file would keep, choosing
+    /// it on a shrink-on-load preview and optionally refining its position at full resolution.
+    /// - Parameters:
+    ///   - path: The file path of the image
+    ///   - width: The target width in pixels
+    ///   - height: The target height in pixels
+    ///   - interesting: The strategy for selecting the interesting region
+    ///     (default is ``VIPSInteresting/attention``)
+    ///   - preview: The preview size and accuracy tolerance (default is ``VIPSPreviewOptions/init(size:tolerance:)``)
+    /// - Returns: The crop window in source pixels
+    public static func smartCropRegion(fromFile path: String, toWidth width: Int, height: Int,
+                                       interesting: VIPSInteresting = .attention,
+                                       preview: VIPSPreviewOptions = VIPSPreviewOptions()) throws -> CGRect {
+        let source = try VIPSImage(contentsOfFile: path)
+        return try smartCropRegion(in: source,
+                                   preview: try analysisPreview(fromFile: path, size: preview.size, of: source),
+                                   width: width, height: height, interesting: interesting,
+                                   tolerance: preview.tolerance)
+    }
+
+    /// Perform a content-aware smart crop, choosing the window on a reduced-resolution
+    /// preview and optionally refining its position at full resolution.
+    /// - Parameters:
+    ///   - width: The target width in pixels
+    ///   - height: The target height in pixels
+    ///   - interesting: The strategy for selecting the interesting region
+    ///     (default is ``VIPSInteresting/attention``)
+    ///   - preview: The preview size and accuracy tolerance
+    /// - Returns: A new image cropped to the target dimensions around the most interesting region
+    public func smartCrop(toWidth width: Int, height: Int, interesting: VIPSInteresting = .attention,
+                          preview: VIPSPreviewOptions) throws -> VIPSImage {
+        try crop(try smartCropRegion(toWidth: width, height: height, interesting: interesting, preview: preview))
+    }
+
+    /// Detect the background color from a reduced-resolution preview.
+    ///
+    /// Background colors are averages over margins and edge strips, which shrinking
+    /// preserves, so no full-resolution refinement is needed and
+    /// ``VIPSPreviewOptions/tolerance`` is ignored.
+    /// - Parameters:
+    ///   - stripWidth: The width of the edge strip to sample, in source pixels (default is 10)
+    ///   - preview: The preview size
+    /// - Returns: A ``VIPSColor`` representing the detected background color
+    public func detectBackgroundColor(stripWidth: Int = 10, preview: VIPSPreviewOptions) throws -> VIPSColor {
+        guard let reduced = try analysisPreview(size: preview.size) else {
+            return try detectBackgroundColor(stripWidth: stripWidth)
+        }
+        return try reduced.image.detectBackgroundColor(stripWidth: Self.previewStripWidth(stripWidth, reduced))
+    }
+
+    /// Detect the background color of an image file from a shrink-on-load preview,
+    /// without decoding it at full resolution.
+    /// - Parameters:
+    ///   - path: The file path of the image
+    ///   - stripWidth: The width of the edge strip to sample, in source pixels (default is 10)
+    ///   - preview: The preview size (default is ``VIPSPreviewOptions/init(size:tolerance:)``)
+    /// - Returns: A ``VIPSColor`` representing the detected background color
+    public static func detectBackgroundColor(fromFile path: String, stripWidth: Int = 10,
+                                             preview: VIPSPreviewOptions = VIPSPreviewOptions()) throws -> VIPSColor {
+        let source = try VIPSImage(contentsOfFile: path)
+        guard let reduced = try analysisPreview(fromFile: path, size: preview.size, of: source) else {
+            return try source.detectBackgroundColor(stripWidth: stripWidth)
+        }
+        return try reduced.image.detectBackgroundColor(stripWidth: previewStripWidth(stripWidth, reduced))
+    }
+
+    // MARK: - Preview Helpers
+
+    private static func previewStripWidth(_ stripWidth: Int, _ preview: AnalysisPreview) -> Int {
+        max(1, Int((Double(stripWidth) / max(preview.scaleX, preview.scaleY)).rounded()))
+    }
+
+    /// Shrink this image to fit within `size` x `size`, or nil if it already fits.
+    private func analysisPreview(size: Int) throws -> AnalysisPreview? {
+        var out: UnsafeMutablePointer<VipsImage>?
+        guard cvips_preview_image(pointer, &out, Int32(max(1, size))) == 0, let out else {
+            throw VIPSError.fromVips()
+        }
+        return AnalysisPreview(try VIPSImage(pointer: out).copiedToMemory(), sourceWidth: width, sourceHeight: height)
+    }
+
+    /// Shrink-on-load a file to fit within `size` x `size`, or nil if `source` already fits.
+    private static func analysisPreview(fromFile path: String, size: Int,
+                                        of source: VIPSImage) throws -> AnalysisPreview? {
+        var out: UnsafeMutablePointer<VipsImage>?
+        guard cvips_preview(path, &out, Int32(max(1, size))) == 0, let out else {
+            throw VIPSError.fromVips()
+        }
+        return AnalysisPreview(try VIPSImage(pointer: out).copiedToMemory(),
+                               sourceWidth: source.width, sourceHeight: source.height)
+    }
+
+    /// Shrink-on-load encoded data to fit within `size` x `size`, or nil if `source` already fits.
+    private static func analysisPreview(fromData data: Data, size: Int,
+                                        of source: VIPSImage) throws -> AnalysisPreview? {
+        // Materialized before the buffer goes out of scope
+        let image = try data.withUnsafeBytes { buffer in
+            var out: UnsafeMutablePointer<VipsImage>?
+            guard cvips_preview_buffer(buffer.baseAddress, buffer.count, &out, Int32(max(1, size))) == 0,
+                  let out else {
+                throw VIPSError.fromVips()
+            }
+            return try VIPSImage(pointer: out).copiedToMemory()
+        }
+        return AnalysisPreview(image, sourceWidth: source.width, sourceHeight: source.height)
+    }
+
+    /// Trim on the preview, then move each edge to where a full-resolution band
+    /// around it says the content starts.
+    private static func findTrim(in source: VIPSImage, preview: AnalysisPreview?, threshold: Double,
+                                 background: VIPSColor?, tolerance: Int?) throws -> CGRect {
+        guard let preview else {
+            return try source.findTrim(threshold: threshold, background: background)
+        }
+        let coarse = try preview.image.findTrim(threshold: threshold, background: background)
+        guard !coarse.isEmpty else {
+            return CGRect(x: coarse.minX * preview.scaleX, y: coarse.minY * preview.scaleY,
+                          width: coarse.width * preview.scaleX, height: coarse.height * preview.scaleY)
+        }
+
+        let w = source.width, h = source.height
+        var left = max(0, Int((coarse.minX * preview.scaleX).rounded(.down)))
+        var top = max(0, Int((coarse.minY * preview.scaleY).rounded(.down)))
+        var right = min(w, Int((coarse.maxX * preview.scaleX).rounded(.up)))
+        var bottom = min(h, Int((coarse.maxY * preview.scaleY).rounded(.up)))
+        let m = preview.margin
+        guard m > tolerance ?? m else {
+            return CGRect(x: left, y: top, width: right - left, height: bottom - top)
+        }
+
+        // Each band spans the content's extent across it plus the margin, so it
+        // contains the outermost content pixel on that side.
+        func trim(x: Int, y: Int, width: Int, height: Int) throws -> CGRect? {
+            guard width > 0, height > 0 else { return nil }
+            let band = try source.crop(x: x, y: y, width: width, height: height)
+                .findTrim(threshold: threshold, background: background)
+            return band.isEmpty ? nil : band.offsetBy(dx: CGFloat(x), dy: CGFloat(y))
+        }
+        let y0 = max(0, top - m), y1 = min(h, bottom + m)
+        let x0 = max(0, left - m), x1 = min(w, right + m)
+
+        let leftBand = (x0, min(w, left + m))
+        let rightBand = (max(0, right - m), x1)
+        let topBand = (y0, min(h, top + m))
+        let bottomBand = (max(0, bottom - m), y1)
+
+        let newLeft = try trim(x: leftBand.0, y: y0, width: leftBand.1 - leftBand.0, height: y1 - y0)
+            .map { Int($0.minX) } ?? leftBand.1
+        let newRight = try trim(x: rightBand.0, y: y0, width: rightBand.1 - rightBand.0, height: y1 - y0)
+            .map { Int($0.maxX) } ?? rightBand.0
+        let newTop = try trim(x: x0, y: topBand.0, width: x1 - x0, height: topBand.1 - topBand.0)
+            .map { Int($0.minY) } ?? topBand.1
+        let newBottom = try trim(x: x0, y: bottomBand.0, width: x1 - x0, height: bottomBand.1 - bottomBand.0)
+            .map { Int($0.maxY) } ?? bottomBand.0
+
+        // Bands that overlap on a narrow box can disagree; keep the preview edges then
+        if newLeft < newRight { left = newLeft; right = newRight }
+        if newTop < newBottom { top = newTop; bottom = newBottom }
+        return CGRect(x: left, y: top, width: right - left, height: bottom - top)
+    }
+
+    /// Choose the window on the preview, then let smart crop re-place it within a
+    /// full-resolution area extending the margin past each side.
+    private static func smartCropRegion(in source: VIPSImage, preview: AnalysisPreview?, width: Int, height: Int,
+                                        interesting: VIPSInteresting, tolerance: Int?) throws -> CGRect {
+        guard width > 0, height > 0, width <= source.width, height <= source.height else {
+            throw VIPSError("Smart crop size \(width)x\(height) does not fit in \(source.width)x\(source.height)")
+        }
+        guard let preview else {
+            return try source.smartCropRegion(toWidth: width, height: height, interesting: interesting)
+        }
+
+        let previewWidth = min(preview.image.width, max(1, Int((Double(width) / preview.scaleX).rounded())))
+        let previewHeight = min(preview.image.height, max(1, Int((Double(height) / preview.scaleY).rounded())))
+        let coarse = try preview.image.smartCropRegion(toWidth: previewWidth, height: previewHeight,
+                                                       interesting: interesting)
+        let left = min(source.width - width, Int((coarse.minX * preview.scaleX).rounded()))
+        let top = min(source.height - height, Int((coarse.minY * preview.scaleY).rounded()))
+        let m = preview.margin
+        guard m > tolerance ?? m else {
+            return CGRect(x: left, y: top, width: width, height: height)
+        }
+
+        let x0 = max(0, left - m), y0 = max(0, top - m)
+        let x1 = min(source.width, left + width + m), y1 = min(source.height, top + height + m)
+        let refined = try source.crop(x: x0, y: y0, width: x1 - x0, height: y1 - y0)
+            .smartCropRegion(toWidth: width, height: height, interesting: interesting)
+        return refined.offsetBy(dx: CGFloat(x0), dy: CGFloat(y0))
+    }
+
+    // MARK: - Async
+
+    /// Find the bounding box of non-background pixels in an image file, analyzing a
+    /// shrink-on-load preview and optionally refining the edges at full resolution.
+    /// The work is performed off the calling actor via `Task.detached`.
+    /// - Parameters:
+    ///   - path: The file path of the image
+    ///   - threshold: How different a pixel must be from the background to count as
+    ///     content (default is 10.0)
+    ///   - background: An explicit background color. If `nil`, the libvips default is used.
+    ///   - preview: The preview size and accuracy tolerance (default is ``VIPSPreviewOptions/init(size:tolerance:)``)
+    /// - Returns: A rectangle describing the bounding box of the content area, in source pixels
+    public static func findTrim(fromFile path: String, threshold: Double = 10.0, background: VIPSColor? = nil,
+                                preview: VIPSPreviewOptions = VIPSPreviewOptions()) async throws -> CGRect {
+        try await Task.detached {
+            try Self.findTrim(fromFile: path, threshold: threshold, background: background, preview: preview)
+        }.value
+    }
+
+    /// Find the window a content-aware smart crop of an image file would keep, choosing
+    /// it on a shrink-on-load preview and optionally refining its position at full resolution.
+    /// The work is performed off the calling actor via `Task.detached`.
+    /// - Parameters:
+    ///   - path: The file path of the image
+    ///   - width: The target width in pixels
+    ///   - height: The target height in pixels
+    ///   - interesting: The strategy for selecting the interesting region
+    ///     (default is ``VIPSInteresting/attention``)
+    ///   - preview: The preview size and accuracy tolerance (default is ``VIPSPreviewOptions/init(size:tolerance:)``)
+    /// - Returns: The crop window in source pixels
+    public static func smartCropRegion(fromFile path: String, toWidth width: Int, height: Int,
+                                       interesting: VIPSInteresting = .attention,
+                                       preview: VIPSPreviewOptions = VIPSPreviewOptions()) async throws -> CGRect {
+        try await Task.detached {
+            try Self.smartCropRegion(fromFile: path, toWidth: width, height: height,
+                                     interesting: interesting, preview: preview)
+        }.value
+    }
+
+    /// Detect the background color of an image file from a shrink-on-load preview,
+    /// without decoding it at full resolution.
+    /// The work is performed off the calling actor via `Task.detached`.
+    /// - Parameters:
+    ///   - path: The file path of the image
+    ///   - stripWidth: The width of the edge strip to sample, in source pixels (default is 10)
+    ///   - preview: The preview size (default is ``VIPSPreviewOptions/init(size:tolerance:)``)
+    /// - Returns: A ``VIPSColor`` representing the detected background color
+    public static func detectedBackgroundColor(fromFile path: String, stripWidth: Int = 10,
+                                               preview: VIPSPreviewOptions = VIPSPreviewOptions()) async throws -> VIPSColor {
+        try await Task.detached {
+            try Self.detectBackgroundColor(fromFile: path, stripWidth: stripWidth, preview: preview)
+        }.value
+    }
+}
@@ -0,0 +1,151 @@
+import Foundation
+internal import vips
+internal import CVIPS
+
+/// One encoded size and format produced by ``VIPSImage/renditions(fromData:widths:formats:quality:)``.
+public struct VIPSRendition: Sendable {
+    /// The width this rendition was requested at
+    public let targetWidth: Int
+    /// The actual width of the encoded image in pixels. Smaller than
+    /// ``targetWidth`` when the source is narrower, since sources are never upscaled.
+    public let width: Int
+    /// The actual height of the encoded image in pixels
+    public let height: Int
+    /// The format the image was encoded as
+    public let format: VIPSImageFormat
+    /// The encoded image data
+    public let data: Data
+}
+
+extension VIPSImage {
+
+    // MARK: - Renditions
+
+    /// Generate a responsive image set (several widths, each in one or more formats)
+    /// from encoded image data, decoding the source only once.
+    ///
+    /// The source is decoded directly at the largest requested width, using
+    /// shrink-on-load where the format supports it. Each smaller width is then
+    /// resized from the next larger one rather than from the source, and all
+    /// encodes run in parallel across the available cores.
+    ///
+    /// Sources are never upscaled.
+    /// - Parameters:
+    ///   - data: The encoded source image
+    ///   - widths: The target widths. Heights follow the source aspect ratio.
+    ///   - formats: The formats to encode each width as (default is JPEG)
+    ///   - quality: The encoding quality (1-100, default is 85). Ignored for PNG and TIFF.
+    /// - Returns: One rendition per width and format, ordered from the largest width
+    ///   down, with formats in the order given
+    public static func renditions(fromData data: Data, widths: [Int], formats: [VIPSImageFormat] = [.jpeg],
+                                  quality: Int = 85) throws -> [VIPSRendition] {
+        try makeRenditions(widths: widths, formats: formats, quality: quality) { width in
+            try data.withUnsafeBytes { buffer in
+                var out: UnsafeMutablePointer<VipsImage>?
+                guard cvips_thumbnail_buffer_width(buffer.baseAddress, buffer.count, &out, Int32(width)) == 0,
+                      let out else {
+                    throw VIPSError.fromVips()
+                }
+                return VIPSImage(pointer: out)
+            }
+        }.renditions
+    }
+
+    /// Generate a responsive image set (several widths, each in one or more formats)
+    /// from an image file, decoding the source only once.
+    ///
+    /// See ``renditions(fromData:widths:formats:quality:)`` for details.
+    /// - Parameters:
+    ///   - path: The file path of the source image
+    ///   - widths: The target widths. Heights follow the source aspect ratio.
+    ///   - formats: The formats to encode each width as (default is JPEG)
+    ///   - quality: The encoding quality (1-100, default is 85). Ignored for PNG and TIFF.
+    /// - Returns: One rendition per width and format, ordered from the largest width
+    ///   down, with formats in the order given
+    public static func renditions(fromFile path: String, widths: [Int], formats: [VIPSImageFormat] = [.jpeg],
+                                  quality: Int = 85) throws -> [VIPSRendition] {
+        try makeRenditions(widths: widths, formats: formats, quality: quality) { width in
+            var out: UnsafeMutablePointer<VipsImage>?
+            guard cvips_thumbnail_width(path, &out, Int32(width)) == 0, let out else {
+                throw VIPSError.fromVips()
+            }
+            return VIPSImage(pointer: out)
+        }.renditions
+    }
+
+    /// Build a rendition set from a decoder that loads the source at a given width.
+    /// Also reports how many times the decoded source was evaluated, which should
+    /// always be one.
+    internal static func makeRenditions(widths: [Int], formats: [VIPSImageFormat], quality: Int,
+                                        decode: (Int) throws -> VIPSImage) throws
+        -> (renditions: [VIPSRendition], decodes: Int) {
+        let targets = Set(widths).sorted(by: >)
+        guard let largest = targets.first, let smallest = targets.last, smallest > 0 else {
+            throw VIPSError("Rendition widths must be positive and non-empty")
+        }
+        guard !formats.isEmpty else { throw VIPSError("At least one rendition format is required") }
+
+        let decoded = try decode(largest)
+        let (renditions, evaluations) = try decoded.countingEvaluations { () throws -> [VIPSRendition] in
+            // Materialize each level so cascaded resizes and parallel encodes
+            // read finished pixels instead of re-running the pipeline above them
+            var levels: [(target: Int, image: VIPSImage)] = []
+            var previous = try decoded.copiedToMemory()
+            levels.append((largest, previous))
+            for target in targets.dropFirst() {
+                var out: UnsafeMutablePointer<VipsImage>?
+                guard cvips_thumbnail_image_width(previous.pointer, &out, Int32(target)) == 0, let out else {
+                    throw VIPSError.fromVips()
+                }
+                previous = try VIPSImage(pointer: out).copiedToMemory()
+                levels.append((target, previous))
+            }
+
+            let jobs = levels.flatMap { level in formats.map { (level: level, format: $0) } }
+            var results = [Result<Data, Error>?](repeating: nil, count: jobs.count)
+            results.withUnsafeMutableBufferPointer { slots in
+                DispatchQueue.concurrentPerform(iterations: jobs.count) { i in
+                    slots[i] = Result { try jobs[i].level.image.data(format: jobs[i].format, quality: quality) }
+                }
+            }
+
+            return try zip(jobs, results).map { job, result in
+                VIPSRendition(targetWidth: job.level.target, width: job.level.image.width,
+                              height: job.level.image.height, format: job.format, data: try result!.get())
+            }
+        }
+        return (renditions, evaluations)
+    }
+
+    // MARK: - Async
+
+    /// Generate a responsive image set from encoded image data, decoding the source only once.
+    /// The work is performed off the calling actor via `Task.detached`.
+    /// - Parameters:
+    ///   - data: The encoded source image
+    ///   - widths: The target widths. Heights follow the source aspect ratio.
+    ///   - formats: The formats to encode each width as (default is JPEG)
+    ///   - quality: The encoding quality (1-100, default is 85). Ignored for PNG and TIFF.
+    /// - Returns: One rendition per width and format, ordered from the largest width down
+    public static func renditions(fromData data: Data, widths: [Int], formats: [VIPSImageFormat] = [.jpeg],
+                                  quality: Int = 85) async throws -> [VIPSRendition] {
+        try await Task.detached {
+            try Self.renditions(fromData: data, widths: widths, formats: formats, quality: quality)
+        }.value
+    }
+
+    /// Generate a responsive image set from an image file, decoding the source only once.
+    /// The work is performed off the calling actor via `Task.detached`.
+    /// - Parameters:
+    ///   - path: The file path of the source image
+    ///   - widths: The target widths. Heights follow the source aspect ratio.
+    ///   - formats: The formats to encode each width as (default is JPEG)
+    ///   - quality: The encoding quality (1-100, default is 85). Ignored for PNG and TIFF.
+    /// - Returns: One rendition per width and format, ordered from the largest width down
+    public static func renditions(fromFile path: String, widths: [Int], formats: [VIPSImageFormat] = [.jpeg],
+                                  quality: Int = 85) async throws -> [VIPSRendition] {
+        try await Task.detached {
+            try Self.renditions(fromFile: path, widths: widths, formats: formats, quality: quality)
+        }.value
+    }
+}
@@ -89,8 +89,184 @@ extension VIPSImage {
         }
 
         guard result == 0, let buffer else { throw VIPSError.fromVips() }
-        defer { g_free(buffer) }
-        return Data(bytes: buffer, count: length)
+        // Adopt the libvips allocation rather than copying it
+        return Data(bytesNoCopy: buffer, count: length, deallocator: .custom { bytes, _ in g_free(bytes) })
+    }
+
+    // MARK: - Encoder Options
+
+    /// Save the image to a file with explicit encoder settings.
+    /// HEIF, AVIF, and GIF encoding are not supported (decode-only); attempting to save
+    /// in those formats will throw an error.
+    /// - Parameters:
+    ///   - path: The destination file path
+    ///   - format: The image format to encode as
+    ///   - options: The encoder settings, such as ``VIPSEncodeOptions/fastest`` or ``VIPSEncodeOptions/smallest``
+    public func write(toFile path: String, format: VIPSImageFormat, options: VIPSEncodeOptions) throws {
+        let format = try Self.saveFormat(format)
+        var options = options.cValue(for: format)
+        guard cvips_save_file(pointer, path, format, &options) == 0 else {
+            throw VIPSError.fromVips()
+        }
+    }
+
+    /// Export the image as encoded data with explicit encoder settings.
+    /// HEIF, AVIF, and GIF encoding are not supported (decode-only); attempting to export
+    /// in those formats will throw an error.
+    /// - Parameters:
+    ///   - format: The image format to encode as
+    ///   - options: The encoder settings, such as ``VIPSEncodeOptions/fastest`` or ``VIPSEncodeOptions/smallest``
+    /// - Returns: The encoded image data
+    public func data(format: VIPSImageFormat, options: VIPSEncodeOptions) throws -> Data {
+        let format = try Self.saveFormat(format)
+        var options = options.cValue(for: format)
+        var buffer: UnsafeMutableRawPointer?
+        var length: Int = 0
+        guard cvips_save_buffer(pointer, &buffer, &length, format, &options) == 0, let buffer else {
+            throw VIPSError.fromVips()
+        }
+        return Data(bytesNoCopy: buffer, count: length, deallocator: .custom { bytes, _ in g_free(bytes) })
+    }
+
+    /// The C shim's identifier for a format that can be encoded.
+    private static func saveFormat(_ format: VIPSImageFormat) throws -> CVIPSSaveFormat {
+        switch format {
+        case .jpeg:    return CVIPS_SAVE_JPEG
+        case .png:     return CVIPS_SAVE_PNG
+        case .webP:    return CVIPS_SAVE_WEBP
+        case .jxl:     return CVIPS_SAVE_JXL
+        case .tiff:    return CVIPS_SAVE_TIFF
+        case .heif:    throw VIPSError("HEIF encoding is not supported (decode-only)")
+        case .avif:    throw VIPSError("AVIF encoding is not supported (decode-only)")
+        case .gif:     throw VIPSError("GIF encoding is not supported (decode-only)")
+        case .unknown: throw VIPSError("Unknown format for export")
+        }
+    }
+
+    // MARK: - Streaming Export
+
+    /// Encode the image and pass the output to a closure in chunks as libvips produces it.
+    /// For JPEG, PNG, WebP, and JPEG-XL the complete encoded image is never held in memory,
+    /// which keeps peak memory low when writing very large images to a socket, hash, or
+    /// other stream. TIFF needs to seek while writing, so libvips encodes it into memory
+    /// first and passes it to `sink` once complete.
+    /// HEIF, AVIF, and GIF encoding are not supported (decode-only).
+    /// - Parameters:
+    ///   - format: The image format to encode as
+    ///   - quality: The encoding quality (1-100). Ignored for PNG, GIF, and TIFF formats. (Default is 85)
+    ///   - lossless: If true, encode losslessly. Only meaningful for WebP and JPEG-XL;
+    ///     silently ignored for other formats. (Default is false)
+    ///   - sink: Called with each chunk of encoded bytes, in order. The buffer is only valid
+    ///     for the duration of the call. Throwing from `sink` stops the encode and the error
+    ///     is rethrown.
+    public func write(format: VIPSImageFormat, quality: Int = 85, lossless: Bool = false,
+                      to sink: (UnsafeRawBufferPointer) throws -> Void) throws {
+        try withoutActuallyEscaping(sink) { sink in
+            let stream = StreamSink(sink)
+            let target = cvips_target_new_to_callback({ data, length, context in
+                Unmanaged<StreamSink>.fromOpaque(context!).takeUnretainedValue().write(data, length)
+            }, Unmanaged.passUnretained(stream).toOpaque())
+            guard let target else { throw VIPSError.fromVips() }
+            defer { g_object_unref(gpointer(target)) }
+
+            let result = try save(to: target, format: format, quality: quality, lossless: lossless)
+            if let error = stream.error {
+                vips_error_clear()
+                throw error
+            }
+            guard result == 0 else { throw VIPSError.fromVips() }
+        }
+    }
+
+    /// Encode the image with explicit encoder settings and pass the output to a closure
+    /// in chunks as libvips produces it.
+    /// HEIF, AVIF, and GIF encoding are not supported (decode-only).
+    /// - Parameters:
+    ///   - format: The image format to encode as
+    ///   - options: The encoder settings, such as ``VIPSEncodeOptions/fastest`` or ``VIPSEncodeOptions/smallest``
+    ///   - sink: Called with each chunk of encoded bytes, in order. The buffer is only valid
+    ///     for the duration of the call. Throwing from `sink` stops the encode and the error
+    ///     is rethrown.
+    public func write(format: VIPSImageFormat, options: VIPSEncodeOptions,
+                      to sink: (UnsafeRawBufferPointer) throws -> Void) throws {
+        let format = try Self.saveFormat(format)
+        var options = options.cValue(for: format)
+        try withoutActuallyEscaping(sink) { sink in
+            let stream = StreamSink(sink)
+            let target = cvips_target_new_to_callback({ data, length, context in
+                Unmanaged<StreamSink>.fromOpaque(context!).takeUnretainedValue().write(data, length)
+            }, Unmanaged.passUnretained(stream).toOpaque())
+            guard let target else { throw VIPSError.fromVips() }
+            defer { g_object_unref(gpointer(target)) }
+
+            let result = cvips_save_target(pointer, target, format, &options)
+            if let error = stream.error {
+                vips_error_clear()
+                throw error
+            }
+            guard result == 0 else { throw VIPSError.fromVips() }
+        }
+    }
+
+    /// Encode the image and write the output directly to an open file descriptor
+    /// (a file, pipe, or socket) as libvips produces it.
+    /// The descriptor is not closed.
+    /// HEIF, AVIF, and GIF encoding are not supported (decode-only).
+    /// - Parameters:
+    ///   - descriptor: An open, writable file descriptor
+    ///   - format: The image format to encode as
+    ///   - quality: The encoding quality (1-100). Ignored for PNG, GIF, and TIFF formats. (Default is 85)
+    ///   - lossless: If true, encode losslessly. Only meaningful for WebP and JPEG-XL;
+    ///     silently ignored for other formats. (Default is false)
+    public func write(toFileDescriptor descriptor: Int32, format: VIPSImageFormat,
+                      quality: Int = 85, lossless: Bool = false) throws {
+        guard let target = vips_target_new_to_descriptor(descriptor) else {
+            throw VIPSError.fromVips()
+        }
+        defer { g_object_unref(gpointer(target)) }
+        guard try save(to: target, format: format, quality: quality, lossless: lossless) == 0 else {
+            throw VIPSError.fromVips()
+        }
+    }
+
+    /// Encode the image with explicit encoder settings and write the output directly
+    /// to an open file descriptor. The descriptor is not closed.
+    /// HEIF, AVIF, and GIF encoding are not supported (decode-only).
+    /// - Parameters:
+    ///   - descriptor: An open, writable file descriptor
+    ///   - format: The image format to encode as
+    ///   - options: The encoder settings, such as ``VIPSEncodeOptions/fastest`` or ``VIPSEncodeOptions/smallest``
+    public func write(toFileDescriptor descriptor: Int32, format: VIPSImageFormat,
+                      options: VIPSEncodeOptions) throws {
+        let format = try Self.saveFormat(format)
+        var options = options.cValue(for: format)
+        guard let target = vips_target_new_to_descriptor(descriptor) else {
+            throw VIPSError.fromVips()
+        }
+        defer { g_object_unref(gpointer(target)) }
+        guard cvips_save_target(pointer, target, format, &options) == 0 else {
+            throw VIPSError.fromVips()
+        }
+    }
+
+    /// Run the saver for `format` against a libvips target.
+    private func save(to target: UnsafeMutablePointer<VipsTarget>, format: VIPSImageFormat,
+                      quality: Int, lossless: Bool) throws -> Int32 {
+        switch format {
+        case .jpeg:    return cvips_jpegsave_target(pointer, target, Int32(quality))
+        case .png:     return cvips_pngsave_target(pointer, target)
+        case .webP:
+            return lossless ? cvips_webpsave_target_lossless(pointer, target)
+                            : cvips_webpsave_target(pointer, target, Int32(quality))
+        case .jxl:
+            return lossless ? cvips_jxlsave_target_lossless(pointer, target)
+                            : cvips_jxlsave_target(pointer, target, Int32(quality))
+        case .tiff:    return cvips_tiffsave_target(pointer, target)
+        case .heif:    throw VIPSError("HEIF encoding is not supported (decode-only)")
+        case .avif:    throw VIPSError("AVIF encoding is not supported (decode-only)")
+        case .gif:     throw VIPSError("GIF encoding is not supported (decode-only)")
+        case .unknown: throw VIPSError("Unknown format for export")
+        }
     }
 
     // MARK: - Async
@@ -132,4 +308,84 @@ extension VIPSImage {
             try self.data(format: format, quality: quality, lossless: lossless)
         }.value
     }
+
+    /// Encode the image and pass the output to a closure in chunks as libvips produces it.
+    /// The work is performed off the calling actor via `Task.detached`.
+    /// - Parameters:
+    ///   - format: The image format to encode as
+    ///   - quality: The encoding quality (1-100). Ignored for PNG, GIF, and TIFF formats. (Default is 85)
+    ///   - lossless: If true, encode losslessly. Only meaningful for WebP and JPEG-XL;
+    ///     silently ignored for other formats. (Default is false)
+    ///   - sink: Called with each chunk of encoded bytes, in order. The buffer is only valid
+    ///     for the duration of the call.
+    public func write(format: VIPSImageFormat, quality: Int = 85, lossless: Bool = false,
+                      to sink: @escaping @Sendable (UnsafeRawBufferPointer) throws -> Void) async throws {
+        try await Task.detached {
+            try self.write(format: format, quality: quality, lossless: lossless, to: sink)
+        }.value
+    }
+
+    /// Encode the image and write the output directly to an open file descriptor.
+    /// The descriptor is not closed.
+    /// The work is performed off the calling actor via `Task.detached`.
+    /// - Parameters:
+    ///   - descriptor: An open, writable file descriptor
+    ///   - format: The image format to encode as
+    ///   - quality: The encoding quality (1-100). Ignored for PNG, GIF, and TIFF formats. (Default is 85)
+    ///   - lossless: If true, encode losslessly. Only meaningful for WebP and JPEG-XL;
+    ///     silently ignored for other formats. (Default is false)
+    public func write(toFileDescriptor descriptor: Int32, format: VIPSImageFormat,
+                      quality: Int = 85, lossless: Bool = false) async throws {
+        try await Task.detached {
+            try self.write(toFileDescriptor: descriptor, format: format, quality: quality, lossless: lossless)
+        }.value
+    }
+
+    /// Save the image to a file with explicit encoder settings.
+    /// The work is performed off the calling actor via `Task.detached`.
+    /// - Parameters:
+    ///   - path: The destination file path
+    ///   - format: The image format to encode as
+    ///   - options: The encoder settings, such as ``VIPSEncodeOptions/fastest`` or ``VIPSEncodeOptions/smallest``
+    public func write(toFile path: String, format: VIPSImageFormat, options: VIPSEncodeOptions) async throws {
+        try await Task.detached {
+            try self.write(toFile: path, format: format, options: options)
+        }.value
+    }
+
+    /// Export the image as encoded data with explicit encoder settings.
+    /// The work is performed off the calling actor via `Task.detached`.
+    /// - Parameters:
+    ///   - format: The image format to encode as
+    ///   - options: The encoder settings, such as ``VIPSEncodeOptions/fastest`` or ``VIPSEncodeOptions/smallest``
+    /// - Returns: The encoded image data
+    public func encoded(format: VIPSImageFormat, options: VIPSEncodeOptions) async throws -> Data {
+        try await Task.detached {
+            try self.data(format: format, options: options)
+        }.value
+    }
+}
+
+// MARK: - Streaming Sink
+
+/// Forwards chunks from a libvips custom target to a Swift closure, recording
+/// the first error it throws so the save can be aborted and the error rethrown.
+private final class StreamSink {
+    private let body: (UnsafeRawBufferPointer) throws -> Void
+    private(set) var error: Error?
+
+    init(_ body: @escaping (UnsafeRawBufferPointer) throws -> Void) {
+        self.body = body
+    }
+
+    func write(_ data: UnsafeRawPointer?, _ length: gint64) -> gint64 {
+        guard error == nil else { return -1 }
+        do {
+            try body(UnsafeRawBufferPointer(start: data, count: Int(length)))
+            return length
+        } catch {
+            self.error = error
+            return -1
+        }
+    }
 }
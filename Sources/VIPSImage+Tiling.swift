@@ -139,6 +139,86 @@ extension VIPSImage {
         return VIPSImage(pointer: copied)
     }
 
+    // MARK: - Pyramids
+
+    /// Write the image as a tiled, multi-resolution pyramid for zoomable viewers.
+    ///
+    /// Each level halves the one below it until the whole image fits in a single tile.
+    /// Tiles are cut and encoded on the libvips worker threads as rows of the image
+    /// arrive, so only a few rows of tiles per level are held in memory. Use
+    /// ``writePyramid(fromFile:toPath:layout:tileSize:overlap:format:quality:threads:)`` to
+    /// stream a source file that is too large to load.
+    ///
+    /// By default the save uses ``concurrency`` worker threads, which ``initialize()``
+    /// sets to 1. libvips has a single, process-wide worker count: a positive `threads`
+    /// raises it to at least that while the pyramid is written and restores it
+    /// afterwards, so other libvips work running at the same time may also use the
+    /// extra threads.
+    /// - Parameters:
+    ///   - path: The output path without an extension. DeepZoom writes `path.dzi` and a
+    ///     `path_files` directory; Zoomify and Google write a `path` directory.
+    ///   - layout: The directory layout (default is DeepZoom)
+    ///   - tileSize: The tile width and height in pixels (default is the layout's conventional size)
+    ///   - overlap: The pixels each tile shares with its neighbours (default is the layout's conventional overlap)
+    ///   - format: The tile format: JPEG, PNG, WebP, or JPEG XL (default is JPEG)
+    ///   - quality: The encoding quality (1-100). Ignored for PNG. (Default is 75)
+    ///   - threads: The minimum number of worker threads cutting and encoding tiles, or 0 to
+    ///     use ``concurrency`` unchanged (default is 0)
+    public func writePyramid(toPath path: String, layout: VIPSPyramidLayout = .deepZoom,
+                             tileSize: Int? = nil, overlap: Int? = nil,
+                             format: VIPSImageFormat = .jpeg, quality: Int = 75,
+                             threads: Int = 0) throws {
+        let tileSize = tileSize ?? layout.defaultTileSize
+        let overlap = overlap ?? layout.defaultOverlap
+        guard (1...8192).contains(tileSize) else {
+            throw VIPSError("Tile size \(tileSize) out of range [1, 8192]")
+        }
+        guard overlap >= 0, overlap < tileSize else {
+            throw VIPSError("Tile overlap \(overlap) out of range [0, \(tileSize))")
+        }
+        let suffix = try Self.pyramidTileSuffix(format: format, quality: quality)
+        guard cvips_dzsave(pointer, path, layout.vipsValue, Int32(tileSize), Int32(overlap), suffix,
+                           Int32(max(0, threads))) == 0 else {
+            throw VIPSError.fromVips()
+        }
+    }
+
+    /// Write an image file as a tiled, multi-resolution pyramid, streaming the source
+    /// from top to bottom so the full image is never resident in memory.
+    /// - Parameters:
+    ///   - sourcePath: The file path of the source image
+    ///   - path: The output path without an extension. DeepZoom writes `path.dzi` and a
+    ///     `path_files` directory; Zoomify and Google write a `path` directory.
+    ///   - layout: The directory layout (default is DeepZoom)
+    ///   - tileSize: The tile width and height in pixels (default is the layout's conventional size)
+    ///   - overlap: The pixels each tile shares with its neighbours (default is the layout's conventional overlap)
+    ///   - format: The tile format: JPEG, PNG, WebP, or JPEG XL (default is JPEG)
+    ///   - quality: The encoding quality (1-100). Ignored for PNG. (Default is 75)
+    ///   - threads: The minimum number of worker threads cutting and encoding tiles, or 0 to
+    ///     use ``concurrency`` unchanged (default is 0)
+    public static func writePyramid(fromFile sourcePath: String, toPath path: String,
+                                    layout: VIPSPyramidLayout = .deepZoom,
+                                    tileSize: Int? = nil, overlap: Int? = nil,
+                                    format: VIPSImageFormat = .jpeg, quality: Int = 75,
+                                    threads: Int = 0) throws {
+        try VIPSImage(contentsOfFileSequential: sourcePath)
+            .writePyramid(toPath: path, layout: layout, tileSize: tileSize, overlap: overlap,
+                          format: format, quality: quality, threads: threads)
+    }
+
+    /// The dzsave tile suffix for a format, with its save options.
+    private static func pyramidTileSuffix(format: VIPSImageFormat, quality: Int) throws -> String {
+        let quality = max(1, min(100, quality))
+        switch format {
+        case .jpeg: return ".jpg[Q=\(quality)]"
+        case .png:  return ".png"
+        case .webP: return ".webp[Q=\(quality)]"
+        case .jxl:  return ".jxl[Q=\(quality)]"
+        default:
+            throw VIPSError("Pyramid tiles must be JPEG, PNG, WebP, or JPEG XL")
+        }
+    }
+
     // MARK: - Async
 
     /// Extract a rectangular region from an image file without loading the entire
@@ -176,4 +256,51 @@ extension VIPSImage {
             try Self.extractRegion(fromData: data, x: x, y: y, width: width, height: height)
         }.value
     }
+
+    /// Write the image as a tiled, multi-resolution pyramid for zoomable viewers.
+    /// The work is performed off the calling actor via `Task.detached`.
+    /// - Parameters:
+    ///   - path: The output path without an extension. DeepZoom writes `path.dzi` and a
+    ///     `path_files` directory; Zoomify and Google write a `path` directory.
+    ///   - layout: The directory layout (default is DeepZoom)
+    ///   - tileSize: The tile width and height in pixels (default is the layout's conventional size)
+    ///   - overlap: The pixels each tile shares with its neighbours (default is the layout's conventional overlap)
+    ///   - format: The tile format: JPEG, PNG, WebP, or JPEG XL (default is JPEG)
+    ///   - quality: The encoding quality (1-100). Ignored for PNG. (Default is 75)
+    ///   - threads: The minimum number of worker threads cutting and encoding tiles, or 0 to
+    ///     use ``concurrency`` unchanged (default is 0)
+    public func writePyramid(toPath path: String, layout: VIPSPyramidLayout = .deepZoom,
+                             tileSize: Int? = nil, overlap: Int? = nil,
+                             format: VIPSImageFormat = .jpeg, quality: Int = 75,
+                             threads: Int = 0) async throws {
+        try await Task.detached {
+            try self.writePyramid(toPath: path, layout: layout, tileSize: tileSize, overlap: overlap,
+                                  format: format, quality: quality, threads: threads)
+        }.value
+    }
+
+    /// Write an image file as a tiled, multi-resolution pyramid, streaming the source
+    /// from top to bottom so the full image is never resident in memory.
+    /// The work is performed off the calling actor via `Task.detached`.
+    /// - Parameters:
+    ///   - sourcePath: The file path of the source image
+    ///   - path: The output path without an extension. DeepZoom writes `path.dzi` and a
+    ///     `path_files` directory; Zoomify and Google write a `path` directory.
+    ///   - layout: The directory layout (default is DeepZoom)
+    ///   - tileSize: The tile width and height in pixels (default is the layout's conventional size)
+    ///   - overlap: The pixels each tile shares with its neighbours (default is the layout's conventional overlap)
+    ///   - format: The tile format: JPEG, PNG, WebP, or JPEG XL (default is JPEG)
+    ///   - quality: The encoding quality (1-100). Ignored for PNG. (Default is 75)
+    ///   - threads: The minimum number of worker threads cutting and encoding tiles, or 0 to
+    ///     use ``concurrency`` unchanged (default is 0)
+    public static func writePyramid(fromFile sourcePath: String, toPath path: String,
+                                    layout: VIPSPyramidLayout = .deepZoom,
+                                    tileSize: Int? = nil, overlap: Int? = nil,
+                                    format: VIPSImageFormat = .jpeg, quality: Int = 75,
+                                    threads: Int = 0) async throws {
+        try await Task.detached {
+            try Self.writePyramid(fromFile: sourcePath, toPath: path, layout: layout, tileSize: tileSize,
+                                  overlap: overlap, format: format, quality: quality, threads: threads)
+        }.value
+    }
 }
@@ -79,7 +79,7 @@ public final class VIPSImage: @unchecked Sendable {
         vips_cache_set_max(100)
         vips_cache_set_max_mem(50 * 1024 * 1024) // 50MB
         vips_cache_set_max_files(10)
-        vips_concurrency_set(1)
+        cvips_concurrency_set(1)
     }
 
     /// Shut down the libvips library and release all associated resources.
@@ -115,27 +115,7 @@ public final class VIPSImage: @unchecked Sendable {
     /// Returns ``VIPSImageFormat/unknown`` if the format could not be determined.
     public var sourceFormat: VIPSImageFormat {
         guard let loader = loaderName else { return .unknown }
-        if loader.hasPrefix("jpeg") || loader.hasPrefix("jpg") {
-            return .jpeg
-        } else if loader.hasPrefix("png") {
-            return .png
-        } else if loader.hasPrefix("webp") {
-            return .webP
-        } else if loader.hasPrefix("heif") {
-            var compression: UnsafePointer<CChar>?
-            if vips_image_get_string(pointer, "heif-compression", &compression) == 0,
-               let compression, strcmp(compression, "av1") == 0 {
-                return .avif
-            }
-            return .heif
-        } else if loader.hasPrefix("jxl") {
-            return .jxl
-        } else if loader.hasPrefix("gif") {
-            return .gif
-        } else if loader.hasPrefix("tiff") {
-            return .tiff
-        }
-        return .unknown
+        return VIPSImageFormat(loader: loader, heifCompression: getString(named: "heif-compression"))
     }
 
     // MARK: - Cache
@@ -183,9 +163,12 @@ public final class VIPSImage: @unchecked Sendable {
 
     /// The number of worker threads used by libvips for internal parallelism.
     /// Set to 0 to auto-detect based on available CPU cores.
+    ///
+    /// A pyramid save given more `threads` raises the worker count while it runs.
+    /// This property reports and sets the value restored afterwards.
     public static var concurrency: Int {
-        get { Int(vips_concurrency_get()) }
-        set { vips_concurrency_set(Int32(newValue)) }
+        get { Int(cvips_concurrency_get()) }
+        set { cvips_concurrency_set(Int32(newValue)) }
     }
 
     // MARK: - Instance Memory Management
@@ -228,14 +211,145 @@ public final class VIPSImage: @unchecked Sendable {
         public let bands: Int
     }
 
-    /// Provides zero-copy access to the image's raw pixel data within a closure.
+    /// Provides access to the image's raw pixel data within a closure.
     ///
     /// The pixel data is converted to 8-bit unsigned sRGB format before being passed
-    /// to the closure. The ``PixelBuffer`` is only valid within the closure's scope.
+    /// to the closure. If the image is already held in memory in that format, its
+    /// pixels are handed out directly without copying; otherwise the image is
+    /// rendered into a temporary buffer. The ``PixelBuffer`` is only valid within
+    /// the closure's scope.
+    ///
+    /// To process very large images without holding every pixel at once, use
+    /// ``forEachPixelStripe(rowsPerStripe:_:)`` instead.
     ///
     /// - Parameter body: A closure that receives a ``PixelBuffer`` with the pixel data
     /// - Returns: The value returned by the closure
     public func withPixelData<T>(_ body: (PixelBuffer) throws -> T) throws -> T {
+        let prepared = try pixelAccessImage()
+
+        let w = Int(vips_image_get_width(prepared))
+        let h = Int(vips_image_get_height(prepared))
+        let b = Int(vips_image_get_bands(prepared))
+        let bytesPerRow = w * b
+
+        // Fast path: the pixels are already resident in the right format
+        if let resident = cvips_image_peek_memory(prepared) {
+            defer { g_object_unref(gpointer(prepared)) }
+            let buffer = PixelBuffer(data: resident.assumingMemoryBound(to: UInt8.self),
+                                     width: w, height: h, bytesPerRow: bytesPerRow, bands: b)
+            return try body(buffer)
+        }
+
+        var dataSize: Int = 0
+        guard let data = vips_image_write_to_memory(prepared, &dataSize) else {
+            g_object_unref(gpointer(prepared))
+            throw VIPSError.fromVips()
+        }
+        g_object_unref(gpointer(prepared))
+
+        defer { g_free(data) }
+        let buffer = PixelBuffer(data: data.assumingMemoryBound(to: UInt8.self),
+                                 width: w, height: h, bytesPerRow: bytesPerRow, bands: b)
+        return try body(buffer)
+    }
+
+    /// Visits the image's raw pixel data one horizontal stripe at a time, from top to bottom.
+    ///
+    /// The pixel data is converted to 8-bit unsigned sRGB format, as with ``withPixelData(_:)``,
+    /// but only one stripe of rows is computed and held in memory at a time. This keeps
+    /// peak memory proportional to the stripe size rather than the whole image.
+    ///
+    /// Each ``PixelBuffer`` covers the full image width and is only valid for the duration
+    /// of that call. Its ``PixelBuffer/bytesPerRow`` may be larger than `width * bands`.
+    ///
+    /// - Parameters:
+    ///   - rowsPerStripe: The number of rows in each stripe (default is 64). The last
+    ///     stripe may be shorter.
+    ///   - body: A closure that receives a ``PixelBuffer`` for the stripe and the
+    ///     y-coordinate of its first row
+    public func forEachPixelStripe(rowsPerStripe: Int = 64,
+                                   _ body: (PixelBuffer, Int) throws -> Void) throws {
+        guard rowsPerStripe > 0 else { throw VIPSError("Stripe height must be positive") }
+
+        let prepared = try pixelAccessImage()
+        defer { g_object_unref(gpointer(prepared)) }
+
+        guard let region = vips_region_new(prepared) else {
+            throw VIPSError.fromVips()
+        }
+        defer { g_object_unref(gpointer(region)) }
+
+        let w = Int(vips_image_get_width(prepared))
+        let h = Int(vips_image_get_height(prepared))
+        let b = Int(vips_image_get_bands(prepared))
+
+        var y = 0
+        while y < h {
+            let rows = min(rowsPerStripe, h - y)
+            var data: UnsafeMutablePointer<VipsPel>?
+            var stride: Int = 0
+            guard cvips_region_prepare_area(region, 0, Int32(y), Int32(w), Int32(rows), &data, &stride) == 0,
+                  let data else {
+                throw VIPSError.fromVips()
+            }
+            let buffer = PixelBuffer(data: UnsafePointer(data), width: w, height: rows,
+                                     bytesPerRow: stride, bands: b)
+            try body(buffer, y)
+            y += rows
+        }
+    }
+
+    /// Render the image into caller-provided memory, such as a texture staging buffer
+    /// or a reused frame, instead of allocating a new one.
+    ///
+    /// Strips of rows are computed on the libvips worker threads, of which there are
+    /// ``concurrency`` (1 unless raised), and written directly into `buffer` in order. When `interpretation` is given the image is first converted to that colour
+    /// space. Samples are then cast to `format`, clamping to its range without rescaling,
+    /// so convert to `.rgb16` or `.grey16` before writing `.uint16` to fill the 16-bit range.
+    ///
+    /// - Parameters:
+    ///   - buffer: The destination, covering `bytesPerRow * (height - 1)` bytes plus one
+    ///     unpadded row
+    ///   - bytesPerRow: The distance between the starts of consecutive rows, in bytes
+    ///     (default is `width * bands * format.bytesPerSample`)
+    ///   - format: The sample format to write (default is `.uint8`)
+    ///   - interpretation: The colour space to convert to first, or nil to write the
+    ///     image's bands as they are (default is nil)
+    public func write(into buffer: UnsafeMutableRawBufferPointer, bytesPerRow: Int? = nil,
+                      format: VIPSPixelFormat = .uint8, interpretation: VIPSInterpretation? = nil) throws {
+        var prepared = pointer
+        g_object_ref(gpointer(prepared))
+        defer { g_object_unref(gpointer(prepared)) }
+
+        if let interpretation, vips_image_get_interpretation(prepared) != interpretation.vipsValue {
+            var converted: UnsafeMutablePointer<VipsImage>?
+            guard cvips_colourspace(prepared, &converted, interpretation.vipsValue) == 0,
+                  let converted else { throw VIPSError.fromVips() }
+            g_object_unref(gpointer(prepared))
+            prepared = converted
+        }
+        if vips_image_get_format(prepared) != format.vipsValue {
+            var cast: UnsafeMutablePointer<VipsImage>?
+            guard cvips_cast(prepared, &cast, format.vipsValue) == 0, let cast else { throw VIPSError.fromVips() }
+            g_object_unref(gpointer(prepared))
+            prepared = cast
+        }
+
+        let rowBytes = Int(vips_image_get_width(prepared)) * Int(vips_image_get_bands(prepared)) * format.bytesPerSample
+        let height = Int(vips_image_get_height(prepared))
+        let stride = bytesPerRow ?? rowBytes
+        guard stride >= rowBytes else { throw VIPSError("bytesPerRow is smaller than a row of pixels") }
+        guard let base = buffer.baseAddress, buffer.count >= stride * (height - 1) + rowBytes else {
+            throw VIPSError("Buffer is too small for the image")
+        }
+        guard cvips_image_write_to_memory_strided(prepared, base, stride, format == .float16 ? 1 : 0) == 0 else {
+            throw VIPSError.fromVips()
+        }
+    }
+
+    /// Create a new reference to this image converted to 8-bit sRGB (or grayscale)
+    /// for raw pixel access. The caller must release the returned reference.
+    internal func pixelAccessImage() throws -> UnsafeMutablePointer<VipsImage> {
         var prepared: UnsafeMutablePointer<VipsImage>
 
         let interpretation = vips_image_get_interpretation(pointer)
@@ -260,23 +374,7 @@ public final class VIPSImage: @unchecked Sendable {
             g_object_unref(gpointer(prepared))
             prepared = cast
         }
-
-        let w = Int(vips_image_get_width(prepared))
-        let h = Int(vips_image_get_height(prepared))
-        let b = Int(vips_image_get_bands(prepared))
-        let bytesPerRow = w * b
-
-        var dataSize: Int = 0
-        guard let data = vips_image_write_to_memory(prepared, &dataSize) else {
-            g_object_unref(gpointer(prepared))
-            throw VIPSError.fromVips()
-        }
-        g_object_unref(gpointer(prepared))
-
-        defer { g_free(data) }
-        let buffer = PixelBuffer(data: data.assumingMemoryBound(to: UInt8.self),
-                                 width: w, height: h, bytesPerRow: bytesPerRow, bands: b)
-        return try body(buffer)
+        return prepared
     }
 
 }
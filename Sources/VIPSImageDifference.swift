@@ -0,0 +1,21 @@
+import CoreGraphics
+
+/// The tiles that differ between two images, as found by
+/// ``VIPSImage/difference(from:tileSize:tolerance:maxChangedTiles:)``.
+public struct VIPSImageDifference: Sendable {
+    /// The changed tiles, ordered top to bottom then left to right. Edge tiles
+    /// are clipped to the image bounds.
+    public let changedTiles: [CGRect]
+    /// Whether the comparison stopped early because more tiles changed than the
+    /// limit allowed. When `true`, ``changedTiles`` holds only the tiles found
+    /// before stopping.
+    public let exceededLimit: Bool
+
+    /// Whether no tile differed beyond the tolerance.
+    public var isIdentical: Bool { changedTiles.isEmpty }
+
+    /// The smallest rectangle containing every changed tile, or `nil` if none changed.
+    public var boundingBox: CGRect? {
+        changedTiles.isEmpty ? nil : changedTiles.dropFirst().reduce(changedTiles[0]) { $0.union($1) }
+    }
+}
@@ -48,4 +48,30 @@ public enum VIPSImageFormat: Int, Sendable {
         case .tiff:    return "tif"
         }
     }
+
+    /// The format read by a libvips loader, identified by its nickname
+    /// (e.g. `"jpegload"` or `"pngload_buffer"`).
+    /// - Parameters:
+    ///   - loader: The loader nickname
+    ///   - heifCompression: The image's `heif-compression` metadata. Only evaluated for
+    ///     HEIF loaders, which report AVIF when the compression is `"av1"`.
+    internal init(loader: String, heifCompression: @autoclosure () -> String?) {
+        if loader.hasPrefix("jpeg") || loader.hasPrefix("jpg") {
+            self = .jpeg
+        } else if loader.hasPrefix("png") {
+            self = .png
+        } else if loader.hasPrefix("webp") {
+            self = .webP
+        } else if loader.hasPrefix("heif") {
+            self = heifCompression() == "av1" ? .avif : .heif
+        } else if loader.hasPrefix("jxl") {
+            self = .jxl
+        } else if loader.hasPrefix("gif") {
+            self = .gif
+        } else if loader.hasPrefix("tiff") {
+            self = .tiff
+        } else {
+            self = .unknown
+        }
+    }
 }
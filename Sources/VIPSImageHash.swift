@@ -0,0 +1,189 @@
+import Foundation
+internal import vips
+internal import CVIPS
+
+/// A 64-bit perceptual hash of an image's appearance.
+///
+/// Visually similar images have hashes that differ in few bits, so the Hamming
+/// ``distance(to:)`` between two hashes estimates how alike the images look,
+/// independent of size, format, or compression. As a rough guide, distances up
+/// to 5 indicate near-duplicates and above 10 indicate different images.
+///
+/// Hashes are only comparable with hashes from the same ``Algorithm``. For large
+/// collections, store the raw ``value`` and search it with
+/// ``distances(from:to:)`` or ``indices(of:within:of:)``.
+public struct VIPSImageHash: Hashable, Sendable, CustomStringConvertible {
+
+    /// How a perceptual hash is computed.
+    public enum Algorithm: Int, Sendable {
+        /// Average hash: each bit records whether a cell of an 8 × 8 grayscale grid
+        /// is brighter than the grid's mean. Fastest, but sensitive to gamma and
+        /// contrast changes.
+        case average = 0
+        /// Difference hash: each bit records whether brightness falls between
+        /// horizontally adjacent cells of a 9 × 8 grid. Fast and robust to
+        /// brightness and contrast changes.
+        case difference
+        /// Perceptual hash: each bit records whether one of the lowest 8 × 8 frequencies
+        /// of a 32 × 32 discrete cosine transform is above their median. The most
+        /// robust to resizing, compression, and small edits.
+        case perceptual
+
+        /// The corresponding `CVIPSHashKind` value.
+        internal var cValue: CVIPSHashKind {
+            CVIPSHashKind(rawValue: UInt32(rawValue))
+        }
+    }
+
+    /// The algorithm that produced this hash.
+    public let algorithm: Algorithm
+
+    /// The 64 hash bits.
+    public let value: UInt64
+
+    /// Create a hash from a previously stored value.
+    /// - Parameters:
+    ///   - value: The 64 hash bits
+    ///   - algorithm: The algorithm that produced them
+    public init(value: UInt64, algorithm: Algorithm) {
+        self.value = value
+        self.algorithm = algorithm
+    }
+
+    /// The number of bits that differ from another hash, from 0 (identical) to 64.
+    /// - Parameter other: A hash produced by the same algorithm
+    /// - Returns: The Hamming distance between the two hashes
+    public func distance(to other: VIPSImageHash) -> Int {
+        (value ^ other.value).nonzeroBitCount
+    }
+
+    /// The hash as 16 hexadecimal digits.
+    public var description: String {
+        let hex = String(value, radix: 16)
+        return String(repeating: "0", count: 16 - hex.count) + hex
+    }
+
+    // MARK: - Batch Comparison
+
+    /// Compute the Hamming distance from one hash value to each of many.
+    /// The comparison runs as a single native loop over the array.
+    /// - Parameters:
+    ///   - query: The hash value to compare against
+    ///   - hashes: The hash values to compare
+    /// - Returns: The distance to each hash, in order. Distances never exceed 64.
+    public static func distances(from query: UInt64, to hashes: [UInt64]) -> [UInt8] {
+        [UInt8](unsafeUninitializedCapacity: hashes.count) { buffer, count in
+            hashes.withUnsafeBufferPointer { hashes in
+                cvips_hamming_distances(query, hashes.baseAddress, hashes.count, buffer.baseAddress)
+            }
+            count = hashes.count
+        }
+    }
+
+    /// Find the hash values within a Hamming distance of a query.
+    /// The comparison runs as a single native loop over the array.
+    /// - Parameters:
+    ///   - hashes: The hash values to search
+    ///   - maxDistance: The largest distance that counts as a match
+    ///   - query: The hash value to compare against
+    /// - Returns: The indices of the matching hashes, in ascending order
+    public static func indices(of hashes: [UInt64], within maxDistance: Int, of query: UInt64) -> [Int] {
+        var indices = [Int](repeating: 0, count: hashes.count)
+        let found = hashes.withUnsafeBufferPointer { hashes in
+            indices.withUnsafeMutableBufferPointer { indices in
+                cvips_hamming_within(query, hashes.baseAddress, hashes.count, Int32(clamping: maxDistance),
+                                     indices.baseAddress)
+            }
+        }
+        indices.removeSubrange(found..<indices.count)
+        return indices
+    }
+}
+
+// MARK: - Hashing
+
+extension VIPSImage {
+
+    /// The size of the shrink-on-load thumbnail that hashes are computed from.
+    /// Comfortably above the largest (32 × 32) hash grid.
+    private static let hashThumbnailSize = 128
+
+    /// Compute a perceptual hash of the image.
+    ///
+    /// Hashing a large image reads every pixel; prefer
+    /// ``perceptualHash(fromFile:algorithm:)`` or ``perceptualHash(fromData:algorithm:)``,
+    /// which decode only a small thumbnail.
+    /// - Parameter algorithm: The hash algorithm (default is ``VIPSImageHash/Algorithm/difference``)
+    /// - Returns: The image's hash
+    public func perceptualHash(algorithm: VIPSImageHash.Algorithm = .difference) throws -> VIPSImageHash {
+        var value: UInt64 = 0
+        guard cvips_perceptual_hash(pointer, algorithm.cValue, &value) == 0 else {
+            throw VIPSError.fromVips()
+        }
+        return VIPSImageHash(value: value, algorithm: algorithm)
+    }
+
+    /// Compute a perceptual hash of an image file, decoding only a small
+    /// shrink-on-load thumbnail.
+    /// - Parameters:
+    ///   - path: The file path of the image
+    ///   - algorithm: The hash algorithm (default is ``VIPSImageHash/Algorithm/difference``)
+    /// - Returns: The image's hash
+    public static func perceptualHash(fromFile path: String,
+                                      algorithm: VIPSImageHash.Algorithm = .difference) throws -> VIPSImageHash {
+        try thumbnail(fromFile: path, width: hashThumbnailSize, height: hashThumbnailSize)
+            .perceptualHash(algorithm: algorithm)
+    }
+
+    /// Compute a perceptual hash of encoded image data, decoding only a small
+    /// shrink-on-load thumbnail.
+    /// - Parameters:
+    ///   - data: The encoded image data
+    ///   - algorithm: The hash algorithm (default is ``VIPSImageHash/Algorithm/difference``)
+    /// - Returns: The image's hash
+    public static func perceptualHash(fromData data: Data,
+                                      algorithm: VIPSImageHash.Algorithm = .difference) throws -> VIPSImageHash {
+        try thumbnail(fromData: data, width: hashThumbnailSize, height: hashThumbnailSize)
+            .perceptualHash(algorithm: algorithm)
+    }
+
+    // MARK: - Async
+
+    /// Compute a perceptual hash of the image.
+    /// The work is performed off the calling actor via `Task.detached`.
+    /// - Parameter algorithm: The hash algorithm (default is ``VIPSImageHash/Algorithm/difference``)
+    /// - Returns: The image's hash
+    public func perceptualHash(algorithm: VIPSImageHash.Algorithm = .difference) async throws -> VIPSImageHash {
+        try await Task.detached {
+            try self.perceptualHash(algorithm: algorithm)
+        }.value
+    }
+
+    /// Compute a perceptual hash of an image file, decoding only a small
+    /// shrink-on-load thumbnail.
+    /// The work is performed off the calling actor via `Task.detached`.
+    /// - Parameters:
+    ///   - path: The file path of the image
+    ///   - algorithm: The hash algorithm (default is ``VIPSImageHash/Algorithm/difference``)
+    /// - Returns: The image's hash
+    public static func perceptualHash(fromFile path: String,
+                                      algorithm: VIPSImageHash.Algorithm = .difference) async throws -> VIPSImageHash {
+        try await Task.detached {
+            try Self.perceptualHash(fromFile: path, algorithm: algorithm)
+        }.value
+    }
+
+    /// Compute a perceptual hash of encoded image data, decoding only a small
+    /// shrink-on-load thumbnail.
+    /// The work is performed off the calling actor via `Task.detached`.
+    /// - Parameters:
+    ///   - data: The encoded image data
+    ///   - algorithm: The hash algorithm (default is ``VIPSImageHash/Algorithm/difference``)
+    /// - Returns: The image's hash
+    public static func perceptualHash(fromData data: Data,
+                                      algorithm: VIPSImageHash.Algorithm = .difference) async throws -> VIPSImageHash {
+        try await Task.detached {
+            try Self.perceptualHash(fromData: data, algorithm: algorithm)
+        }.value
+    }
+}
@@ -0,0 +1,15 @@
+/// Header information read from an encoded image without decoding any pixels.
+public struct VIPSImageHeader: Sendable, Equatable {
+    /// The width of the image in pixels
+    public let width: Int
+    /// The height of the image in pixels (of the first page, for multi-page images)
+    public let height: Int
+    /// The number of bands (channels) per pixel
+    public let bands: Int
+    /// The number of pages, or 1 for single-page images
+    public let pageCount: Int
+    /// The EXIF orientation tag (1–8), or `nil` if not present
+    public let orientation: Int?
+    /// The detected encoded format
+    public let format: VIPSImageFormat
+}
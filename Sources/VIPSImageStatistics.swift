@@ -9,4 +9,20 @@ public struct VIPSImageStatistics: Sendable {
     public let mean: Double
     /// The standard deviation of pixel values across all bands
     public let standardDeviation: Double
+    /// The same measurements for each individual band, in band order
+    public let bands: [Band]
+
+    /// Statistical measurements for a single band of an image.
+    public struct Band: Sendable {
+        /// The minimum pixel value in this band
+        public let min: Double
+        /// The maximum pixel value in this band
+        public let max: Double
+        /// The sum of all pixel values in this band
+        public let sum: Double
+        /// The mean (average) pixel value in this band
+        public let mean: Double
+        /// The standard deviation of pixel values in this band
+        public let standardDeviation: Double
+    }
 }
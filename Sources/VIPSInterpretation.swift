@@ -0,0 +1,46 @@
+internal import vips
+
+/// How libvips should interpret the bands of an image, which decides what
+/// colour conversions do with it. Used when importing or exporting raw pixel buffers.
+public enum VIPSInterpretation: Int, Sendable {
+    /// Bands with no colour meaning
+    case multiband = 0
+    /// Grayscale in the 8-bit range (0-255), for float samples too, optionally with alpha
+    case bw
+    /// Grayscale, 16-bit range (0-65535), optionally with alpha
+    case grey16
+    /// Gamma-encoded sRGB, 8-bit range (0-255), optionally with alpha
+    case sRGB
+    /// Gamma-encoded sRGB, 16-bit range (0-65535), optionally with alpha
+    case rgb16
+    /// Linear-light sRGB primaries, 0-1 range, as produced by HDR and float pipelines
+    case scRGB
+    /// CMYK, 8 or 16-bit range
+    case cmyk
+    /// CIE Lab as floats, L in 0-100
+    case lab
+
+    /// The corresponding libvips `VipsInterpretation` value.
+    internal var vipsValue: VipsInterpretation {
+        switch self {
+        case .multiband: return VIPS_INTERPRETATION_MULTIBAND
+        case .bw:        return VIPS_INTERPRETATION_B_W
+        case .grey16:    return VIPS_INTERPRETATION_GREY16
+        case .sRGB:      return VIPS_INTERPRETATION_sRGB
+        case .rgb16:     return VIPS_INTERPRETATION_RGB16
+        case .scRGB:     return VIPS_INTERPRETATION_scRGB
+        case .cmyk:      return VIPS_INTERPRETATION_CMYK
+        case .lab:       return VIPS_INTERPRETATION_LAB
+        }
+    }
+
+    /// The interpretation assumed for raw samples when none is given: grayscale
+    /// for one or two bands, colour otherwise, in the range the format implies.
+    internal static func `default`(bands: Int, format: VIPSPixelFormat) -> VIPSInterpretation {
+        switch format {
+        case .uint8:             return bands <= 2 ? .bw : .sRGB
+        case .uint16:            return bands <= 2 ? .grey16 : .rgb16
+        case .float16, .float32: return bands <= 2 ? .bw : .scRGB
+        }
+    }
+}
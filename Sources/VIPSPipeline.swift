@@ -0,0 +1,281 @@
+import Foundation
+import CoreGraphics
+internal import vips
+internal import CVIPS
+
+/// A reusable sequence of image operations that is applied as a single libvips graph.
+///
+/// Chaining ``VIPSImage`` methods creates a Swift object and a retain/release pair for
+/// every intermediate step. A pipeline instead records its steps up front and builds
+/// the whole libvips graph in one native call, so only the final image is wrapped.
+/// While recording, adjacent brightness and contrast adjustments are folded into a
+/// single affine operation, and steps that would not change an image (a crop covering
+/// the whole image, flattening an image without alpha, and so on) are skipped when
+/// the pipeline runs.
+///
+/// Pipelines are immutable values: each builder method returns a new pipeline, so one
+/// can be built once and shared freely between threads and requests.
+///
+/// ```swift
+/// let pipeline = VIPSPipeline()
+///     .resizeToFit(width: 800, height: 800)
+///     .adjust(brightness: 0.05, contrast: 1.1)
+///     .sharpened(sigma: 0.8)
+///     .flatten(background: .white)
+///     .encode(format: .jpeg, quality: 80)
+///
+/// let data = try pipeline.data(from: image)
+/// ```
+public struct VIPSPipeline: Sendable {
+
+    /// A single recorded operation.
+    internal enum Step: Sendable, Equatable {
+        case crop(x: Int, y: Int, width: Int, height: Int)
+        case resize(hScale: Double, vScale: Double, kernel: VIPSResizeKernel)
+        case resizeToFit(width: Int, height: Int)
+        /// `value * a + b` on every color band
+        case linear(a: Double, b: Double)
+        case saturation(Double)
+        case gamma(Double)
+        case sharpen(sigma: Double)
+        case flatten(VIPSColor)
+        case grayscale
+    }
+
+    /// The output encoding applied by ``data(from:)``.
+    public struct Encoding: Sendable {
+        /// The format to encode as
+        public var format: VIPSImageFormat
+        /// The encoding quality (1-100). Ignored for PNG and TIFF.
+        public var quality: Int
+        /// Whether to encode losslessly. Only meaningful for WebP and JPEG-XL.
+        public var lossless: Bool
+    }
+
+    /// The recorded steps, after adjacent steps have been merged.
+    internal private(set) var steps: [Step] = []
+
+    /// The output encoding, if ``encode(format:quality:lossless:)`` has been called.
+    public private(set) var encoding: Encoding?
+
+    /// Create an empty pipeline.
+    public init() {}
+
+    // MARK: - Building
+
+    /// Crop to a rectangular region.
+    /// - Parameters:
+    ///   - x: The left edge of the crop region in pixels
+    ///   - y: The top edge of the crop region in pixels
+    ///   - width: The width of the crop region in pixels
+    ///   - height: The height of the crop region in pixels
+    /// - Returns: A pipeline with the crop appended
+    public func crop(x: Int, y: Int, width: Int, height: Int) -> VIPSPipeline {
+        appending(.crop(x: x, y: y, width: width, height: height))
+    }
+
+    /// Crop to a rectangular region.
+    /// - Parameter rect: The region to crop, in pixels
+    /// - Returns: A pipeline with the crop appended
+    public func crop(_ rect: CGRect) -> VIPSPipeline {
+        crop(x: Int(rect.origin.x), y: Int(rect.origin.y), width: Int(rect.width), height: Int(rect.height))
+    }
+
+    /// Resize by a uniform scale factor.
+    /// - Parameters:
+    ///   - scale: The scale factor (e.g. 0.5 for half size)
+    ///   - kernel: The interpolation kernel (default is Lanczos3)
+    /// - Returns: A pipeline with the resize appended
+    public func resize(scale: Double, kernel: VIPSResizeKernel = .lanczos3) -> VIPSPipeline {
+        appending(.resize(hScale: scale, vScale: scale, kernel: kernel))
+    }
+
+    /// Resize to fit within the given dimensions while preserving the aspect ratio.
+    /// - Parameters:
+    ///   - width: The maximum width in pixels
+    ///   - height: The maximum height in pixels
+    /// - Returns: A pipeline with the resize appended
+    public func resizeToFit(width: Int, height: Int) -> VIPSPipeline {
+        appending(.resizeToFit(width: width, height: height))
+    }
+
+    /// Adjust brightness by applying a uniform offset to all color channels.
+    /// - Parameter brightness: The brightness adjustment value (-1.0 to 1.0, where 0 is unchanged)
+    /// - Returns: A pipeline with the adjustment appended
+    public func adjustBrightness(_ brightness: Double) -> VIPSPipeline {
+        appending(.linear(a: 1.0, b: brightness * 255.0))
+    }
+
+    /// Adjust contrast by scaling pixel values around the midpoint.
+    /// - Parameter contrast: The contrast multiplier (0.5 to 2.0, where 1.0 is unchanged)
+    /// - Returns: A pipeline with the adjustment appended
+    public func adjustContrast(_ contrast: Double) -> VIPSPipeline {
+        appending(.linear(a: contrast, b: 127.5 * (1.0 - contrast)))
+    }
+
+    /// Adjust color saturation by scaling chroma in LCh space.
+    /// - Parameter saturation: The saturation multiplier (0 = grayscale, 1.0 = unchanged, >1.0 = more saturated)
+    /// - Returns: A pipeline with the adjustment appended
+    public func adjustSaturation(_ saturation: Double) -> VIPSPipeline {
+        appending(.saturation(saturation))
+    }
+
+    /// Adjust brightness, contrast, and saturation.
+    /// - Parameters:
+    ///   - brightness: The brightness adjustment (-1.0 to 1.0, where 0 is unchanged)
+    ///   - contrast: The contrast multiplier (0.5 to 2.0, where 1.0 is unchanged)
+    ///   - saturation: The saturation multiplier (0 = grayscale, 1.0 = unchanged, >1.0 = more saturated)
+    /// - Returns: A pipeline with the adjustments appended
+    public func adjust(brightness: Double = 0, contrast: Double = 1.0, saturation: Double = 1.0) -> VIPSPipeline {
+        adjustContrast(contrast).adjustBrightness(brightness).adjustSaturation(saturation)
+    }
+
+    /// Adjust the gamma curve. Values less than 1.0 lighten the image,
+    /// while values greater than 1.0 darken it.
+    /// - Parameter gamma: The gamma exponent value
+    /// - Returns: A pipeline with the adjustment appended
+    public func adjustGamma(_ gamma: Double) -> VIPSPipeline {
+        appending(.gamma(1.0 / gamma))
+    }
+
+    /// Sharpen using an unsharp mask.
+    /// - Parameter sigma: The standard deviation of the Gaussian used for the mask
+    /// - Returns: A pipeline with the sharpen appended
+    public func sharpened(sigma: Double) -> VIPSPipeline {
+        appending(.sharpen(sigma: sigma))
+    }
+
+    /// Flatten any alpha channel against a solid background color.
+    /// - Parameter background: The background color to flatten against
+    /// - Returns: A pipeline with the flatten appended
+    public func flatten(background: VIPSColor) -> VIPSPipeline {
+        appending(.flatten(background))
+    }
+
+    /// Convert to grayscale (single-band luminance).
+    /// - Returns: A pipeline with the conversion appended
+    public func grayscaled() -> VIPSPipeline {
+        appending(.grayscale)
+    }
+
+    /// Set the encoding used by ``data(from:)``.
+    /// - Parameters:
+    ///   - format: The format to encode as
+    ///   - quality: The encoding quality (1-100, default is 85)
+    ///   - lossless: Whether to encode losslessly (default is false)
+    /// - Returns: A pipeline with the encoding set
+    public func encode(format: VIPSImageFormat, quality: Int = 85, lossless: Bool = false) -> VIPSPipeline {
+        var copy = self
+        copy.encoding = Encoding(format: format, quality: quality, lossless: lossless)
+        return copy
+    }
+
+    /// Append a step, folding it into the previous step where the two compose.
+    private func appending(_ step: Step) -> VIPSPipeline {
+        var copy = self
+        switch (copy.steps.last, step) {
+        case let (.linear(a1, b1)?, .linear(a2, b2)):
+            // a2 * (a1 * x + b1) + b2
+            copy.steps[copy.steps.count - 1] = .linear(a: a1 * a2, b: a2 * b1 + b2)
+        case let (.saturation(s1)?, .saturation(s2)):
+            copy.steps[copy.steps.count - 1] = .saturation(s1 * s2)
+        default:
+            copy.steps.append(step)
+        }
+        if let last = copy.steps.last, last.isIdentity {
+            copy.steps.removeLast()
+        }
+        return copy
+    }
+
+    // MARK: - Running
+
+    /// Apply every step to an image.
+    /// - Parameter image: The source image
+    /// - Returns: The processed image
+    public func apply(to image: VIPSImage) throws -> VIPSImage {
+        let lowered = steps.map(\.lowered)
+        var out: UnsafeMutablePointer<VipsImage>?
+        let result = lowered.withUnsafeBufferPointer { buffer in
+            cvips_pipeline_run(image.pointer, buffer.baseAddress, Int32(buffer.count), &out)
+        }
+        guard result == 0, let out else { throw VIPSError.fromVips() }
+        return VIPSImage(pointer: out)
+    }
+
+    /// Apply every step to an image and encode the result.
+    /// The pipeline must have an encoding set with ``encode(format:quality:lossless:)``.
+    /// - Parameter image: The source image
+    /// - Returns: The encoded image data
+    public func data(from image: VIPSImage) throws -> Data {
+        guard let encoding else {
+            throw VIPSError("Pipeline has no encoding; call encode(format:quality:lossless:) first")
+        }
+        return try apply(to: image).data(format: encoding.format, quality: encoding.quality,
+                                         lossless: encoding.lossless)
+    }
+
+    // MARK: - Async
+
+    /// Apply every step to an image.
+    /// The work is performed off the calling actor via `Task.detached`.
+    /// - Parameter image: The source image
+    /// - Returns: The processed image
+    public func apply(to image: VIPSImage) async throws -> VIPSImage {
+        try await Task.detached {
+            try self.apply(to: image)
+        }.value
+    }
+
+    /// Apply every step to an image and encode the result.
+    /// The work is performed off the calling actor via `Task.detached`.
+    /// - Parameter image: The source image
+    /// - Returns: The encoded image data
+    public func data(from image: VIPSImage) async throws -> Data {
+        try await Task.detached {
+            try self.data(from: image)
+        }.value
+    }
+}
+
+// MARK: - Lowering
+
+extension VIPSPipeline.Step {
+
+    /// Whether this step leaves every image unchanged.
+    fileprivate var isIdentity: Bool {
+        switch self {
+        case let .linear(a, b): return abs(a - 1.0) < 1e-9 && abs(b) < 1e-9
+        case let .saturation(s): return abs(s - 1.0) < 1e-9
+        case let .gamma(exponent): return abs(exponent - 1.0) < 1e-9
+        default: return false
+        }
+    }
+
+    /// The native step passed to `cvips_pipeline_run`.
+    fileprivate var lowered: CVIPSPipelineStep {
+        switch self {
+        case let .crop(x, y, width, height):
+            return CVIPSPipelineStep(kind: CVIPS_STEP_CROP,
+                                     args: (Double(x), Double(y), Double(width), Double(height)))
+        case let .resize(hScale, vScale, kernel):
+            return CVIPSPipelineStep(kind: CVIPS_STEP_RESIZE,
+                                     args: (hScale, vScale, Double(kernel.vipsValue.rawValue), 0))
+        case let .resizeToFit(width, height):
+            return CVIPSPipelineStep(kind: CVIPS_STEP_THUMBNAIL, args: (Double(width), Double(height), 0, 0))
+        case let .linear(a, b):
+            return CVIPSPipelineStep(kind: CVIPS_STEP_LINEAR, args: (a, b, 0, 0))
+        case let .saturation(s):
+            return CVIPSPipelineStep(kind: CVIPS_STEP_SATURATION, args: (s, 0, 0, 0))
+        case let .gamma(exponent):
+            return CVIPSPipelineStep(kind: CVIPS_STEP_GAMMA, args: (exponent, 0, 0, 0))
+        case let .sharpen(sigma):
+            return CVIPSPipelineStep(kind: CVIPS_STEP_SHARPEN, args: (sigma, 0, 0, 0))
+        case let .flatten(color):
+            return CVIPSPipelineStep(kind: CVIPS_STEP_FLATTEN, args: (color.red, color.green, color.blue, 0))
+        case .grayscale:
+            return CVIPSPipelineStep(kind: CVIPS_STEP_COLOURSPACE,
+                                     args: (Double(VIPS_INTERPRETATION_B_W.rawValue), 0, 0, 0))
+        }
+    }
+}
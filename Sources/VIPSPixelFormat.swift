@@ -0,0 +1,34 @@
+internal import vips
+
+/// Sample formats for raw pixel buffers imported with
+/// ``VIPSImage/init(noCopyBuffer:width:height:bands:bytesPerRow:format:interpretation:owner:)``
+/// or exported with ``VIPSImage/write(into:bytesPerRow:format:interpretation:)``.
+public enum VIPSPixelFormat: Int, Sendable {
+    /// 8-bit unsigned integer samples
+    case uint8 = 0
+    /// 16-bit unsigned integer samples, in native byte order
+    case uint16
+    /// 16-bit IEEE half-precision float samples. libvips has no half-float format,
+    /// so these are converted to and from 32-bit float, which always copies.
+    case float16
+    /// 32-bit IEEE float samples
+    case float32
+
+    /// The size of one sample in bytes.
+    public var bytesPerSample: Int {
+        switch self {
+        case .uint8:            return 1
+        case .uint16, .float16: return 2
+        case .float32:          return 4
+        }
+    }
+
+    /// The libvips band format the samples are held in once imported.
+    internal var vipsValue: VipsBandFormat {
+        switch self {
+        case .uint8:             return VIPS_FORMAT_UCHAR
+        case .uint16:            return VIPS_FORMAT_USHORT
+        case .float16, .float32: return VIPS_FORMAT_FLOAT
+        }
+    }
+}
@@ -0,0 +1,35 @@
+/// Settings for running analysis on a reduced-resolution preview instead of the
+/// full image, trading a bounded amount of accuracy for speed on large inputs.
+///
+/// The preview is decoded with shrink-on-load where the format supports it (JPEG
+/// and WebP decode directly at reduced scale), so a 100 MP file is analyzed from
+/// around a megapixel. Rectangles found on the preview are mapped back to source
+/// coordinates and, when a ``tolerance`` finer than the preview's precision is
+/// asked for, their edges are refined against the full-resolution pixels near them.
+public struct VIPSPreviewOptions: Sendable, Equatable {
+
+    /// The longest side of the preview in pixels. Images that already fit are
+    /// analyzed at full resolution. (Default is 1024)
+    public var size: Int
+
+    /// The largest acceptable error in a returned edge, in source pixels, or `nil`
+    /// to accept the preview's own precision of a few preview pixels. When the
+    /// preview is coarser than this, each edge is refined by re-analyzing a narrow
+    /// full-resolution band around it; otherwise the mapped preview result is
+    /// returned as-is. (Default is `nil`, never refine)
+    ///
+    /// Refining reads full-resolution pixels. Formats without random access,
+    /// such as JPEG, decode the whole image the first time that happens, so only
+    /// set a tolerance when the exact edges are worth that cost.
+    public var tolerance: Int?
+
+    /// Create preview options.
+    /// - Parameters:
+    ///   - size: The longest side of the preview in pixels (default is 1024)
+    ///   - tolerance: The largest acceptable edge error in source pixels, or `nil` for
+    ///     the preview's own precision (default is `nil`)
+    public init(size: Int = 1024, tolerance: Int? = nil) {
+        self.size = size
+        self.tolerance = tolerance
+    }
+}
@@ -0,0 +1,239 @@
+import Foundation
+internal import vips
+internal import CVIPS
+
+/// Records timing and size counters for every native libvips call VIPSKit makes.
+///
+/// Profiling is off by default. While it is off, each native call pays for a single
+/// atomic load. When it is on, each call records its wall time, its thread, the pixels
+/// and bytes it consumed and produced, and whether it was served from the libvips
+/// operation cache.
+///
+/// Most ``VIPSImage`` operations are lazy: they only build a graph, and the pixels are
+/// computed by whichever later call reads them (an encode, a statistic, a region read).
+/// Look at the `compute`, `save` and `read` events to see where evaluation time goes.
+///
+/// ```swift
+/// VIPSProfiler.isEnabled = true
+/// let data = try image.resizeToFit(width: 512, height: 512).data(format: .jpeg)
+/// let snapshot = VIPSProfiler.snapshot()
+/// try snapshot.chromeTrace().write(to: traceURL)  // open in chrome://tracing or Perfetto
+/// ```
+public enum VIPSProfiler {
+
+    /// What a profiled call did.
+    public enum Kind: String, Sendable {
+        /// Decoded an image or read its header
+        case load
+        /// Added lazy operations to a graph without computing pixels
+        case build
+        /// Computed pixels eagerly (statistics, trim detection, histograms)
+        case compute
+        /// Encoded an image to a file, buffer, or stream
+        case save
+        /// Drew into an image in place
+        case draw
+        /// Copied computed pixels out of a region
+        case read
+    }
+
+    /// Whether a call was served from the libvips operation cache.
+    ///
+    /// A hit is only reported when the call returned an image produced by an
+    /// earlier profiled call. A miss is inferred from the cache growing during
+    /// the call, so calls running concurrently on other threads can occasionally
+    /// be misclassified as misses.
+    public enum CacheOutcome: String, Sendable {
+        /// The call is not cacheable, reused a result from before profiling was
+        /// enabled, or its outcome could not be determined
+        case none
+        /// The result of an earlier call was reused from the cache
+        case hit
+        /// A new operation was built and added to the cache
+        case miss
+    }
+
+    /// A single profiled call.
+    public struct Event: Sendable, Equatable {
+        /// The name of the wrapped operation, such as `thumbnail_buffer` or `jpegsave_buffer`
+        public let name: String
+        /// What the call did
+        public let kind: Kind
+        /// A small identifier for the calling thread, starting at 1
+        public let thread: Int
+        /// The monotonic start time in nanoseconds
+        public let start: UInt64
+        /// The wall time of the call in nanoseconds
+        public let duration: UInt64
+        /// The pixel count of the input image, if any
+        public let pixelsIn: UInt64
+        /// The pixel count of the output image, if any
+        public let pixelsOut: UInt64
+        /// Encoded input bytes for loads, otherwise the uncompressed size of the input image
+        public let bytesIn: UInt64
+        /// Encoded output bytes for buffer saves, otherwise the uncompressed size of the output image
+        public let bytesOut: UInt64
+        /// Whether the call was served from the operation cache
+        public let cache: CacheOutcome
+        /// Whether the call returned an error
+        public let failed: Bool
+    }
+
+    /// Totals for every call to one operation.
+    public struct OperationSummary: Sendable, Equatable {
+        /// The name of the operation
+        public let name: String
+        /// What the operation does
+        public let kind: Kind
+        /// The number of calls
+        public var count: Int = 0
+        /// The total wall time in nanoseconds
+        public var totalDuration: UInt64 = 0
+        /// The total input pixels
+        public var pixelsIn: UInt64 = 0
+        /// The total output pixels
+        public var pixelsOut: UInt64 = 0
+        /// The total input bytes
+        public var bytesIn: UInt64 = 0
+        /// The total output bytes
+        public var bytesOut: UInt64 = 0
+        /// Calls served from the operation cache
+        public var cacheHits: Int = 0
+        /// Calls that added a new operation to the cache
+        public var cacheMisses: Int = 0
+        /// Calls that returned an error
+        public var failures: Int = 0
+    }
+
+    /// The events recorded since profiling was enabled or last reset.
+    public struct Snapshot: Sendable {
+        /// Every recorded event, in the order the calls finished
+        public let events: [Event]
+        /// Events discarded because the recording buffer was full
+        public let droppedEventCount: Int
+
+        /// Per-operation totals, slowest first.
+        public var operations: [OperationSummary] {
+            var summaries: [String: OperationSummary] = [:]
+            for event in events {
+                var summary = summaries[event.name] ?? OperationSummary(name: event.name, kind: event.kind)
+                summary.count += 1
+                summary.totalDuration += event.duration
+                summary.pixelsIn += event.pixelsIn
+                summary.pixelsOut += event.pixelsOut
+                summary.bytesIn += event.bytesIn
+                summary.bytesOut += event.bytesOut
+                summary.cacheHits += event.cache == .hit ? 1 : 0
+                summary.cacheMisses += event.cache == .miss ? 1 : 0
+                summary.failures += event.failed ? 1 : 0
+                summaries[event.name] = summary
+            }
+            return summaries.values.sorted { $0.totalDuration > $1.totalDuration }
+        }
+
+        /// Time spent computing pixels (compute, save, and read events) per thread, in nanoseconds.
+        /// Nested calls on the same thread are counted once per event.
+        public var evaluationTimeByThread: [Int: UInt64] {
+            var totals: [Int: UInt64] = [:]
+            for event in events where event.kind == .compute || event.kind == .save || event.kind == .read {
+                totals[event.thread, default: 0] += event.duration
+            }
+            return totals
+        }
+
+        /// The number of calls served from the operation cache.
+        public var cacheHits: Int { events.filter { $0.cache == .hit }.count }
+
+        /// The number of calls that added a new operation to the cache.
+        public var cacheMisses: Int { events.filter { $0.cache == .miss }.count }
+
+        /// Export the events in the Chrome trace event format, for viewing in
+        /// `chrome://tracing` or Perfetto. Times are in microseconds from the first event.
+        /// - Returns: The trace as UTF-8 JSON
+        public func chromeTrace() throws -> Data {
+            let origin = events.map(\.start).min() ?? 0
+            let traceEvents: [[String: Any]] = events.map { event in
+                [
+                    "name": event.name,
+                    "cat": event.kind.rawValue,
+                    "ph": "X",
+                    "ts": Double(event.start - origin) / 1000.0,
+                    "dur": Double(event.duration) / 1000.0,
+                    "pid": 1,
+                    "tid": event.thread,
+                    "args": [
+                        "pixelsIn": event.pixelsIn,
+                        "pixelsOut": event.pixelsOut,
+                        "bytesIn": event.bytesIn,
+                        "bytesOut": event.bytesOut,
+                        "cache": event.cache.rawValue,
+                        "failed": event.failed,
+                    ] as [String: Any],
+                ]
+            }
+            let trace: [String: Any] = [
+                "traceEvents": traceEvents,
+                "displayTimeUnit": "ms",
+                "otherData": ["droppedEvents": droppedEventCount],
+            ]
+            return try JSONSerialization.data(withJSONObject: trace, options: [.sortedKeys])
+        }
+    }
+
+    // MARK: - Recording
+
+    /// Whether native calls are being recorded. Defaults to false.
+    public static var isEnabled: Bool {
+        get { cvips_profile_is_enabled() != 0 }
+        set { cvips_profile_set_enabled(newValue ? 1 : 0) }
+    }
+
+    /// Copy the events recorded so far. Recording continues.
+    /// - Returns: A snapshot of the recorded events
+    public static func snapshot() -> Snapshot {
+        var count: Int32 = 0
+        var dropped: UInt64 = 0
+        guard let raw = cvips_profile_copy_events(&count, &dropped) else {
+            return Snapshot(events: [], droppedEventCount: Int(dropped))
+        }
+        defer { g_free(raw) }
+        let events = UnsafeBufferPointer(start: raw, count: Int(count)).map(Event.init(native:))
+        return Snapshot(events: events, droppedEventCount: Int(dropped))
+    }
+
+    /// Discard every recorded event and the dropped event count.
+    public static func reset() {
+        cvips_profile_reset()
+    }
+}
+
+// MARK: - Conversion
+
+extension VIPSProfiler.Event {
+
+    fileprivate init(native event: CVIPSProfileEvent) {
+        let name = String(cString: event.name)
+        self.name = name.hasPrefix("cvips_") ? String(name.dropFirst(6)) : name
+        switch event.kind {
+        case CVIPS_PROFILE_LOAD: kind = .load
+        case CVIPS_PROFILE_COMPUTE: kind = .compute
+        case CVIPS_PROFILE_SAVE: kind = .save
+        case CVIPS_PROFILE_DRAW: kind = .draw
+        case CVIPS_PROFILE_READ: kind = .read
+        default: kind = .build
+        }
+        switch event.cache {
+        case CVIPS_CACHE_HIT: cache = .hit
+        case CVIPS_CACHE_MISS: cache = .miss
+        default: cache = .none
+        }
+        thread = Int(event.thread)
+        start = UInt64(event.start)
+        duration = UInt64(max(0, event.duration))
+        pixelsIn = event.pixels_in
+        pixelsOut = event.pixels_out
+        bytesIn = event.bytes_in
+        bytesOut = event.bytes_out
+        failed = event.failed != 0
+    }
+}
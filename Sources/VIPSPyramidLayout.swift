@@ -0,0 +1,31 @@
+internal import vips
+
+/// Directory layouts for tiled image pyramids written by
+/// ``VIPSImage/writePyramid(toPath:layout:tileSize:overlap:format:quality:threads:)``.
+/// These correspond to the `VipsForeignDzLayout` enum in libvips.
+public enum VIPSPyramidLayout: Int, Sendable {
+    /// Microsoft DeepZoom: a `.dzi` descriptor plus a `_files` directory with one
+    /// folder per level, as read by OpenSeadragon
+    case deepZoom = 0
+    /// Zoomify: an `ImageProperties.xml` descriptor plus `TileGroup` folders
+    case zoomify
+    /// libvips' Google layout: a plain `z/y/x` directory tree of `level/row/column`.
+    /// Web map viewers need a `{z}/{y}/{x}` URL template to read it, since many,
+    /// such as Leaflet, default to `{z}/{x}/{y}`.
+    case google
+
+    /// The conventional tile size for this layout.
+    public var defaultTileSize: Int {
+        self == .deepZoom ? 254 : 256
+    }
+
+    /// The conventional tile overlap for this layout.
+    public var defaultOverlap: Int {
+        self == .deepZoom ? 1 : 0
+    }
+
+    /// The corresponding libvips `VipsForeignDzLayout` value.
+    internal var vipsValue: VipsForeignDzLayout {
+        VipsForeignDzLayout(rawValue: UInt32(rawValue))
+    }
+}
@@ -0,0 +1,173 @@
+import Foundation
+import CoreGraphics
+internal import vips
+internal import CVIPS
+
+/// A long-lived reader that serves rectangular pixel regions from a single image source.
+///
+/// Unlike ``VIPSImage/extractRegion(fromFile:x:y:width:height:)``, which reopens and
+/// re-parses the source on every call, a `VIPSRegionReader` opens the source once in
+/// random-access mode and computes each requested area on demand through a libvips
+/// region. Pixels are copied straight into caller-owned memory, so walking a very
+/// large image tile by tile never allocates an intermediate `VIPSImage` per tile.
+///
+/// Pixels are delivered in the image's native band format, packed as
+/// ``bytesPerPixel`` bytes per pixel.
+///
+/// ```swift
+/// let reader = try VIPSRegionReader(contentsOfFile: path)
+/// try reader.forEachTile(tileWidth: 256, tileHeight: 256) { rect, pixels, bytesPerRow in
+///     // Process the tile
+/// }
+/// ```
+///
+/// A reader may be shared between threads; reads are serialized internally.
+public final class VIPSRegionReader: @unchecked Sendable {
+
+    /// The source image backing this reader.
+    public let image: VIPSImage
+
+    /// The underlying libvips region used to compute requested areas.
+    private let region: UnsafeMutablePointer<VipsRegion>
+
+    /// Encoded source data, retained because libvips reads from it lazily.
+    private let data: Data?
+
+    /// Serializes access to `region`, which is not thread-safe.
+    private let lock = NSLock()
+
+    /// The width of the source image in pixels.
+    public let width: Int
+
+    /// The height of the source image in pixels.
+    public let height: Int
+
+    /// The number of bands (channels) in the source image.
+    public let bands: Int
+
+    /// The number of bytes occupied by a single pixel across all bands.
+    public let bytesPerPixel: Int
+
+    // MARK: - Lifecycle
+
+    /// Create a reader over an existing image.
+    /// - Parameter image: The image to read regions from
+    public convenience init(image: VIPSImage) throws {
+        try self.init(image: image, data: nil)
+    }
+
+    /// Open an image file once for repeated random-access region reads.
+    /// - Parameter path: The file path of the source image
+    public convenience init(contentsOfFile path: String) throws {
+        guard let source = cvips_image_new_from_file(path) else {
+            throw VIPSError.fromVips()
+        }
+        try self.init(image: VIPSImage(pointer: source), data: nil)
+    }
+
+    /// Open encoded image data once for repeated random-access region reads.
+    /// The data is retained for the lifetime of the reader.
+    /// - Parameter data: The encoded image data
+    public convenience init(data: Data) throws {
+        let source: UnsafeMutablePointer<VipsImage>? = data.withUnsafeBytes { buffer in
+            cvips_image_new_from_buffer(buffer.baseAddress, buffer.count)
+        }
+        guard let source else { throw VIPSError.fromVips() }
+        try self.init(image: VIPSImage(pointer: source), data: data)
+    }
+
+    private init(image: VIPSImage, data: Data?) throws {
+        guard let region = vips_region_new(image.pointer) else {
+            throw VIPSError.fromVips()
+        }
+        self.image = image
+        self.region = region
+        self.data = data
+        self.width = image.width
+        self.height = image.height
+        self.bands = image.bands
+        self.bytesPerPixel = Int(vips_format_sizeof(vips_image_get_format(image.pointer))) * image.bands
+    }
+
+    deinit {
+        g_object_unref(gpointer(region))
+    }
+
+    // MARK: - Tiling
+
+    /// Calculate tile rectangles for dividing the source image into a uniform grid.
+    /// Edge tiles may be smaller if the image dimensions are not evenly divisible.
+    /// - Parameters:
+    ///   - tileWidth: The width of each tile in pixels
+    ///   - tileHeight: The height of each tile in pixels
+    /// - Returns: An array of rectangles representing each tile's position and size
+    public func tileRects(tileWidth: Int, tileHeight: Int) -> [CGRect] {
+        image.tileRects(tileWidth: tileWidth, tileHeight: tileHeight)
+    }
+
+    // MARK: - Reading
+
+    /// Compute a rectangular area of the source image and copy its pixels into
+    /// a caller-owned buffer.
+    /// - Parameters:
+    ///   - x: The left edge of the region in pixels
+    ///   - y: The top edge of the region in pixels
+    ///   - width: The width of the region in pixels
+    ///   - height: The height of the region in pixels
+    ///   - buffer: Destination memory of at least `bytesPerRow * height` bytes
+    ///   - bytesPerRow: The destination row stride in bytes. Must be at least
+    ///     `width * bytesPerPixel`.
+    public func read(x: Int, y: Int, width: Int, height: Int,
+                     into buffer: UnsafeMutableRawPointer, bytesPerRow: Int) throws {
+        guard width > 0, height > 0 else { throw VIPSError("Region size must be positive") }
+        guard x >= 0, y >= 0, x + width <= self.width, y + height <= self.height else {
+            throw VIPSError("Region (\(x),\(y),\(width),\(height)) exceeds image bounds (\(self.width),\(self.height))")
+        }
+        guard bytesPerRow >= width * bytesPerPixel else {
+            throw VIPSError("Row stride \(bytesPerRow) is smaller than the region row size \(width * bytesPerPixel)")
+        }
+
+        lock.lock()
+        defer { lock.unlock() }
+        guard cvips_region_read(region, Int32(x), Int32(y), Int32(width), Int32(height),
+                                buffer, bytesPerRow) == 0 else {
+            throw VIPSError.fromVips()
+        }
+    }
+
+    /// Compute a rectangular area of the source image and copy its pixels into
+    /// a caller-owned buffer.
+    /// - Parameters:
+    ///   - rect: The region to read, in pixels
+    ///   - buffer: Destination memory of at least `bytesPerRow * rect.height` bytes
+    ///   - bytesPerRow: The destination row stride in bytes
+    public func read(rect: CGRect, into buffer: UnsafeMutableRawPointer, bytesPerRow: Int) throws {
+        try read(x: Int(rect.origin.x), y: Int(rect.origin.y),
+                 width: Int(rect.width), height: Int(rect.height),
+                 into: buffer, bytesPerRow: bytesPerRow)
+    }
+
+    /// Read every tile of the source image in row-major order, reusing a single
+    /// scratch buffer sized for the largest tile.
+    ///
+    /// The pixel buffer passed to `body` is only valid for the duration of that call.
+    /// - Parameters:
+    ///   - tileWidth: The width of each tile in pixels
+    ///   - tileHeight: The height of each tile in pixels
+    ///   - body: A closure receiving the tile rectangle, its packed pixels, and the row stride in bytes
+    public func forEachTile(tileWidth: Int, tileHeight: Int,
+                            _ body: (CGRect, UnsafeRawBufferPointer, Int) throws -> Void) throws {
+        let rects = tileRects(tileWidth: tileWidth, tileHeight: tileHeight)
+        guard !rects.isEmpty else { return }
+
+        let stride = min(tileWidth, width) * bytesPerPixel
+        let capacity = stride * min(tileHeight, height)
+        let scratch = UnsafeMutableRawPointer.allocate(byteCount: capacity, alignment: 16)
+        defer { scratch.deallocate() }
+
+        for rect in rects {
+            try read(rect: rect, into: scratch, bytesPerRow: stride)
+            try body(rect, UnsafeRawBufferPointer(start: scratch, count: stride * Int(rect.height)), stride)
+        }
+    }
+}
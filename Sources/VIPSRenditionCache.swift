@@ -0,0 +1,323 @@
+import Foundation
+import CryptoKit
+
+/// A persistent on-disk cache of encoded images, keyed by the content of the source
+/// image and the operation that produced the output.
+///
+/// The libvips operation cache configured by ``VIPSImage/initialize()`` only lives as long
+/// as the process and only remembers recent graph nodes. A rendition cache instead stores
+/// the final encoded bytes, so rendering the same thumbnail of the same source again,
+/// even after a restart, costs a hash of the source and a file lookup.
+///
+/// Cache hits are returned as memory-mapped `Data`, so large outputs are paged in
+/// lazily rather than copied. Entries are evicted least-recently-used first whenever the
+/// total size on disk exceeds the byte budget. Evicting an entry whose data is still in
+/// use is safe: the mapping stays valid until the `Data` is released.
+///
+/// ```swift
+/// let cache = try VIPSRenditionCache(directory: cachesURL.appendingPathComponent("thumbnails"),
+///                                    byteBudget: 256 * 1024 * 1024)
+/// let data = try cache.thumbnailData(fromData: source, width: 256, height: 256, format: .webP)
+/// print(cache.statistics.hitRate)
+/// ```
+public final class VIPSRenditionCache: @unchecked Sendable {
+
+    /// The operation that produces a cached output from a source image.
+    public struct Specification: Hashable, Sendable {
+        /// The maximum thumbnail width, or `nil` to re-encode the source at full size
+        public var width: Int?
+        /// The maximum thumbnail height, or `nil` to re-encode the source at full size
+        public var height: Int?
+        /// The format to encode as
+        public var format: VIPSImageFormat
+        /// The encoding quality (1-100). Ignored for PNG and TIFF.
+        public var quality: Int
+        /// Whether to encode losslessly. Only meaningful for WebP and JPEG-XL.
+        public var lossless: Bool
+
+        /// A thumbnail fitted within the given size.
+        /// - Parameters:
+        ///   - width: The maximum width of the thumbnail
+        ///   - height: The maximum height of the thumbnail
+        ///   - format: The format to encode as (default is JPEG)
+        ///   - quality: The encoding quality (1-100, default is 85)
+        ///   - lossless: Whether to encode losslessly (default is false)
+        public static func thumbnail(width: Int, height: Int, format: VIPSImageFormat = .jpeg,
+                                     quality: Int = 85, lossless: Bool = false) -> Specification {
+            Specification(width: width, height: height, format: format, quality: quality, lossless: lossless)
+        }
+
+        /// The full-size source re-encoded in another format.
+        /// - Parameters:
+        ///   - format: The format to encode as
+        ///   - quality: The encoding quality (1-100, default is 85)
+        ///   - lossless: Whether to encode losslessly (default is false)
+        public static func encoded(format: VIPSImageFormat, quality: Int = 85,
+                                   lossless: Bool = false) -> Specification {
+            Specification(width: nil, height: nil, format: format, quality: quality, lossless: lossless)
+        }
+
+        /// A file-name-safe description of the specification.
+        fileprivate var component: String {
+            let size = width.map { "\($0)x\(height ?? $0)" } ?? "full"
+            let ext = format.fileExtension ?? "bin"
+            let quality = format == .png || format == .tiff || lossless ? "" : "-q\(self.quality)"
+            return "\(size)\(quality)\(lossless ? "-lossless" : "").\(ext)"
+        }
+    }
+
+    /// Hit rate, latency, and size counters since the cache was created or last reset.
+    public struct Statistics: Sendable {
+        /// Lookups served from disk
+        public var hits: Int = 0
+        /// Lookups that rendered and stored a new entry
+        public var misses: Int = 0
+        /// Entries removed to stay within the byte budget
+        public var evictions: Int = 0
+        /// Total time spent serving hits, in seconds
+        public var hitTime: TimeInterval = 0
+        /// Total time spent rendering and storing misses, in seconds
+        public var missTime: TimeInterval = 0
+        /// The number of entries currently stored
+        public var entryCount: Int = 0
+        /// The total size of the stored entries, in bytes
+        public var totalBytes: Int = 0
+
+        /// The fraction of lookups that were hits (0 when there have been no lookups)
+        public var hitRate: Double {
+            hits + misses == 0 ? 0 : Double(hits) / Double(hits + misses)
+        }
+
+        /// The mean latency of a hit, in seconds
+        public var averageHitLatency: TimeInterval {
+            hits == 0 ? 0 : hitTime / Double(hits)
+        }
+
+        /// The mean latency of a miss, in seconds
+        public var averageMissLatency: TimeInterval {
+            misses == 0 ? 0 : missTime / Double(misses)
+        }
+    }
+
+    /// One stored output.
+    private struct Entry {
+        var size: Int
+        var lastAccess: UInt64
+    }
+
+    /// The directory holding the cached files
+    public let directory: URL
+
+    /// The maximum total size of the stored entries, in bytes
+    public let byteBudget: Int
+
+    private let lock = NSLock()
+    private var entries: [String: Entry] = [:]
+    private var totalBytes = 0
+    private var clock: UInt64 = 0
+    private var counters = Statistics()
+
+    /// Open or create a rendition cache.
+    ///
+    /// Entries already present in the directory are adopted, ordered for eviction by
+    /// their modification dates, and the cache is trimmed to the budget.
+    /// - Parameters:
+    ///   - directory: The directory to store cached files in. It is created if needed.
+    ///   - byteBudget: The maximum total size of the stored entries, in bytes
+    public init(directory: URL, byteBudget: Int) throws {
+        self.directory = directory
+        self.byteBudget = byteBudget
+        let fileManager = FileManager.default
+        try fileManager.createDirectory(at: directory, withIntermediateDirectories: true)
+
+        let keys: [URLResourceKey] = [.fileSizeKey, .contentModificationDateKey, .isRegularFileKey]
+        let files = try fileManager.contentsOfDirectory(at: directory, includingPropertiesForKeys: keys)
+        let existing = files.compactMap { url -> (name: String, size: Int, date: Date)? in
+            guard let values = try? url.resourceValues(forKeys: Set(keys)), values.isRegularFile == true,
+                  !url.lastPathComponent.hasPrefix(".") else { return nil }
+            return (url.lastPathComponent, values.fileSize ?? 0, values.contentModificationDate ?? .distantPast)
+        }
+        for file in existing.sorted(by: { $0.date < $1.date }) {
+            clock += 1
+            entries[file.name] = Entry(size: file.size, lastAccess: clock)
+            totalBytes += file.size
+        }
+        evictIfNeeded()
+    }
+
+    // MARK: - Lookup
+
+    /// Return the cached output for a source and specification, rendering and storing it on a miss.
+    /// - Parameters:
+    ///   - data: The encoded source image
+    ///   - specification: The operation applied to the source
+    /// - Returns: The encoded output. Hits are memory-mapped from disk.
+    public func data(forSource data: Data, specification: Specification) throws -> Data {
+        let start = DispatchTime.now()
+        let name = Self.key(for: data) + "-" + specification.component
+        let url = directory.appendingPathComponent(name)
+
+        if touch(name), let mapped = try? Data(contentsOf: url, options: .alwaysMapped) {
+            // Persist recency so eviction order survives a restart
+            try? FileManager.default.setAttributes([.modificationDate: Date()], ofItemAtPath: url.path)
+            record { $0.hits += 1; $0.hitTime += Self.seconds(since: start) }
+            return mapped
+        }
+
+        let output = try Self.render(data, specification: specification)
+        // Written to a temporary file and renamed, so readers never see partial files
+        try output.write(to: url, options: .atomic)
+        insert(name, size: output.count)
+        record { $0.misses += 1; $0.missTime += Self.seconds(since: start) }
+        return output
+    }
+
+    /// Return a cached thumbnail of encoded image data, rendering and storing it on a miss.
+    /// - Parameters:
+    ///   - data: The encoded source image
+    ///   - width: The maximum width of the thumbnail
+    ///   - height: The maximum height of the thumbnail
+    ///   - format: The format to encode as (default is JPEG)
+    ///   - quality: The encoding quality (1-100, default is 85)
+    ///   - lossless: Whether to encode losslessly (default is false)
+    /// - Returns: The encoded thumbnail
+    public func thumbnailData(fromData data: Data, width: Int, height: Int, format: VIPSImageFormat = .jpeg,
+                              quality: Int = 85, lossless: Bool = false) throws -> Data {
+        try self.data(forSource: data, specification: .thumbnail(width: width, height: height, format: format,
+                                                                 quality: quality, lossless: lossless))
+    }
+
+    /// Return cached encoded image data re-encoded in another format, rendering and storing it on a miss.
+    /// - Parameters:
+    ///   - data: The encoded source image
+    ///   - format: The format to encode as
+    ///   - quality: The encoding quality (1-100, default is 85)
+    ///   - lossless: Whether to encode losslessly (default is false)
+    /// - Returns: The re-encoded image
+    public func encodedData(fromData data: Data, format: VIPSImageFormat, quality: Int = 85,
+                            lossless: Bool = false) throws -> Data {
+        try self.data(forSource: data, specification: .encoded(format: format, quality: quality, lossless: lossless))
+    }
+
+    // MARK: - Maintenance
+
+    /// The hit rate, latency, and size counters.
+    public var statistics: Statistics {
+        lock.lock()
+        defer { lock.unlock() }
+        var snapshot = counters
+        snapshot.entryCount = entries.count
+        snapshot.totalBytes = totalBytes
+        return snapshot
+    }
+
+    /// Reset the hit, miss, eviction, and latency counters. Stored entries are kept.
+    public func resetStatistics() {
+        lock.lock()
+        counters = Statistics()
+        lock.unlock()
+    }
+
+    /// Remove every stored entry from disk.
+    public func removeAll() {
+        lock.lock()
+        let names = Array(entries.keys)
+        entries.removeAll()
+        totalBytes = 0
+        lock.unlock()
+        for name in names {
+            try? FileManager.default.removeItem(at: directory.appendingPathComponent(name))
+        }
+    }
+
+    // MARK: - Internal
+
+    /// The content address of a source image.
+    internal static func key(for data: Data) -> String {
+        SHA256.hash(data: data).map { String(format: "%02x", $0) }.joined()
+    }
+
+    private static func render(_ data: Data, specification: Specification) throws -> Data {
+        let image: VIPSImage
+        if let width = specification.width {
+            image = try VIPSImage.thumbnail(fromData: data, width: width, height: specification.height ?? width)
+        } else {
+            image = try VIPSImage(data: data)
+        }
+        return try image.data(format: specification.format, quality: specification.quality,
+                              lossless: specification.lossless)
+    }
+
+    private static func seconds(since start: DispatchTime) -> TimeInterval {
+        Double(DispatchTime.now().uptimeNanoseconds - start.uptimeNanoseconds) / 1_000_000_000
+    }
+
+    private func record(_ update: (inout Statistics) -> Void) {
+        lock.lock()
+        update(&counters)
+        lock.unlock()
+    }
+
+    /// Mark an entry as most recently used. Returns false if it is not stored.
+    private func touch(_ name: String) -> Bool {
+        lock.lock()
+        defer { lock.unlock() }
+        guard entries[name] != nil else { return false }
+        clock += 1
+        entries[name]?.lastAccess = clock
+        return true
+    }
+
+    private func insert(_ name: String, size: Int) {
+        lock.lock()
+        defer { lock.unlock() }
+        clock += 1
+        totalBytes += size - (entries[name]?.size ?? 0)
+        entries[name] = Entry(size: size, lastAccess: clock)
+        evictIfNeeded()
+    }
+
+    /// Remove least recently used entries until the budget is met. Must hold `lock`.
+    private func evictIfNeeded() {
+        guard totalBytes > byteBudget else { return }
+        for (name, entry) in entries.sorted(by: { $0.value.lastAccess < $1.value.lastAccess }) {
+            guard totalBytes > byteBudget else { break }
+            entries[name] = nil
+            totalBytes -= entry.size
+            counters.evictions += 1
+            try? FileManager.default.removeItem(at: directory.appendingPathComponent(name))
+        }
+    }
+
+    // MARK: - Async
+
+    /// Return the cached output for a source and specification, rendering and storing it on a miss.
+    /// The work is performed off the calling actor via `Task.detached`.
+    /// - Parameters:
+    ///   - data: The encoded source image
+    ///   - specification: The operation applied to the source
+    /// - Returns: The encoded output
+    public func data(forSource data: Data, specification: Specification) async throws -> Data {
+        try await Task.detached {
+            try self.data(forSource: data, specification: specification)
+        }.value
+    }
+
+    /// Return a cached thumbnail of encoded image data, rendering and storing it on a miss.
+    /// The work is performed off the calling actor via `Task.detached`.
+    /// - Parameters:
+    ///   - data: The encoded source image
+    ///   - width: The maximum width of the thumbnail
+    ///   - height: The maximum height of the thumbnail
+    ///   - format: The format to encode as (default is JPEG)
+    ///   - quality: The encoding quality (1-100, default is 85)
+    ///   - lossless: Whether to encode losslessly (default is false)
+    /// - Returns: The encoded thumbnail
+    public func thumbnailData(fromData data: Data, width: Int, height: Int, format: VIPSImageFormat = .jpeg,
+                              quality: Int = 85, lossless: Bool = false) async throws -> Data {
+        try await Task.detached {
+            try self.thumbnailData(fromData: data, width: width, height: height, format: format,
+                                   quality: quality, lossless: lossless)
+        }.value
+    }
+}
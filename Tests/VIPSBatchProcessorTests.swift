@@ -0,0 +1,104 @@
+import XCTest
+@testable import VIPSKit
+
+final class VIPSBatchProcessorTests: VIPSImageTestCase {
+
+    private func makeSources(count: Int, width: Int = 400, height: Int = 300) throws -> [VIPSBatchProcessor.Source] {
+        let data = try createTestImage(width: width, height: height).data(format: .jpeg)
+        return Array(repeating: .data(data), count: count)
+    }
+
+    private func collect(_ stream: AsyncStream<VIPSBatchProcessor.Event>) async -> ([VIPSBatchProcessor.Output], VIPSBatchProcessor.Report?) {
+        var outputs: [VIPSBatchProcessor.Output] = []
+        var report: VIPSBatchProcessor.Report?
+        for await event in stream {
+            switch event {
+            case .completed(let output): outputs.append(output)
+            case .finished(let finished): report = finished
+            }
+        }
+        return (outputs, report)
+    }
+
+    func testProcessDataSources() async throws {
+        let processor = VIPSBatchProcessor(maxConcurrency: 4)
+        let spec = VIPSBatchProcessor.Specification(width: 64, height: 64, format: .png)
+        let (outputs, report) = await collect(processor.process(try makeSources(count: 10), specification: spec))
+
+        XCTAssertEqual(outputs.count, 10)
+        XCTAssertEqual(Set(outputs.map(\.index)), Set(0..<10))
+        for output in outputs {
+            let thumbnail = try VIPSImage(data: try output.result.get())
+            XCTAssertEqual(thumbnail.width, 64)
+            XCTAssertEqual(thumbnail.sourceFormat, .png)
+        }
+
+        let finished = try XCTUnwrap(report)
+        XCTAssertEqual(finished.itemCount, 10)
+        XCTAssertEqual(finished.failureCount, 0)
+        XCTAssertGreaterThan(finished.itemsPerSecond, 0)
+        XCTAssertGreaterThanOrEqual(finished.peakMemory, 0)
+    }
+
+    func testProcessFileSources() async throws {
+        let path = NSTemporaryDirectory() + "vipskit_test_batch.png"
+        defer { try? FileManager.default.removeItem(atPath: path) }
+        try createTestImage(width: 120, height: 80).write(toFile: path)
+
+        let processor = VIPSBatchProcessor(maxConcurrency: 2)
+        let spec = VIPSBatchProcessor.Specification(width: 60, height: 60, format: .jpeg, quality: 70)
+        let (outputs, report) = await collect(processor.process([.file(path), .file(path)], specification: spec))
+        XCTAssertEqual(outputs.count, 2)
+        XCTAssertEqual(report?.failureCount, 0)
+    }
+
+    func testFailuresAreReported() async throws {
+        var sources = try makeSources(count: 3)
+        sources.append(.data(Data([0x00, 0x01, 0x02, 0x03])))
+        sources.append(.file("/nonexistent/vipskit_batch.jpg"))
+
+        let processor = VIPSBatchProcessor()
+        let spec = VIPSBatchProcessor.Specification(width: 32, height: 32)
+        let (outputs, report) = await collect(processor.process(sources, specification: spec))
+
+        XCTAssertEqual(outputs.count, 5)
+        XCTAssertEqual(report?.failureCount, 2)
+        let failed = outputs.filter { if case .failure = $0.result { return true } else { return false } }
+        XCTAssertEqual(Set(failed.map(\.index)), [3, 4])
+    }
+
+    func testTinyMemoryBudgetStillCompletes() async throws {
+        // With a budget that is always exceeded, workers fall back to one image at a time
+        let processor = VIPSBatchProcessor(maxConcurrency: 4, memoryBudget: 1)
+        let spec = VIPSBatchProcessor.Specification(width: 48, height: 48)
+        let (outputs, report) = await collect(processor.process(try makeSources(count: 6), specification: spec))
+        XCTAssertEqual(outputs.count, 6)
+        XCTAssertEqual(report?.itemCount, 6)
+    }
+
+    func testEmptyBatch() async throws {
+        let processor = VIPSBatchProcessor()
+        let spec = VIPSBatchProcessor.Specification(width: 48, height: 48)
+        let (outputs, report) = await collect(processor.process([], specification: spec))
+        XCTAssertTrue(outputs.isEmpty)
+        XCTAssertEqual(report?.itemCount, 0)
+    }
+
+    // MARK: - Benchmark
+
+    func testPerformanceBatchThroughput() async throws {
+        try skipUnlessBenchmarking()
+        let sources = try makeSources(count: 48, width: 1600, height: 1200)
+        let spec = VIPSBatchProcessor.Specification(width: 256, height: 256, format: .jpeg, quality: 80)
+
+        // Throughput and peak memory for each worker count are in the returned reports
+        for workers in [1, ProcessInfo.processInfo.activeProcessorCount] {
+            let processor = VIPSBatchProcessor(maxConcurrency: workers)
+            let (outputs, report) = await collect(processor.process(sources, specification: spec))
+            let finished = try XCTUnwrap(report)
+            XCTAssertEqual(outputs.count, sources.count)
+            XCTAssertEqual(finished.failureCount, 0)
+            XCTAssertGreaterThan(finished.itemsPerSecond, 0)
+        }
+    }
+}
@@ -0,0 +1,228 @@
+import XCTest
+import CoreGraphics
+@testable import VIPSKit
+
+final class VIPSDrawListTests: VIPSImageTestCase {
+
+    private let red = VIPSColor(red: 255, green: 0, blue: 0)
+    private let green = VIPSColor(red: 0, green: 255, blue: 0)
+
+    func testRecording() {
+        var list = VIPSDrawList()
+        XCTAssertTrue(list.isEmpty)
+        list.addRect(x: 0, y: 0, width: 10, height: 10, color: red)
+        list.addLine(from: .zero, to: CGPoint(x: 5, y: 5), color: red)
+        list.addPolyline([.zero, CGPoint(x: 3, y: 0), CGPoint(x: 3, y: 3)], color: green)
+        XCTAssertEqual(list.count, 3)
+        XCTAssertEqual(list.colors.count, 2)
+        XCTAssertEqual(list.points.count, 6)
+
+        list.removeAll()
+        XCTAssertTrue(list.isEmpty)
+        XCTAssertTrue(list.colors.isEmpty)
+    }
+
+    func testRectsMatchChainedCalls() throws {
+        // Large enough to span several tiles, with shapes crossing tile edges
+        let chained = try VIPSImage.blank(width: 600, height: 600)
+        let listed = try VIPSImage.blank(width: 600, height: 600)
+        var list = VIPSDrawList()
+        for i in 0..<40 {
+            let x = (i * 37) % 520, y = (i * 61) % 520
+            let fill = i % 2 == 0
+            let color = fill ? red : green
+            try chained.drawRect(x: x, y: y, width: 70, height: 45, color: color, fill: fill)
+            list.addRect(x: Double(x), y: Double(y), width: 70, height: 45, color: color, fill: fill)
+        }
+        try listed.draw(list)
+        XCTAssertEqual(try listed.data(format: .png), try chained.data(format: .png))
+    }
+
+    func testAxisAlignedLinesMatchChainedCalls() throws {
+        let chained = try VIPSImage.blank(width: 400, height: 400)
+        let listed = try VIPSImage.blank(width: 400, height: 400)
+        let lines: [(CGPoint, CGPoint)] = [
+            (CGPoint(x: 0, y: 200), CGPoint(x: 399, y: 200)),
+            (CGPoint(x: 255, y: 0), CGPoint(x: 255, y: 399)),
+            (CGPoint(x: 10, y: 10), CGPoint(x: 300, y: 300)),
+        ]
+        var list = VIPSDrawList()
+        for (from, to) in lines {
+            try chained.drawLine(from: from, to: to, color: .white)
+            list.addLine(from: from, to: to, color: .white)
+        }
+        try listed.draw(list)
+        XCTAssertEqual(try listed.data(format: .png), try chained.data(format: .png))
+    }
+
+    func testCircles() throws {
+        let canvas = try VIPSImage.blank(width: 300, height: 300)
+        var list = VIPSDrawList()
+        list.addCircle(center: CGPoint(x: 256, y: 256), radius: 30, color: red, fill: true)
+        list.addCircle(center: CGPoint(x: 60, y: 60), radius: 40, color: green)
+        try canvas.draw(list)
+
+        // The filled circle straddles four tiles
+        XCTAssertEqual(try canvas.pixelValues(atX: 256, y: 256).red, 255, accuracy: 1.0)
+        XCTAssertEqual(try canvas.pixelValues(atX: 240, y: 270).red, 255, accuracy: 1.0)
+        XCTAssertEqual(try canvas.pixelValues(atX: 200, y: 200).red, 0, accuracy: 1.0)
+        // The outline is drawn but the interior is not
+        XCTAssertEqual(try canvas.pixelValues(atX: 100, y: 60).green, 255, accuracy: 1.0)
+        XCTAssertEqual(try canvas.pixelValues(atX: 60, y: 60).green, 0, accuracy: 1.0)
+    }
+
+    func testPolygonFill() throws {
+        let canvas = try VIPSImage.blank(width: 300, height: 300)
+        var list = VIPSDrawList()
+        list.addPolygon([CGPoint(x: 10, y: 10), CGPoint(x: 290, y: 10), CGPoint(x: 10, y: 290)],
+                        color: red, fill: true)
+        try canvas.draw(list)
+        XCTAssertEqual(try canvas.pixelValues(atX: 50, y: 50).red, 255, accuracy: 1.0)
+        XCTAssertEqual(try canvas.pixelValues(atX: 200, y: 60).red, 255, accuracy: 1.0)
+        XCTAssertEqual(try canvas.pixelValues(atX: 250, y: 250).red, 0, accuracy: 1.0)
+        XCTAssertEqual(try canvas.pixelValues(atX: 5, y: 5).red, 0, accuracy: 1.0)
+    }
+
+    func testPolygonOutlineAndPolyline() throws {
+        let canvas = try VIPSImage.blank(width: 300, height: 300)
+        let square = [CGPoint(x: 20, y: 20), CGPoint(x: 280, y: 20), CGPoint(x: 280, y: 280), CGPoint(x: 20, y: 280)]
+        var list = VIPSDrawList()
+        list.addPolygon(square, color: red)
+        list.addPolyline([CGPoint(x: 100, y: 100), CGPoint(x: 200, y: 100), CGPoint(x: 200, y: 200)], color: green)
+        try canvas.draw(list)
+
+        // Closing edge of the polygon, from the last vertex back to the first
+        XCTAssertEqual(try canvas.pixelValues(atX: 20, y: 150).red, 255, accuracy: 1.0)
+        XCTAssertEqual(try canvas.pixelValues(atX: 150, y: 150).red, 0, accuracy: 1.0)
+        XCTAssertEqual(try canvas.pixelValues(atX: 150, y: 100).green, 255, accuracy: 1.0)
+        XCTAssertEqual(try canvas.pixelValues(atX: 200, y: 150).green, 255, accuracy: 1.0)
+        // A polyline is not closed
+        XCTAssertEqual(try canvas.pixelValues(atX: 150, y: 150).green, 0, accuracy: 1.0)
+    }
+
+    func testLaterShapesPaintOver() throws {
+        let canvas = try VIPSImage.blank(width: 100, height: 100)
+        var list = VIPSDrawList()
+        list.addRect(x: 0, y: 0, width: 60, height: 60, color: red, fill: true)
+        list.addRect(x: 40, y: 40, width: 60, height: 60, color: green, fill: true)
+        try canvas.draw(list)
+        let overlap = try canvas.pixelValues(atX: 50, y: 50)
+        XCTAssertEqual(overlap.red, 0, accuracy: 1.0)
+        XCTAssertEqual(overlap.green, 255, accuracy: 1.0)
+    }
+
+    func testAntialiasedEdgesBlend() throws {
+        let canvas = try VIPSImage.blank(width: 100, height: 100)
+        var list = VIPSDrawList()
+        list.addLine(from: CGPoint(x: 0, y: 20.5), to: CGPoint(x: 99, y: 20.5), color: .white)
+        list.addRect(x: 10.5, y: 50, width: 20, height: 20, color: .white, fill: true)
+        try canvas.draw(list, antialias: true)
+
+        XCTAssertEqual(try canvas.pixelValues(atX: 50, y: 20).red, 128, accuracy: 2.0)
+        XCTAssertEqual(try canvas.pixelValues(atX: 50, y: 21).red, 128, accuracy: 2.0)
+        XCTAssertEqual(try canvas.pixelValues(atX: 10, y: 60).red, 128, accuracy: 2.0)
+        XCTAssertEqual(try canvas.pixelValues(atX: 20, y: 60).red, 255, accuracy: 1.0)
+    }
+
+    func testSingleBandAndRGBAImages() throws {
+        var list = VIPSDrawList()
+        list.addRect(x: 5, y: 5, width: 10, height: 10, color: .white, fill: true)
+
+        let gray = try VIPSImage.blank(width: 20, height: 20, bands: 1)
+        try gray.draw(list)
+        XCTAssertEqual(try gray.pixelValues(atX: 10, y: 10).red, 255, accuracy: 1.0)
+
+        let rgba = try VIPSImage.blank(width: 20, height: 20, bands: 4)
+        try rgba.draw(list)
+        XCTAssertEqual(try rgba.pixelValues(atX: 10, y: 10).alpha ?? 0, 255, accuracy: 1.0)
+    }
+
+    func testUnsupportedBandCountThrows() throws {
+        var list = VIPSDrawList()
+        list.addRect(x: 0, y: 0, width: 5, height: 5, color: .white)
+        let canvas = try VIPSImage.blank(width: 10, height: 10, bands: 2)
+        XCTAssertThrowsError(try canvas.draw(list))
+    }
+
+    func testEmptyListAndOffscreenShapes() throws {
+        let canvas = try VIPSImage.blank(width: 50, height: 50)
+        try canvas.draw(VIPSDrawList())
+
+        var list = VIPSDrawList()
+        list.addRect(x: -100, y: -100, width: 20, height: 20, color: .white, fill: true)
+        list.addLine(from: CGPoint(x: 500, y: 500), to: CGPoint(x: 600, y: 600), color: .white)
+        try canvas.draw(list)
+        XCTAssertEqual(try canvas.pixelValues(atX: 0, y: 0).red, 0, accuracy: 1.0)
+    }
+
+    // MARK: - Benchmark
+
+    private let canvasSize = 4096
+
+    private func makeAnnotations(count: Int) -> [(rect: CGRect, color: VIPSColor)] {
+        var generator = SeededGenerator(seed: UInt64(count))
+        let palette = [red, green, VIPSColor.white, VIPSColor(red: 0, green: 128, blue: 255)]
+        return (0..<count).map { i in
+            let x = Int.random(in: 0..<(canvasSize - 40), using: &generator)
+            let y = Int.random(in: 0..<(canvasSize - 40), using: &generator)
+            return (CGRect(x: x, y: y, width: 8 + i % 32, height: 8 + i % 24), palette[i % palette.count])
+        }
+    }
+
+    /// Draw each annotation's outline and diagonal with one call per shape.
+    private func drawChained(_ annotations: [(rect: CGRect, color: VIPSColor)]) throws -> VIPSImage {
+        let canvas = try VIPSImage.blank(width: canvasSize, height: canvasSize)
+        for annotation in annotations {
+            let r = annotation.rect
+            try canvas.drawRect(x: Int(r.minX), y: Int(r.minY), width: Int(r.width), height: Int(r.height),
+                                color: annotation.color)
+            try canvas.drawLine(from: CGPoint(x: r.minX, y: r.minY), to: CGPoint(x: r.maxX - 1, y: r.maxY - 1),
+                                color: annotation.color)
+        }
+        return canvas
+    }
+
+    /// Draw the same shapes as ``drawChained(_:)`` through a single draw list.
+    private func drawListed(_ annotations: [(rect: CGRect, color: VIPSColor)]) throws -> VIPSImage {
+        let canvas = try VIPSImage.blank(width: canvasSize, height: canvasSize)
+        var list = VIPSDrawList()
+        list.reserveCapacity(annotations.count * 2)
+        for annotation in annotations {
+            let r = annotation.rect
+            list.addRect(r, color: annotation.color)
+            list.addLine(from: CGPoint(x: r.minX, y: r.minY), to: CGPoint(x: r.maxX - 1, y: r.maxY - 1),
+                         color: annotation.color)
+        }
+        try canvas.draw(list)
+        return canvas
+    }
+
+    private func pixelBytes(_ image: VIPSImage) throws -> Data {
+        try image.withPixelData { Data(bytes: $0.data, count: $0.bytesPerRow * $0.height) }
+    }
+
+    func testDrawListMatchesChainedCallsAtScale() throws {
+        try skipUnlessLargeBenchmarking()
+        for count in [10_000, 100_000] {
+            let annotations = makeAnnotations(count: count)
+            XCTAssertEqual(try pixelBytes(drawListed(annotations)), try pixelBytes(drawChained(annotations)),
+                           "\(count) annotations")
+        }
+    }
+
+    func testPerformanceChainedDrawCalls() throws {
+        try skipUnlessLargeBenchmarking()
+        let annotations = makeAnnotations(count: 100_000)
+        measure {
+            XCTAssertNoThrow(try drawChained(annotations))
+        }
+    }
+
+    func testPerformanceDrawList() throws {
+        try skipUnlessLargeBenchmarking()
+        let annotations = makeAnnotations(count: 100_000)
+        measure {
+            XCTAssertNoThrow(try drawListed(annotations))
+        }
+    }
+}
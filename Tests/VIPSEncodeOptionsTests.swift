@@ -0,0 +1,123 @@
+import XCTest
+@testable import VIPSKit
+
+final class VIPSEncodeOptionsTests: VIPSImageTestCase {
+
+    private let presets: [(String, VIPSEncodeOptions)] = [
+        ("fastest", .fastest), ("balanced", .balanced), ("smallest", .smallest)
+    ]
+
+    private let formats: [VIPSImageFormat] = [.jpeg, .png, .webP, .jxl, .tiff]
+
+    func testEveryFormatAndPresetRoundTrips() throws {
+        let image = createTestImage(width: 120, height: 80)
+        for format in formats {
+            for (name, options) in presets {
+                let data = try image.data(format: format, options: options)
+                let loaded = try VIPSImage(data: data)
+                XCTAssertEqual(loaded.width, 120, "\(format) \(name)")
+                XCTAssertEqual(loaded.height, 80, "\(format) \(name)")
+            }
+        }
+    }
+
+    func testMetadataStripping() throws {
+        guard let path = pathForTestResource("test.jpg") else {
+            XCTFail("Test resource not found")
+            return
+        }
+        let image = try VIPSImage(contentsOfFile: path)
+        XCTAssertTrue(image.hasMetadata(named: "exif-data"))
+
+        var options = VIPSEncodeOptions()
+        let kept = try image.data(format: .jpeg, options: options)
+        options.metadata = .none
+        let stripped = try image.data(format: .jpeg, options: options)
+
+        XCTAssertTrue(try VIPSImage(data: kept).hasMetadata(named: "exif-data"))
+        XCTAssertFalse(try VIPSImage(data: stripped).hasMetadata(named: "exif-data"))
+        XCTAssertLessThan(stripped.count, kept.count)
+    }
+
+    func testSmallestPresetIsSmallerForLosslessFormats() throws {
+        let image = createTestImage(width: 400, height: 300)
+        for format in [VIPSImageFormat.png, .tiff] {
+            let fastest = try image.data(format: format, options: .fastest)
+            let smallest = try image.data(format: format, options: .smallest)
+            XCTAssertLessThanOrEqual(smallest.count, fastest.count, "\(format)")
+        }
+    }
+
+    func testPNGOutputIsLosslessAtEveryCompression() throws {
+        let image = createTestImage(width: 64, height: 64)
+        for (name, options) in presets {
+            let loaded = try VIPSImage(data: try image.data(format: .png, options: options))
+            XCTAssertEqual(try loaded.pixelValues(atX: 40, y: 20).red,
+                           try image.pixelValues(atX: 40, y: 20).red, accuracy: 0.5, name)
+        }
+    }
+
+    func testProgressiveJPEG() throws {
+        let image = createTestImage(width: 200, height: 200)
+        var options = VIPSEncodeOptions()
+        options.jpeg.progressive = true
+        let data = try image.data(format: .jpeg, options: options)
+        let loaded = try VIPSImage(data: data)
+        XCTAssertEqual(loaded.getInt(named: "interlaced"), 1)
+    }
+
+    func testTiledTIFF() throws {
+        let image = createTestImage(width: 300, height: 200)
+        var options = VIPSEncodeOptions()
+        options.tiff.compression = .deflate
+        options.tiff.tileSize = 64
+        let path = NSTemporaryDirectory() + "vipskit_test_options_\(UUID().uuidString).tif"
+        defer { try? FileManager.default.removeItem(atPath: path) }
+
+        try image.write(toFile: path, format: .tiff, options: options)
+        let loaded = try VIPSImage(contentsOfFile: path)
+        XCTAssertEqual(loaded.width, 300)
+        XCTAssertEqual(try loaded.pixelValues(atX: 150, y: 100).red,
+                       try image.pixelValues(atX: 150, y: 100).red, accuracy: 0.5)
+    }
+
+    func testUnsupportedFormatsThrow() {
+        let image = createTestImage(width: 10, height: 10)
+        for format in [VIPSImageFormat.heif, .avif, .gif, .unknown] {
+            XCTAssertThrowsError(try image.data(format: format, options: .balanced), "\(format)")
+        }
+    }
+
+    func testStreamingMatchesData() throws {
+        let image = createTestImage(width: 100, height: 100)
+        var streamed = Data()
+        try image.write(format: .webP, options: .fastest) { chunk in
+            streamed.append(contentsOf: chunk)
+        }
+        XCTAssertEqual(streamed, try image.data(format: .webP, options: .fastest))
+    }
+
+    func testEncodedAsync() async throws {
+        let data = try await createTestImage(width: 50, height: 50).encoded(format: .png, options: .smallest)
+        XCTAssertEqual(try VIPSImage(data: data).width, 50)
+    }
+
+    // MARK: - Benchmark
+
+    func testPerformanceEncodeOptionsMatrix() throws {
+        try skipUnlessBenchmarking()
+        guard let path = pathForTestResource("test.jpg") else {
+            XCTFail("Test resource not found")
+            return
+        }
+        let image = try VIPSImage(contentsOfFile: path).copiedToMemory()
+        // Each iteration encodes every format with every preset
+        measure {
+            for format in formats {
+                for (name, options) in presets {
+                    XCTAssertNoThrow(try image.data(format: format, options: options), "\(format) \(name)")
+                }
+            }
+        }
+    }
+}
@@ -24,6 +24,40 @@ final class VIPSImageAnalysisTests: VIPSImageTestCase {
         XCTAssertGreaterThan(stats.standardDeviation, 50.0)
     }
 
+    func testStatisticsPerBand() throws {
+        let image = createSolidColorImage(width: 10, height: 10, r: 200, g: 100, b: 50)
+        let stats = try image.statistics()
+        XCTAssertEqual(stats.bands.count, 3)
+        XCTAssertEqual(stats.bands[0].mean, 200.0)
+        XCTAssertEqual(stats.bands[1].min, 100.0)
+        XCTAssertEqual(stats.bands[2].max, 50.0)
+        XCTAssertEqual(stats.bands[0].sum, 200.0 * 100)
+        XCTAssertEqual(stats.min, 50.0)
+        XCTAssertEqual(stats.max, 200.0)
+    }
+
+    func testStatisticsEvaluatesPipelineOnce() throws {
+        let source = createTestImage(width: 200, height: 200)
+        let pipeline = try source.resize(scale: 0.5).grayscaled()
+        let (_, evaluations) = try pipeline.countingEvaluations {
+            try pipeline.statistics()
+        }
+        XCTAssertEqual(evaluations, 1)
+    }
+
+    func testPerformanceStatisticsOnLazyPipeline() throws {
+        try skipUnlessBenchmarking()
+        let originalMax = VIPSImage.Cache.maxOperations
+        VIPSImage.Cache.maxOperations = 0
+        defer { VIPSImage.Cache.maxOperations = originalMax }
+
+        let source = createTestImage(width: 2048, height: 2048)
+        measure {
+            let pipeline = try? source.resize(scale: 0.5).grayscaled()
+            _ = try? pipeline?.statistics()
+        }
+    }
+
     // MARK: - Average Color
 
     func testAverageColorBasic() throws {
@@ -124,6 +158,52 @@ final class VIPSImageAnalysisTests: VIPSImageTestCase {
         XCTAssertEqual(bg.blue, 200.0, accuracy: 1.0)
     }
 
+    // MARK: - Prominent Edge Colors
+
+    func testProminentEdgeColorsRanking() throws {
+        // Edge strips of width 10 hold 1900 white and 1700 red pixels
+        let image = createImageWithMargins(width: 100, height: 100, margin: 5,
+                                           contentR: 255, contentG: 0, contentB: 0,
+                                           bgR: 255, bgG: 255, bgB: 255)
+        let colors = try image.prominentEdgeColors(count: 3, stripWidth: 10)
+        XCTAssertEqual(colors.count, 2)
+        XCTAssertEqual(colors[0].color, VIPSColor(values: [255, 255, 255]))
+        XCTAssertEqual(colors[1].color, VIPSColor(values: [255, 0, 0]))
+        XCTAssertEqual(colors[0].coverage, 1900.0 / 3600.0, accuracy: 0.0001)
+        XCTAssertEqual(colors[0].coverage + colors[1].coverage, 1.0, accuracy: 0.0001)
+    }
+
+    func testProminentEdgeColorsLimit() throws {
+        let image = createHorizontalGradient(width: 256, height: 64,
+                                             startR: 0, startG: 0, startB: 0,
+                                             endR: 255, endG: 255, endB: 255)
+        XCTAssertEqual(try image.prominentEdgeColors(count: 3).count, 3)
+        XCTAssertTrue(try image.prominentEdgeColors(count: 0).isEmpty)
+    }
+
+    func testProminentEdgeColorsWithAlpha() throws {
+        let image = createSolidColorImage(width: 40, height: 40, r: 10, g: 20, b: 30, a: 200)
+        let colors = try image.prominentEdgeColors(count: 1)
+        XCTAssertEqual(colors.first?.color, VIPSColor(values: [10, 20, 30, 200]))
+        XCTAssertEqual(colors.first?.coverage, 1.0)
+    }
+
+    func testProminentEdgeColorsLargeImage() throws {
+        // Tall enough that rows are split across several worker threads
+        let image = createSolidColorImage(width: 600, height: 2000, r: 90, g: 180, b: 45)
+        let colors = try image.prominentEdgeColors(count: 2, stripWidth: 16)
+        XCTAssertEqual(colors.count, 1)
+        XCTAssertEqual(colors[0].color, VIPSColor(values: [90, 180, 45]))
+    }
+
+    func testPerformanceProminentEdgeColors() throws {
+        try skipUnlessBenchmarking()
+        let image = createTestImage(width: 3000, height: 2000)
+        measure {
+            _ = try? image.prominentEdgeColors(count: 5, stripWidth: 32)
+        }
+    }
+
     // MARK: - Find Trim
 
     func testFindTrimWhiteMargins() throws {
@@ -185,6 +265,94 @@ final class VIPSImageAnalysisTests: VIPSImageTestCase {
         XCTAssertEqual(bounds.height, 50, accuracy: 1)
     }
 
+    // MARK: - Comparison
+
+    func testDifferenceOfIdenticalImages() throws {
+        let image1 = createTestImage(width: 300, height: 200)
+        let image2 = createTestImage(width: 300, height: 200)
+        let diff = try image1.difference(from: image2)
+        XCTAssertTrue(diff.isIdentical)
+        XCTAssertFalse(diff.exceededLimit)
+        XCTAssertNil(diff.boundingBox)
+        XCTAssertTrue(try image1.matches(image2))
+    }
+
+    func testDifferenceFindsChangedTiles() throws {
+        let image1 = createTestImage(width: 300, height: 200)
+        let image2 = createTestImage(width: 300, height: 200)
+        // One change inside a single tile, one straddling the clipped right-hand edge tiles
+        try image2.drawRect(x: 130, y: 70, width: 10, height: 10, color: .black, fill: true)
+        try image2.drawRect(x: 290, y: 120, width: 10, height: 10, color: .black, fill: true)
+
+        let diff = try image1.difference(from: image2, tileSize: 64)
+        XCTAssertEqual(diff.changedTiles, [
+            CGRect(x: 128, y: 64, width: 64, height: 64),
+            CGRect(x: 256, y: 64, width: 44, height: 64),
+            CGRect(x: 256, y: 128, width: 44, height: 64),
+        ])
+        XCTAssertEqual(diff.boundingBox, CGRect(x: 128, y: 64, width: 172, height: 128))
+        XCTAssertFalse(try image1.matches(image2))
+    }
+
+    func testDifferenceTolerance() throws {
+        let image1 = createSolidColorImage(width: 100, height: 100, r: 100, g: 100, b: 100)
+        let image2 = createSolidColorImage(width: 100, height: 100, r: 104, g: 100, b: 100)
+        XCTAssertEqual(try image1.difference(from: image2, tileSize: 50).changedTiles.count, 4)
+        XCTAssertTrue(try image1.difference(from: image2, tolerance: 4).isIdentical)
+        XCTAssertFalse(try image1.matches(image2, tolerance: 3))
+    }
+
+    func testDifferenceStopsAtLimit() throws {
+        let image1 = createSolidColorImage(width: 512, height: 512, r: 0, g: 0, b: 0)
+        let image2 = createSolidColorImage(width: 512, height: 512, r: 255, g: 255, b: 255)
+        let diff = try image1.difference(from: image2, tileSize: 32, maxChangedTiles: 3)
+        // Workers already past the check may add a few more, so only the lower bound is exact
+        XCTAssertTrue(diff.exceededLimit)
+        XCTAssertGreaterThan(diff.changedTiles.count, 3)
+
+        let full = try image1.difference(from: image2, tileSize: 32)
+        XCTAssertFalse(full.exceededLimit)
+        XCTAssertEqual(full.changedTiles.count, 256)
+    }
+
+    func testDifferenceOfMismatchedImagesThrows() {
+        let image1 = createTestImage(width: 100, height: 100)
+        XCTAssertThrowsError(try image1.difference(from: createTestImage(width: 100, height: 90)))
+        XCTAssertThrowsError(try image1.difference(from: createTestImage(width: 100, height: 100, bands: 4)))
+        XCTAssertThrowsError(try image1.difference(from: image1, tileSize: 0))
+    }
+
+    func testDifferenceOfNonUcharImages() throws {
+        // Subtraction produces signed pixels, which are compared as float
+        let image = createTestImage(width: 80, height: 80)
+        let zero = try image.subtract(image)
+        XCTAssertTrue(try zero.difference(from: image.subtract(image)).isIdentical)
+        XCTAssertFalse(try zero.matches(image))
+    }
+
+    private func makeNearlyIdenticalPair() throws -> (VIPSImage, VIPSImage) {
+        let image1 = createTestImage(width: 4096, height: 4096)
+        let image2 = createTestImage(width: 4096, height: 4096)
+        try image2.drawRect(x: 10, y: 10, width: 4, height: 4, color: .black, fill: true)
+        return (image1, image2)
+    }
+
+    func testPerformanceDifferenceByStatistics() throws {
+        try skipUnlessBenchmarking()
+        let (image1, image2) = try makeNearlyIdenticalPair()
+        measure {
+            XCTAssertGreaterThan(try image1.subtract(image2).absolute().statistics().max, 0)
+        }
+    }
+
+    func testPerformanceMatches() throws {
+        try skipUnlessBenchmarking()
+        let (image1, image2) = try makeNearlyIdenticalPair()
+        measure {
+            XCTAssertFalse(try image1.matches(image2))
+        }
+    }
+
     // MARK: - Arithmetic
 
     func testSubtractIdenticalImages() throws {
@@ -72,6 +72,69 @@ final class VIPSImageColorTests: VIPSImageTestCase {
         XCTAssertEqual(adjusted.width, 100)
     }
 
+    func testAdjustToneMatchesFloatChain() throws {
+        let image = createTestImage(width: 100, height: 100)
+        let tone = try image.adjustTone(brightness: 0.1, contrast: 1.2)
+        let chain = try image.adjust(brightness: 0.1, contrast: 1.2)
+        let toneGamma = try image.adjustTone(gamma: 0.8)
+        let chainGamma = try image.adjustGamma(0.8)
+        for (x, y) in [(0, 0), (30, 70), (99, 99)] {
+            let expected = try chain.pixelValues(atX: x, y: y)
+            let actual = try tone.pixelValues(atX: x, y: y)
+            XCTAssertEqual(actual.red, min(255, max(0, expected.red)), accuracy: 1.0)
+            XCTAssertEqual(actual.green, min(255, max(0, expected.green)), accuracy: 1.0)
+            XCTAssertEqual(actual.blue, min(255, max(0, expected.blue)), accuracy: 1.0)
+            XCTAssertEqual(try toneGamma.pixelValues(atX: x, y: y).red,
+                           try chainGamma.pixelValues(atX: x, y: y).red, accuracy: 1.0)
+        }
+    }
+
+    func testAdjustToneLeavesAlphaUntouched() throws {
+        let image = createTestImage(width: 50, height: 50, bands: 4)
+        let tone = try image.adjustTone(brightness: 0.3, contrast: 1.5, gamma: 2.0, saturation: 1.8)
+        XCTAssertEqual(tone.bands, 4)
+        XCTAssertEqual(try tone.pixelValues(atX: 20, y: 20)[3], 200)
+    }
+
+    func testAdjustToneDesaturates() throws {
+        let image = createSolidColorImage(width: 20, height: 20, r: 200, g: 50, b: 100)
+        let gray = try image.adjustTone(saturation: 0).pixelValues(atX: 5, y: 5)
+        XCTAssertEqual(gray.red, gray.green, accuracy: 1.0)
+        XCTAssertEqual(gray.green, gray.blue, accuracy: 1.0)
+        // Rec. 601 luma of (200, 50, 100)
+        XCTAssertEqual(gray.red, 100, accuracy: 1.0)
+    }
+
+    func testAdjustToneIdentity() throws {
+        let image = createTestImage(width: 40, height: 40)
+        let tone = try image.adjustTone()
+        XCTAssertEqual(try tone.pixelValues(atX: 17, y: 23).red, try image.pixelValues(atX: 17, y: 23).red)
+    }
+
+    func testAdjustToneFallsBackForFloatImages() throws {
+        let float = try createTestImage(width: 30, height: 30).adjustBrightness(0)
+        let tone = try float.adjustTone(contrast: 1.1, gamma: 1.2)
+        XCTAssertEqual(tone.width, 30)
+        XCTAssertThrowsError(try float.adjustTone(gamma: 0))
+
+        // Gamma comes before saturation, as in the 8-bit lookup table
+        let toned = try float.adjustTone(contrast: 1.1, gamma: 1.2, saturation: 1.4)
+        let chained = try float.adjust(contrast: 1.1).adjustGamma(1.2).adjustSaturation(1.4)
+        XCTAssertEqual(try toned.pixelValues(atX: 12, y: 21).values, try chained.pixelValues(atX: 12, y: 21).values)
+    }
+
+    func testAdjustToneLeavesCMYKBlackUntouched() throws {
+        let samples: [UInt8] = [40, 80, 120, 200]
+        let cmyk = try samples.withUnsafeBytes { bytes in
+            try VIPSImage(noCopyBuffer: bytes, width: 1, height: 1, bands: 4, interpretation: .cmyk,
+                          owner: NSData()).copiedToMemory()
+        }
+        let tone = try cmyk.adjustTone(brightness: 0.1, contrast: 1.2, gamma: 0.9)
+        let values = try tone.pixelValues(atX: 0, y: 0).values
+        XCTAssertEqual(values[3], 200)
+        XCTAssertNotEqual(values[0], 40)
+    }
+
     // MARK: - Async
 
     func testAsyncGrayscaled() async throws {
@@ -124,4 +187,33 @@ final class VIPSImageColorTests: VIPSImageTestCase {
         let adjusted = try await image.adjusted(brightness: 0.1, contrast: 1.2, saturation: 1.1)
         XCTAssertEqual(adjusted.width, 100)
     }
+
+    func testAsyncToneAdjusted() async throws {
+        let image = createTestImage(width: 100, height: 100)
+        let adjusted = try await image.toneAdjusted(brightness: 0.1, contrast: 1.2, gamma: 0.9, saturation: 1.1)
+        XCTAssertEqual(adjusted.width, 100)
+    }
+
+    // MARK: - Benchmark
+
+    // XCTMemoryMetric records the process's peak physical memory for each
+    // iteration, which libvips' own high-water mark cannot be reset to show.
+
+    func testPerformanceToneAdjust() throws {
+        try skipUnlessBenchmarking()
+        let image = try createTestImage(width: 4000, height: 3000).copiedToMemory()
+        measure(metrics: [XCTClockMetric(), XCTMemoryMetric()]) {
+            XCTAssertNoThrow(try image.adjustTone(brightness: 0.1, contrast: 1.2, gamma: 0.9, saturation: 1.3)
+                .copiedToMemory())
+        }
+    }
+
+    func testPerformanceToneAdjustFloatChain() throws {
+        try skipUnlessBenchmarking()
+        let image = try createTestImage(width: 4000, height: 3000).copiedToMemory()
+        measure(metrics: [XCTClockMetric(), XCTMemoryMetric()]) {
+            XCTAssertNoThrow(try image.adjust(brightness: 0.1, contrast: 1.2).adjustGamma(0.9)
+                .adjustSaturation(1.3).copiedToMemory())
+        }
+    }
 }
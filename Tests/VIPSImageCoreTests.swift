@@ -173,6 +173,57 @@ final class VIPSImageCoreTests: VIPSImageTestCase {
         }
     }
 
+    func testWithPixelDataIsZeroCopyForMemoryImage() throws {
+        let image = createTestImage(width: 20, height: 20)
+        let first = try image.withPixelData { UnsafeRawPointer($0.data) }
+        let second = try image.withPixelData { UnsafeRawPointer($0.data) }
+        // The same resident buffer is handed out each time rather than a fresh copy
+        XCTAssertEqual(first, second)
+    }
+
+    func testWithPixelDataConvertsLazyImage() throws {
+        let image = try createSolidColorImage(width: 10, height: 10, r: 100, g: 100, b: 100)
+            .adjustBrightness(0.1)
+        try image.withPixelData { buffer in
+            XCTAssertEqual(buffer.bands, 3)
+            XCTAssertEqual(buffer.bytesPerRow, 30)
+            XCTAssertEqual(Int(buffer.data[0]), 125, accuracy: 1)
+        }
+    }
+
+    // MARK: - Pixel Stripes
+
+    func testForEachPixelStripeCoversImage() throws {
+        let image = createTestImage(width: 30, height: 50)
+        var origins: [Int] = []
+        var rows = 0
+        try image.forEachPixelStripe(rowsPerStripe: 16) { buffer, y in
+            XCTAssertEqual(buffer.width, 30)
+            XCTAssertEqual(buffer.bands, 3)
+            XCTAssertGreaterThanOrEqual(buffer.bytesPerRow, 90)
+            origins.append(y)
+            rows += buffer.height
+        }
+        XCTAssertEqual(origins, [0, 16, 32, 48])
+        XCTAssertEqual(rows, 50)
+    }
+
+    func testForEachPixelStripeMatchesPixelValues() throws {
+        let image = createTestImage(width: 40, height: 40)
+        try image.forEachPixelStripe(rowsPerStripe: 7) { buffer, y in
+            let row = buffer.height - 1
+            let expected = try image.pixelValues(atX: 39, y: y + row)
+            let offset = row * buffer.bytesPerRow + 39 * buffer.bands
+            XCTAssertEqual(Double(buffer.data[offset]), expected.red)
+            XCTAssertEqual(Double(buffer.data[offset + 1]), expected.green)
+        }
+    }
+
+    func testForEachPixelStripeInvalidHeightThrows() {
+        let image = createTestImage(width: 10, height: 10)
+        XCTAssertThrowsError(try image.forEachPixelStripe(rowsPerStripe: 0) { _, _ in })
+    }
+
     // MARK: - Properties from Real Images
 
     func testPropertiesFromJPEG() throws {
@@ -0,0 +1,115 @@
+import XCTest
+@testable import VIPSKit
+
+final class VIPSImageHashTests: VIPSImageTestCase {
+
+    private let algorithms: [VIPSImageHash.Algorithm] = [.average, .difference, .perceptual]
+
+    func testIdenticalImagesHashEqually() throws {
+        for algorithm in algorithms {
+            let hash1 = try createTestImage(width: 200, height: 150).perceptualHash(algorithm: algorithm)
+            let hash2 = try createTestImage(width: 200, height: 150).perceptualHash(algorithm: algorithm)
+            XCTAssertEqual(hash1, hash2)
+            XCTAssertEqual(hash1.distance(to: hash2), 0)
+            XCTAssertEqual(hash1.algorithm, algorithm)
+        }
+    }
+
+    func testHashSurvivesResizeAndRecompression() throws {
+        guard let path = pathForTestResource("test.jpg") else {
+            XCTFail("Test resource not found")
+            return
+        }
+        let original = try VIPSImage(contentsOfFile: path)
+        let jpeg = try original.resize(scale: 0.5).data(format: .jpeg, quality: 60)
+        for algorithm in algorithms {
+            let hash = try original.perceptualHash(algorithm: algorithm)
+            let altered = try VIPSImage.perceptualHash(fromData: jpeg, algorithm: algorithm)
+            XCTAssertLessThanOrEqual(hash.distance(to: altered), 5, "\(algorithm)")
+        }
+    }
+
+    func testDifferentImagesHashFurtherApart() throws {
+        let gradient = createTestImage(width: 200, height: 200)
+        let copy = try VIPSImage(data: try gradient.data(format: .jpeg, quality: 70))
+        let circle = try VIPSImage.blank(width: 200, height: 200)
+            .drawCircle(cx: 100, cy: 100, radius: 50, color: .white, fill: true)
+        for algorithm in algorithms {
+            let hash = try gradient.perceptualHash(algorithm: algorithm)
+            let copyDistance = hash.distance(to: try copy.perceptualHash(algorithm: algorithm))
+            let circleDistance = hash.distance(to: try circle.perceptualHash(algorithm: algorithm))
+            XCTAssertGreaterThan(circleDistance, copyDistance, "\(algorithm)")
+        }
+    }
+
+    func testHashFromFileMatchesDecodedImage() throws {
+        guard let path = pathForTestResource("test.jpg") else {
+            XCTFail("Test resource not found")
+            return
+        }
+        let fromFile = try VIPSImage.perceptualHash(fromFile: path, algorithm: .perceptual)
+        let fromImage = try VIPSImage(contentsOfFile: path).perceptualHash(algorithm: .perceptual)
+        XCTAssertLessThanOrEqual(fromFile.distance(to: fromImage), 4)
+    }
+
+    func testHashIgnoresAlphaAndBandCount() throws {
+        let rgba = createSolidColorImage(width: 64, height: 64, r: 10, g: 20, b: 30, a: 255)
+        let gray = createTestImage(width: 64, height: 64, bands: 1)
+        XCTAssertNoThrow(try rgba.perceptualHash())
+        XCTAssertNoThrow(try gray.perceptualHash(algorithm: .perceptual))
+    }
+
+    func testDescription() {
+        XCTAssertEqual(VIPSImageHash(value: 0xAB, algorithm: .difference).description, "00000000000000ab")
+    }
+
+    func testBatchDistances() {
+        let query: UInt64 = 0b1011
+        let hashes: [UInt64] = [0b1011, 0b1010, 0, .max, 0b0100]
+        XCTAssertEqual(VIPSImageHash.distances(from: query, to: hashes), [0, 1, 3, 61, 4])
+        XCTAssertEqual(VIPSImageHash.indices(of: hashes, within: 3, of: query), [0, 1, 2])
+        XCTAssertEqual(VIPSImageHash.indices(of: hashes, within: -1, of: query), [])
+        XCTAssertEqual(VIPSImageHash.distances(from: query, to: []), [])
+    }
+
+    func testHashAsync() async throws {
+        let hash = try await createTestImage(width: 100, height: 100).perceptualHash(algorithm: .average)
+        XCTAssertEqual(hash.algorithm, .average)
+    }
+
+    // MARK: - Benchmark
+
+    private func makeRandomHashes(count: Int) -> [UInt64] {
+        var generator = SeededGenerator(seed: 7)
+        return (0..<count).map { _ in UInt64.random(in: .min ... .max, using: &generator) }
+    }
+
+    func testBatchSearchMatchesLoop() {
+        let hashes = makeRandomHashes(count: 10_000)
+        let query = hashes[1234]
+        let expected = hashes.indices.filter { (query ^ hashes[$0]).nonzeroBitCount <= 20 }
+        XCTAssertGreaterThan(expected.count, 1)
+        XCTAssertEqual(VIPSImageHash.indices(of: hashes, within: 20, of: query), expected)
+    }
+
+    func testPerformanceBatchHammingSearch() throws {
+        try skipUnlessBenchmarking()
+        let hashes = makeRandomHashes(count: 1_000_000)
+        let query = hashes[12345]
+        measure {
+            XCTAssertFalse(VIPSImageHash.indices(of: hashes, within: 10, of: query).isEmpty)
+        }
+    }
+
+    func testPerformanceHashFromData() throws {
+        try skipUnlessBenchmarking()
+        let sources = try (0..<20).map { i in
+            try createSolidColorImage(width: 2000, height: 1500, r: UInt8(i * 10), g: 80, b: 160).data(format: .jpeg)
+        }
+        measure {
+            for source in sources {
+                XCTAssertNoThrow(try VIPSImage.perceptualHash(fromData: source, algorithm: .perceptual))
+            }
+        }
+    }
+}
@@ -238,6 +238,99 @@ final class VIPSImageLoadingTests: VIPSImageTestCase {
         XCTAssertEqual(info.format, .tiff)
     }
 
+    // MARK: - Header Probing
+
+    func testHeaderAtPath() throws {
+        guard let path = pathForTestResource("test-rgba.png") else {
+            XCTFail("Test resource test-rgba.png not found")
+            return
+        }
+        let header = try VIPSImage.header(atPath: path)
+        let image = try VIPSImage(contentsOfFile: path)
+        XCTAssertEqual(header.width, image.width)
+        XCTAssertEqual(header.height, image.height)
+        XCTAssertEqual(header.bands, 4)
+        XCTAssertEqual(header.pageCount, 1)
+        XCTAssertNil(header.orientation)
+        XCTAssertEqual(header.format, .png)
+    }
+
+    func testHeaderReportsOrientation() throws {
+        guard let path = pathForTestResource("rotated-6.jpg") else {
+            XCTFail("Test resource rotated-6.jpg not found")
+            return
+        }
+        let header = try VIPSImage.header(atPath: path)
+        XCTAssertEqual(header.orientation, 6)
+        XCTAssertEqual(header.format, .jpeg)
+    }
+
+    func testHeaderFromData() throws {
+        let data = try createTestImage(width: 321, height: 123).data(format: .webP)
+        let header = try VIPSImage.header(data: data)
+        XCTAssertEqual(header.width, 321)
+        XCTAssertEqual(header.height, 123)
+        XCTAssertEqual(header.bands, 3)
+        XCTAssertEqual(header.format, .webP)
+    }
+
+    func testHeaderOfInvalidInputThrows() {
+        XCTAssertThrowsError(try VIPSImage.header(atPath: "/nonexistent/vipskit_header.jpg"))
+        XCTAssertThrowsError(try VIPSImage.header(data: Data([0x00, 0x01, 0x02, 0x03])))
+    }
+
+    func testHeadersInParallel() throws {
+        let paths = ["test.jpg", "test.gif", "test.tiff", "test.webp"].compactMap { pathForTestResource($0) }
+        XCTAssertEqual(paths.count, 4)
+
+        let results = VIPSImage.headers(atPaths: paths + ["/nonexistent/vipskit_header.jpg"])
+        XCTAssertEqual(results.count, 5)
+        XCTAssertEqual(try results[1].get().format, .gif)
+        XCTAssertEqual(try results[2].get().format, .tiff)
+        for (path, result) in zip(paths, results) {
+            XCTAssertEqual(try result.get(), try VIPSImage.header(atPath: path))
+        }
+        if case .success = results[4] { XCTFail("Expected a failure for a missing file") }
+    }
+
+    private func makeProbeFiles() throws -> (directory: String, paths: [String]) {
+        let directory = NSTemporaryDirectory() + "vipskit_bench_headers_\(UUID().uuidString)/"
+        try FileManager.default.createDirectory(atPath: directory, withIntermediateDirectories: true)
+        let data = try createTestImage(width: 1024, height: 768).data(format: .jpeg)
+        let paths = (0..<400).map { directory + "image_\($0).jpg" }
+        for path in paths {
+            FileManager.default.createFile(atPath: path, contents: data)
+        }
+        return (directory, paths)
+    }
+
+    func testPerformanceSequentialLoadForHeaders() throws {
+        try skipUnlessBenchmarking()
+        let (directory, paths) = try makeProbeFiles()
+        defer { try? FileManager.default.removeItem(atPath: directory) }
+        measure {
+            for path in paths { _ = try? VIPSImage(contentsOfFileSequential: path).width }
+        }
+    }
+
+    func testPerformanceHeaderProbe() throws {
+        try skipUnlessBenchmarking()
+        let (directory, paths) = try makeProbeFiles()
+        defer { try? FileManager.default.removeItem(atPath: directory) }
+        measure {
+            for path in paths { _ = try? VIPSImage.header(atPath: path) }
+        }
+    }
+
+    func testPerformanceParallelHeaderProbe() throws {
+        try skipUnlessBenchmarking()
+        let (directory, paths) = try makeProbeFiles()
+        defer { try? FileManager.default.removeItem(atPath: directory) }
+        measure {
+            _ = VIPSImage.headers(atPaths: paths)
+        }
+    }
+
     // MARK: - Thumbnail From Various Formats
 
     func testThumbnailFromPNG() throws {
@@ -280,6 +373,94 @@ final class VIPSImageLoadingTests: VIPSImageTestCase {
         XCTAssertEqual(thumb.bands, 4)
     }
 
+    // MARK: - Stream Loading
+
+    /// A read closure serving `data` in chunks of at most `chunkSize` bytes.
+    private func makeReader(for data: Data, chunkSize: Int = 4096) -> @Sendable (UnsafeMutableRawBufferPointer) throws -> Int {
+        let counter = ByteCounter()
+        return { buffer in
+            let offset = counter.value
+            let count = min(buffer.count, chunkSize, data.count - offset)
+            guard count > 0 else { return 0 }
+            data.copyBytes(to: buffer.bindMemory(to: UInt8.self).baseAddress!, from: offset..<(offset + count))
+            counter.add(count)
+            return count
+        }
+    }
+
+    func testLoadFromFileDescriptor() throws {
+        let path = NSTemporaryDirectory() + "vipskit_test_descriptor_load.png"
+        defer { try? FileManager.default.removeItem(atPath: path) }
+        try createTestImage(width: 90, height: 60).write(toFile: path)
+
+        let descriptor = open(path, O_RDONLY)
+        XCTAssertGreaterThanOrEqual(descriptor, 0)
+        defer { close(descriptor) }
+        let image = try VIPSImage(fileDescriptor: descriptor)
+        XCTAssertEqual(image.width, 90)
+        XCTAssertEqual(image.height, 60)
+        XCTAssertEqual(image.sourceFormat, .png)
+    }
+
+    func testLoadFromPipe() throws {
+        let data = try createTestImage(width: 200, height: 100).data(format: .jpeg)
+        let pipe = Pipe()
+        let writer = Thread {
+            pipe.fileHandleForWriting.write(data)
+            try? pipe.fileHandleForWriting.close()
+        }
+        writer.start()
+
+        let image = try VIPSImage(fileDescriptor: pipe.fileHandleForReading.fileDescriptor, sequential: true)
+        let copy = try image.copiedToMemory()
+        XCTAssertEqual(copy.width, 200)
+        XCTAssertEqual(copy.sourceFormat, .jpeg)
+    }
+
+    func testLoadFromReader() throws {
+        let source = createTestImage(width: 150, height: 120)
+        let data = try source.data(format: .png)
+        let image = try VIPSImage(reader: makeReader(for: data, chunkSize: 1000))
+        XCTAssertEqual(image.width, 150)
+        XCTAssertEqual(try image.pixelValues(atX: 75, y: 60), try source.pixelValues(atX: 75, y: 60))
+    }
+
+    func testReaderErrorIsRethrown() {
+        struct ConnectionReset: Error {}
+        XCTAssertThrowsError(try VIPSImage(reader: { _ in throw ConnectionReset() })) { error in
+            XCTAssertTrue(error is ConnectionReset)
+        }
+    }
+
+    func testTruncatedReaderThrows() throws {
+        let data = try createTestImage(width: 50, height: 50).data(format: .png)
+        XCTAssertThrowsError(try VIPSImage(reader: makeReader(for: data.prefix(8))).copiedToMemory())
+    }
+
+    func testThumbnailFromReader() throws {
+        let data = try createTestImage(width: 2000, height: 1000).data(format: .jpeg)
+        let thumb = try VIPSImage.thumbnail(fromReader: makeReader(for: data), width: 100, height: 100)
+        XCTAssertEqual(thumb.width, 100)
+        XCTAssertEqual(thumb.height, 50)
+    }
+
+    func testThumbnailFromFileDescriptor() throws {
+        let path = NSTemporaryDirectory() + "vipskit_test_descriptor_thumb.jpg"
+        defer { try? FileManager.default.removeItem(atPath: path) }
+        try createTestImage(width: 400, height: 400).write(toFile: path)
+
+        let descriptor = open(path, O_RDONLY)
+        defer { close(descriptor) }
+        let thumb = try VIPSImage.thumbnail(fromFileDescriptor: descriptor, width: 64, height: 64)
+        XCTAssertEqual(thumb.width, 64)
+    }
+
+    func testAsyncLoadedFromReader() async throws {
+        let data = try createTestImage(width: 80, height: 40).data(format: .png)
+        let image = try await VIPSImage.loaded(fromReader: makeReader(for: data))
+        XCTAssertEqual(image.width, 80)
+    }
+
     // MARK: - Async
 
     func testAsyncLoadedFromFile() async throws {
@@ -319,6 +500,19 @@ final class VIPSImageLoadingTests: VIPSImageTestCase {
         XCTAssertEqual(info.format, .jpeg)
     }
 
+    func testAsyncHeaders() async throws {
+        let data = try createTestImage(width: 30, height: 20).data(format: .png)
+        let header = try await VIPSImage.header(data: data)
+        XCTAssertEqual(header.width, 30)
+
+        guard let path = pathForTestResource("test.jpg") else {
+            XCTFail("Test resource test.jpg not found")
+            return
+        }
+        let results = await VIPSImage.headers(atPaths: [path, path])
+        XCTAssertEqual(results.count, 2)
+    }
+
     func testAsyncThumbnailFromFile() async throws {
         guard let path = pathForTestResource("superman.jpg") else {
             XCTFail("Test resource not found")
@@ -353,3 +547,21 @@ final class VIPSImageLoadingTests: VIPSImageTestCase {
         XCTAssertLessThanOrEqual(thumb.width, 50)
     }
 }
+
+/// A thread-safe running byte count shared with a read closure.
+private final class ByteCounter: @unchecked Sendable {
+    private let lock = NSLock()
+    private var count = 0
+
+    var value: Int {
+        lock.lock()
+        defer { lock.unlock() }
+        return count
+    }
+
+    func add(_ bytes: Int) {
+        lock.lock()
+        count += bytes
+        lock.unlock()
+    }
+}
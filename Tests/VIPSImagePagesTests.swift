@@ -0,0 +1,179 @@
+import XCTest
+@testable import VIPSKit
+
+final class VIPSImagePagesTests: VIPSImageTestCase {
+
+    private var directory: URL!
+
+    override func setUp() {
+        super.setUp()
+        directory = URL(fileURLWithPath: NSTemporaryDirectory())
+            .appendingPathComponent("vipskit_test_pages_\(UUID().uuidString)")
+        try? FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+    }
+
+    override func tearDown() {
+        try? FileManager.default.removeItem(at: directory)
+        super.tearDown()
+    }
+
+    /// Write a multi-page TIFF where page `i` is a solid gray of value `i * 20`.
+    private func makeMultiPageFile(pages: Int, width: Int = 120, height: Int = 80) throws -> String {
+        let frames = (0..<pages).map { i in
+            createSolidColorImage(width: width, height: height, r: UInt8(i * 20), g: UInt8(i * 20), b: UInt8(i * 20))
+        }
+        let path = directory.appendingPathComponent("pages.tif").path
+        try VIPSImage.joiningPages(frames).write(toFile: path)
+        return path
+    }
+
+    func testJoiningPagesSetsPageMetadata() throws {
+        let frames = (0..<3).map { _ in createTestImage(width: 40, height: 30) }
+        let joined = try VIPSImage.joiningPages(frames)
+        XCTAssertEqual(joined.width, 40)
+        XCTAssertEqual(joined.height, 90)
+        XCTAssertEqual(joined.pageCount, 3)
+        XCTAssertEqual(joined.pageHeight, 30)
+    }
+
+    func testJoiningPagesRequiresMatchingSizes() {
+        let frames = [createTestImage(width: 40, height: 30), createTestImage(width: 40, height: 31)]
+        XCTAssertThrowsError(try VIPSImage.joiningPages(frames))
+        XCTAssertThrowsError(try VIPSImage.joiningPages([]))
+    }
+
+    func testLoadPageRangeFromFile() throws {
+        let path = try makeMultiPageFile(pages: 5)
+        XCTAssertEqual(try VIPSImage.header(atPath: path).pageCount, 5)
+
+        let image = try VIPSImage(contentsOfFile: path, pages: 2..<4)
+        XCTAssertEqual(image.width, 120)
+        XCTAssertEqual(image.height, 160)
+        XCTAssertEqual(image.pageHeight, 80)
+        XCTAssertEqual(try image.pixelValues(atX: 10, y: 10).red, 40, accuracy: 1.0)
+        XCTAssertEqual(try image.pixelValues(atX: 10, y: 90).red, 60, accuracy: 1.0)
+    }
+
+    func testLoadPageRangeFromData() throws {
+        let data = try Data(contentsOf: URL(fileURLWithPath: try makeMultiPageFile(pages: 4)))
+        let image = try VIPSImage(data: data, pages: 3..<4)
+        XCTAssertEqual(image.height, 80)
+        XCTAssertEqual(try image.pixelValues(atX: 0, y: 0).red, 60, accuracy: 1.0)
+    }
+
+    func testInvalidRangesThrow() throws {
+        let path = try makeMultiPageFile(pages: 2)
+        XCTAssertThrowsError(try VIPSImage(contentsOfFile: path, pages: 1..<1))
+        XCTAssertThrowsError(try VIPSImage(contentsOfFile: path, pages: -1..<1))
+        XCTAssertThrowsError(try VIPSImage(contentsOfFile: path, pages: 1..<5))
+    }
+
+    func testSinglePageFormatsOnlyAcceptFirstPage() throws {
+        let data = try createTestImage(width: 50, height: 40).data(format: .png)
+        XCTAssertEqual(try VIPSImage(data: data, pages: 0..<1).height, 40)
+        XCTAssertThrowsError(try VIPSImage(data: data, pages: 1..<2))
+    }
+
+    func testThumbnailPageRange() throws {
+        let path = try makeMultiPageFile(pages: 4, width: 400, height: 200)
+        let thumbnail = try VIPSImage.thumbnail(fromFile: path, width: 100, height: 100, pages: 1..<3)
+        XCTAssertEqual(thumbnail.width, 100)
+        XCTAssertEqual(thumbnail.pageHeight, 50)
+        XCTAssertEqual(thumbnail.height, 100)
+        XCTAssertEqual(try thumbnail.pixelValues(atX: 50, y: 75).red, 40, accuracy: 1.0)
+
+        let data = try Data(contentsOf: URL(fileURLWithPath: path))
+        let single = try VIPSImage.thumbnail(fromData: data, width: 100, height: 100, pages: 3..<4)
+        XCTAssertEqual(single.height, 50)
+        XCTAssertEqual(try single.pixelValues(atX: 50, y: 25).red, 60, accuracy: 1.0)
+    }
+
+    func testMapPagesPreservesOrder() throws {
+        let path = try makeMultiPageFile(pages: 6)
+        let mapped = try VIPSImage.mapPages(ofFile: path, maxConcurrency: 3) { page, _ in
+            XCTAssertEqual(page.height, 80)
+            return try page.resize(scale: 0.5)
+        }
+        XCTAssertEqual(mapped.count, 6)
+        for (index, page) in mapped.enumerated() {
+            XCTAssertEqual(page.width, 60)
+            XCTAssertEqual(try page.pixelValues(atX: 5, y: 5).red, Double(index * 20), accuracy: 1.0)
+        }
+
+        let joined = try VIPSImage.joiningPages(mapped)
+        XCTAssertEqual(joined.pageCount, 6)
+        XCTAssertEqual(joined.pageHeight, 40)
+    }
+
+    func testMapPagesSubrangeAndErrors() throws {
+        let data = try Data(contentsOf: URL(fileURLWithPath: try makeMultiPageFile(pages: 5)))
+        let subrange = try VIPSImage.mapPages(ofData: data, pages: 1..<3) { page, _ in page }
+        XCTAssertEqual(subrange.count, 2)
+        XCTAssertEqual(try subrange[0].pixelValues(atX: 0, y: 0).red, 20, accuracy: 1.0)
+
+        XCTAssertThrowsError(try VIPSImage.mapPages(ofData: data) { page, index in
+            if index == 3 { throw VIPSError("Page \(index) failed") }
+            return page
+        })
+    }
+
+    func testMapPagesDecodesAnimatedFramesOnce() throws {
+        let frames = (0..<5).map { i in
+            createSolidColorImage(width: 60, height: 40, r: UInt8(i * 40), g: UInt8(i * 40), b: UInt8(i * 40))
+        }
+        let data = try VIPSImage.joiningPages(frames).data(format: .webP, lossless: true)
+        XCTAssertEqual(try VIPSImage.header(data: data).pageCount, 5)
+
+        VIPSProfiler.reset()
+        VIPSProfiler.isEnabled = true
+        defer {
+            VIPSProfiler.isEnabled = false
+            VIPSProfiler.reset()
+        }
+        let mapped = try VIPSImage.mapPages(ofData: data, pages: 1..<5, maxConcurrency: 4) { page, _ in page }
+        let loads = VIPSProfiler.snapshot().events.filter { $0.name == "image_new_from_buffer_pages" }
+        XCTAssertEqual(loads.count, 1)
+
+        XCTAssertEqual(mapped.count, 4)
+        for (offset, page) in mapped.enumerated() {
+            XCTAssertEqual(page.height, 40)
+            XCTAssertEqual(try page.pixelValues(atX: 30, y: 20).red, Double((offset + 1) * 40), accuracy: 1.0)
+        }
+        XCTAssertEqual(try VIPSImage.joiningPages(mapped).pageCount, 4)
+    }
+
+    func testMapPagesAsync() async throws {
+        let path = try makeMultiPageFile(pages: 3)
+        let mapped = try await VIPSImage.mapPages(ofFile: path) { page, _ in try page.inverted() }
+        XCTAssertEqual(mapped.count, 3)
+        XCTAssertEqual(try mapped[0].pixelValues(atX: 0, y: 0).red, 255, accuracy: 1.0)
+
+        let loaded = try await VIPSImage.loaded(fromFile: path, pages: 1..<2)
+        XCTAssertEqual(loaded.height, 80)
+    }
+
+    // MARK: - Benchmark
+
+    func testPerformanceSerialPageProcessing() throws {
+        try skipUnlessBenchmarking()
+        let path = try makeMultiPageFile(pages: 24, width: 1200, height: 900)
+        measure {
+            guard let full = try? VIPSImage(contentsOfFile: path, pages: 0..<24) else {
+                return XCTFail("Could not load the pages")
+            }
+            for index in 0..<24 {
+                XCTAssertNoThrow(try full.crop(x: 0, y: index * 900, width: 1200, height: 900)
+                    .resize(scale: 0.25).copiedToMemory())
+            }
+        }
+    }
+
+    func testPerformanceMapPages() throws {
+        try skipUnlessBenchmarking()
+        let path = try makeMultiPageFile(pages: 24, width: 1200, height: 900)
+        measure {
+            let mapped = try? VIPSImage.mapPages(ofFile: path) { page, _ in try page.resize(scale: 0.25) }
+            XCTAssertEqual(mapped?.count, 24)
+        }
+    }
+}
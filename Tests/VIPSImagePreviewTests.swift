@@ -0,0 +1,186 @@
+import XCTest
+import CoreGraphics
+@testable import VIPSKit
+
+final class VIPSImagePreviewTests: VIPSImageTestCase {
+
+    private var directory: URL!
+
+    override func setUp() {
+        super.setUp()
+        directory = URL(fileURLWithPath: NSTemporaryDirectory())
+            .appendingPathComponent("vipskit_test_preview_\(UUID().uuidString)")
+        try? FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+    }
+
+    override func tearDown() {
+        try? FileManager.default.removeItem(at: directory)
+        super.tearDown()
+    }
+
+    /// A white canvas with a dark block at deliberately odd coordinates, so edges
+    /// never land on a preview pixel boundary.
+    private func makeDocument(width: Int = 3000, height: Int = 2000) throws -> VIPSImage {
+        try createSolidColorImage(width: width, height: height, r: 255, g: 255, b: 255)
+            .drawRect(x: 1237, y: 611, width: 913, height: 487, color: VIPSColor(red: 40, green: 60, blue: 90), fill: true)
+    }
+
+    private func assertEdges(_ rect: CGRect, _ expected: CGRect, within accuracy: CGFloat,
+                             file: StaticString = #filePath, line: UInt = #line) {
+        XCTAssertEqual(rect.minX, expected.minX, accuracy: accuracy, file: file, line: line)
+        XCTAssertEqual(rect.minY, expected.minY, accuracy: accuracy, file: file, line: line)
+        XCTAssertEqual(rect.maxX, expected.maxX, accuracy: accuracy, file: file, line: line)
+        XCTAssertEqual(rect.maxY, expected.maxY, accuracy: accuracy, file: file, line: line)
+    }
+
+    // MARK: - Find Trim
+
+    func testPreviewTrimRefinesToFullResolution() throws {
+        let image = try makeDocument()
+        let exact = try image.findTrim()
+        let refined = try image.findTrim(preview: VIPSPreviewOptions(size: 256, tolerance: 0))
+        assertEdges(exact, CGRect(x: 1237, y: 611, width: 913, height: 487), within: 2)
+        assertEdges(refined, exact, within: 1)
+    }
+
+    func testPreviewTrimDefaultsToPreviewPrecision() throws {
+        let image = try makeDocument()
+        let exact = try image.findTrim()
+        // Without a tolerance the preview result is only mapped back: one 256px preview
+        // pixel covers 12 source pixels, and the margin allows three of them
+        let coarse = try image.findTrim(preview: VIPSPreviewOptions(size: 256))
+        assertEdges(coarse, exact, within: 36)
+    }
+
+    func testPreviewTrimOfBlankImageIsEmpty() throws {
+        let image = createSolidColorImage(width: 3000, height: 2000, r: 255, g: 255, b: 255)
+        let trim = try image.findTrim(preview: VIPSPreviewOptions(size: 256))
+        // An empty result is still mapped to source coordinates
+        XCTAssertTrue(trim.isEmpty)
+        XCTAssertLessThanOrEqual(trim.maxX, 3000)
+        XCTAssertLessThanOrEqual(trim.maxY, 2000)
+    }
+
+    func testPreviewTrimWithinTolerance() throws {
+        let image = try makeDocument()
+        let exact = try image.findTrim()
+        // One 256px preview pixel covers about 12 source pixels, so a tolerance of 50
+        // skips refinement entirely
+        let coarse = try image.findTrim(preview: VIPSPreviewOptions(size: 256, tolerance: 50))
+        assertEdges(coarse, exact, within: 50)
+    }
+
+    func testPreviewTrimFromFileAndData() throws {
+        let path = directory.appendingPathComponent("document.png").path
+        try makeDocument().write(toFile: path)
+        let exact = try VIPSImage(contentsOfFile: path).findTrim()
+
+        let options = VIPSPreviewOptions(size: 300, tolerance: 0)
+        assertEdges(try VIPSImage.findTrim(fromFile: path, preview: options), exact, within: 1)
+        let data = try Data(contentsOf: URL(fileURLWithPath: path))
+        assertEdges(try VIPSImage.findTrim(fromData: data, preview: options), exact, within: 1)
+    }
+
+    func testPreviewTrimOnSmallImageMatchesFullResolution() throws {
+        let image = try createSolidColorImage(width: 200, height: 100, r: 255, g: 255, b: 255)
+            .drawRect(x: 30, y: 20, width: 50, height: 40, color: .black, fill: true)
+        XCTAssertEqual(try image.findTrim(preview: VIPSPreviewOptions()), try image.findTrim())
+    }
+
+    // MARK: - Smart Crop
+
+    func testSmartCropRegionMatchesSmartCrop() throws {
+        let image = try createTestImage(width: 400, height: 300)
+            .drawCircle(cx: 320, cy: 80, radius: 30, color: .white, fill: true)
+        let region = try image.smartCropRegion(toWidth: 120, height: 120, interesting: .entropy)
+        let cropped = try image.smartCrop(toWidth: 120, height: 120, interesting: .entropy)
+        let fromRegion = try image.crop(region)
+        for (x, y) in [(0, 0), (60, 60), (119, 119)] {
+            XCTAssertEqual(try fromRegion.pixelValues(atX: x, y: y).red,
+                           try cropped.pixelValues(atX: x, y: y).red, accuracy: 0.5)
+        }
+    }
+
+    func testPreviewSmartCropStaysNearFullResolution() throws {
+        let image = try createSolidColorImage(width: 2400, height: 1600, r: 30, g: 30, b: 30)
+            .drawCircle(cx: 1800, cy: 500, radius: 150, color: .white, fill: true)
+        let exact = try image.smartCropRegion(toWidth: 600, height: 600, interesting: .entropy)
+        let preview = try image.smartCropRegion(toWidth: 600, height: 600, interesting: .entropy,
+                                                preview: VIPSPreviewOptions(size: 400))
+        XCTAssertEqual(preview.size, CGSize(width: 600, height: 600))
+        XCTAssertTrue(CGRect(x: 0, y: 0, width: 2400, height: 1600).contains(preview))
+        XCTAssertTrue(preview.contains(CGPoint(x: 1800, y: 500)))
+        XCTAssertTrue(exact.contains(CGPoint(x: 1800, y: 500)))
+
+        let cropped = try image.smartCrop(toWidth: 600, height: 600, interesting: .entropy,
+                                          preview: VIPSPreviewOptions(size: 400))
+        XCTAssertEqual(cropped.width, 600)
+        XCTAssertEqual(cropped.height, 600)
+    }
+
+    func testPreviewSmartCropRejectsOversizedWindow() {
+        let image = createTestImage(width: 100, height: 100)
+        XCTAssertThrowsError(try image.smartCropRegion(toWidth: 200, height: 50, preview: VIPSPreviewOptions(size: 50)))
+    }
+
+    // MARK: - Background
+
+    func testPreviewBackgroundColor() async throws {
+        let image = try makeDocument()
+        let exact = try image.detectBackgroundColor()
+        let preview = try image.detectBackgroundColor(preview: VIPSPreviewOptions(size: 256))
+        XCTAssertEqual(preview.red, exact.red, accuracy: 2)
+        XCTAssertEqual(preview.green, exact.green, accuracy: 2)
+        XCTAssertEqual(preview.blue, exact.blue, accuracy: 2)
+
+        let path = directory.appendingPathComponent("document.png").path
+        try await image.write(toFile: path)
+        let fromFile = try await VIPSImage.detectedBackgroundColor(fromFile: path)
+        XCTAssertEqual(fromFile.red, 255, accuracy: 2)
+    }
+
+    // MARK: - Benchmark
+
+    private func makeLargeDocument() throws -> String {
+        let path = directory.appendingPathComponent("large.jpg").path
+        try makeDocument(width: 8000, height: 6000).write(toFile: path, format: .jpeg, quality: 90)
+        return path
+    }
+
+    func testPerformanceFullResolutionAnalysis() throws {
+        try skipUnlessBenchmarking()
+        let path = try makeLargeDocument()
+        measure {
+            XCTAssertNoThrow(try VIPSImage(contentsOfFile: path).findTrim())
+            XCTAssertNoThrow(try VIPSImage(contentsOfFile: path).detectBackgroundColor())
+            XCTAssertNoThrow(try VIPSImage(contentsOfFile: path).smartCropRegion(toWidth: 2000, height: 2000))
+        }
+    }
+
+    func testPerformancePreviewAnalysis() throws {
+        try skipUnlessBenchmarking()
+        let path = try makeLargeDocument()
+        let options = VIPSPreviewOptions(size: 1024)
+        measure {
+            XCTAssertNoThrow(try VIPSImage.findTrim(fromFile: path, preview: options))
+            XCTAssertNoThrow(try VIPSImage.detectBackgroundColor(fromFile: path, preview: options))
+            XCTAssertNoThrow(try VIPSImage.smartCropRegion(fromFile: path, toWidth: 2000, height: 2000,
+                                                           preview: options))
+        }
+    }
+
+    func testPerformanceRefinedPreviewAnalysis() throws {
+        try skipUnlessBenchmarking()
+        let path = try makeLargeDocument()
+        let exact = try VIPSImage(contentsOfFile: path).findTrim()
+        let options = VIPSPreviewOptions(size: 1024, tolerance: 0)
+        measure {
+            guard let trim = try? VIPSImage.findTrim(fromFile: path, preview: options) else {
+                return XCTFail("Could not trim the preview")
+            }
+            assertEdges(trim, exact, within: 2)
+            XCTAssertNoThrow(try VIPSImage.smartCropRegion(fromFile: path, toWidth: 2000, height: 2000,
+                                                           preview: options))
+        }
+    }
+}
@@ -0,0 +1,259 @@
+import XCTest
+@testable import VIPSKit
+
+/// Heap memory that is freed when the last reference goes away, standing in for
+/// a camera frame or decoder buffer.
+private final class FrameStorage {
+    let bytes: UnsafeMutableRawBufferPointer
+
+    init(count: Int) {
+        bytes = .allocate(byteCount: count, alignment: 16)
+        bytes.initializeMemory(as: UInt8.self, repeating: 0)
+    }
+
+    deinit { bytes.deallocate() }
+}
+
+final class VIPSImageRawBufferTests: VIPSImageTestCase {
+
+    /// A frame whose pixel at (x, y) holds `x + y * band` in each band.
+    private func makeFrame(width: Int, height: Int, bands: Int, bytesPerRow: Int) -> FrameStorage {
+        let frame = FrameStorage(count: bytesPerRow * height)
+        for y in 0..<height {
+            for x in 0..<width {
+                for band in 0..<bands {
+                    frame.bytes[y * bytesPerRow + x * bands + band] = UInt8((x + y * band) % 256)
+                }
+            }
+        }
+        return frame
+    }
+
+    // MARK: - Import
+
+    func testNoCopyBufferReadsCallerMemory() throws {
+        let frame = makeFrame(width: 64, height: 32, bands: 4, bytesPerRow: 64 * 4)
+        let image = try VIPSImage(noCopyBuffer: UnsafeRawBufferPointer(frame.bytes),
+                                  width: 64, height: 32, bands: 4, owner: frame)
+        XCTAssertEqual(image.width, 64)
+        XCTAssertEqual(image.height, 32)
+        XCTAssertTrue(image.hasAlpha)
+
+        // Nothing has been read yet, so a change to the caller's memory shows through
+        frame.bytes[(5 * 64 + 10) * 4] = 250
+        XCTAssertEqual(try image.pixelValues(atX: 10, y: 5).red, 250)
+        XCTAssertEqual(try image.pixelValues(atX: 10, y: 5).green, 15)
+    }
+
+    func testNoCopyBufferRetainsOwnerUntilLastImageCloses() throws {
+        weak var released: FrameStorage?
+        var derived: VIPSImage?
+        do {
+            let frame = makeFrame(width: 64, height: 64, bands: 3, bytesPerRow: 64 * 3)
+            released = frame
+            let image = try VIPSImage(noCopyBuffer: UnsafeRawBufferPointer(frame.bytes),
+                                      width: 64, height: 64, bands: 3, owner: frame)
+            derived = try image.resize(scale: 0.5)
+        }
+        XCTAssertNotNil(released, "A derived image still reads the memory")
+        XCTAssertEqual(derived?.width, 32)
+        _ = try derived?.copiedToMemory()
+        derived = nil
+        // The cached resize still references the wrapped image until it is evicted
+        VIPSImage.Cache.clear()
+        XCTAssertNil(released)
+    }
+
+    func testNoCopyBufferReleasesOwnerWithImage() throws {
+        weak var released: FrameStorage?
+        var image: VIPSImage?
+        do {
+            // Padded rows are cropped out of a wider wrapper, which must not be cached either
+            let frame = makeFrame(width: 30, height: 20, bands: 4, bytesPerRow: 30 * 4 + 16)
+            released = frame
+            image = try VIPSImage(noCopyBuffer: UnsafeRawBufferPointer(frame.bytes), width: 30, height: 20,
+                                  bands: 4, bytesPerRow: 30 * 4 + 16, owner: frame)
+        }
+        XCTAssertEqual(image?.width, 30)
+        XCTAssertNotNil(released)
+        image = nil
+        XCTAssertNil(released)
+    }
+
+    func testNoCopyBufferSkipsRowPadding() throws {
+        // 16 bytes of padding is a whole number of RGBA pixels, so nothing is copied
+        let frame = makeFrame(width: 30, height: 20, bands: 4, bytesPerRow: 30 * 4 + 16)
+        let image = try VIPSImage(noCopyBuffer: UnsafeRawBufferPointer(frame.bytes), width: 30, height: 20,
+                                  bands: 4, bytesPerRow: 30 * 4 + 16, owner: frame)
+        XCTAssertEqual(image.width, 30)
+        XCTAssertEqual(try image.pixelValues(atX: 29, y: 19).values, [29, 48, 67, 86])
+    }
+
+    func testNoCopyBufferPacksUnalignedRows() throws {
+        weak var released: FrameStorage?
+        let image: VIPSImage
+        do {
+            // 8 bytes of padding is not a whole number of RGB pixels, so the rows are copied
+            let frame = makeFrame(width: 30, height: 20, bands: 3, bytesPerRow: 30 * 3 + 8)
+            released = frame
+            image = try VIPSImage(noCopyBuffer: UnsafeRawBufferPointer(frame.bytes), width: 30, height: 20,
+                                  bands: 3, bytesPerRow: 30 * 3 + 8, owner: frame)
+        }
+        XCTAssertNil(released)
+        XCTAssertEqual(try image.pixelValues(atX: 29, y: 19).values, [29, 48, 67])
+    }
+
+    func testNoCopyBufferTypedFormats() throws {
+        let samples: [UInt16] = [0, 1000, 65535, 40000, 20000, 300]
+        let wide = try samples.withUnsafeBytes { bytes in
+            try VIPSImage(noCopyBuffer: bytes, width: 2, height: 1, bands: 3, format: .uint16,
+                          owner: FrameStorage(count: 0)).copiedToMemory()
+        }
+        XCTAssertEqual(try wide.pixelValues(atX: 1, y: 0).values, [40000, 20000, 300])
+
+        let floats: [Float] = [0.25, 0.5, 1.0, -0.5]
+        let linear = try floats.withUnsafeBytes { bytes in
+            try VIPSImage(noCopyBuffer: bytes, width: 1, height: 1, bands: 4, format: .float32,
+                          owner: FrameStorage(count: 0)).copiedToMemory()
+        }
+        XCTAssertEqual(try linear.pixelValues(atX: 0, y: 0).values, [0.25, 0.5, 1.0, -0.5])
+
+        // 1.0, -2.0, 0.5 and 65504 (the largest half) as IEEE half-precision bits
+        var halves: [UInt16] = [0x3c00, 0xc000, 0x3800, 0x7bff]
+        let half = try halves.withUnsafeBytes { bytes in
+            try VIPSImage(noCopyBuffer: bytes, width: 2, height: 1, bands: 2, format: .float16,
+                          interpretation: .multiband, owner: FrameStorage(count: 0))
+        }
+        halves = [0, 0, 0, 0]
+        XCTAssertEqual(try half.pixelValues(atX: 0, y: 0).values, [1.0, -2.0])
+        XCTAssertEqual(try half.pixelValues(atX: 1, y: 0).values, [0.5, 65504])
+    }
+
+    func testNoCopyBufferRejectsShortBuffer() {
+        weak var released: FrameStorage?
+        do {
+            let frame = FrameStorage(count: 100)
+            released = frame
+            XCTAssertThrowsError(try VIPSImage(noCopyBuffer: UnsafeRawBufferPointer(frame.bytes),
+                                               width: 10, height: 10, bands: 3, owner: frame))
+            XCTAssertThrowsError(try VIPSImage(noCopyBuffer: UnsafeRawBufferPointer(frame.bytes),
+                                               width: 10, height: 2, bands: 3, bytesPerRow: 20, owner: frame))
+            // Two padded rows and an unpadded last row fit, but the padding after it does not
+            XCTAssertThrowsError(try VIPSImage(noCopyBuffer: UnsafeRawBufferPointer(frame.bytes),
+                                               width: 10, height: 3, bands: 3, bytesPerRow: 35, owner: frame))
+        }
+        XCTAssertNil(released)
+    }
+
+    // MARK: - Export
+
+    func testWriteIntoBufferLeavesPaddingUntouched() throws {
+        let image = createTestImage(width: 40, height: 30, bands: 4)
+        let bytesPerRow = 40 * 4 + 12
+        let buffer = UnsafeMutableRawBufferPointer.allocate(byteCount: bytesPerRow * 30, alignment: 16)
+        defer { buffer.deallocate() }
+        buffer.initializeMemory(as: UInt8.self, repeating: 0xAB)
+
+        try image.write(into: buffer, bytesPerRow: bytesPerRow)
+        for (x, y) in [(0, 0), (39, 0), (17, 29)] {
+            let offset = y * bytesPerRow + x * 4
+            let expected = try image.pixelValues(atX: x, y: y).values.map { UInt8($0) }
+            XCTAssertEqual(Array(buffer[offset..<offset + 4]), expected)
+        }
+        XCTAssertEqual(buffer[40 * 4], 0xAB)
+        XCTAssertEqual(buffer[bytesPerRow * 30 - 1], 0xAB)
+    }
+
+    func testWriteIntoBufferRoundTripsTypedFormats() throws {
+        let source = createTestImage(width: 16, height: 8)
+        for format in [VIPSPixelFormat.uint8, .uint16, .float16, .float32] {
+            let bytesPerRow = 16 * 3 * format.bytesPerSample
+            let frame = FrameStorage(count: bytesPerRow * 8)
+            try source.write(into: frame.bytes, format: format)
+            let image = try VIPSImage(noCopyBuffer: UnsafeRawBufferPointer(frame.bytes), width: 16, height: 8,
+                                      bands: 3, format: format, interpretation: .multiband, owner: frame)
+            // Samples are cast without rescaling, so 8-bit values survive every format exactly
+            XCTAssertEqual(try image.pixelValues(atX: 15, y: 7).values,
+                           try source.pixelValues(atX: 15, y: 7).values, "\(format)")
+        }
+    }
+
+    func testWriteIntoBufferConvertsInterpretation() throws {
+        let image = createSolidColorImage(width: 8, height: 8, r: 255, g: 255, b: 255)
+        var samples = [UInt16](repeating: 0, count: 8 * 8 * 3)
+        try samples.withUnsafeMutableBytes { try image.write(into: $0, format: .uint16, interpretation: .rgb16) }
+        XCTAssertEqual(samples[0], 65535)
+
+        var gray = [UInt8](repeating: 0, count: 8 * 8)
+        try gray.withUnsafeMutableBytes { try image.write(into: $0, interpretation: .bw) }
+        XCTAssertEqual(gray[63], 255)
+    }
+
+    func testWriteIntoBufferRejectsShortBuffer() {
+        let image = createTestImage(width: 10, height: 10)
+        var bytes = [UInt8](repeating: 0, count: 10 * 10 * 3 - 1)
+        XCTAssertThrowsError(try bytes.withUnsafeMutableBytes { try image.write(into: $0) })
+        XCTAssertThrowsError(try bytes.withUnsafeMutableBytes { try image.write(into: $0, bytesPerRow: 20) })
+    }
+
+    // MARK: - Benchmark
+
+    private let benchmarkSize = (width: 4096, height: 3072, bands: 4)
+
+    private func makeBenchmarkFrame() -> FrameStorage {
+        makeFrame(width: benchmarkSize.width, height: benchmarkSize.height, bands: benchmarkSize.bands,
+                  bytesPerRow: benchmarkSize.width * benchmarkSize.bands)
+    }
+
+    func testPerformanceCopyingImport() throws {
+        try skipUnlessBenchmarking()
+        let frame = makeBenchmarkFrame()
+        let (width, height, bands) = benchmarkSize
+        measure {
+            for _ in 0..<20 {
+                XCTAssertNoThrow(try VIPSImage(buffer: UnsafeRawPointer(frame.bytes.baseAddress!),
+                                               width: width, height: height, bands: bands))
+            }
+        }
+    }
+
+    func testPerformanceNoCopyImport() throws {
+        try skipUnlessBenchmarking()
+        let frame = makeBenchmarkFrame()
+        let (width, height, bands) = benchmarkSize
+        measure {
+            for _ in 0..<20 {
+                XCTAssertNoThrow(try VIPSImage(noCopyBuffer: UnsafeRawBufferPointer(frame.bytes),
+                                               width: width, height: height, bands: bands, owner: frame))
+            }
+        }
+    }
+
+    private func makeHalfSizeExport() throws -> VIPSImage {
+        let frame = makeBenchmarkFrame()
+        return try VIPSImage(noCopyBuffer: UnsafeRawBufferPointer(frame.bytes), width: benchmarkSize.width,
+                             height: benchmarkSize.height, bands: benchmarkSize.bands, owner: frame)
+            .resize(scale: 0.5)
+    }
+
+    func testPerformanceAllocatingExport() throws {
+        try skipUnlessBenchmarking()
+        let image = try makeHalfSizeExport()
+        measure {
+            for _ in 0..<20 {
+                XCTAssertNoThrow(try image.withPixelData { $0.data[0] })
+            }
+        }
+    }
+
+    func testPerformanceExportIntoBuffer() throws {
+        try skipUnlessBenchmarking()
+        let image = try makeHalfSizeExport()
+        let output = FrameStorage(count: image.width * image.height * image.bands)
+        measure {
+            for _ in 0..<20 {
+                XCTAssertNoThrow(try image.write(into: output.bytes))
+            }
+        }
+    }
+}
@@ -0,0 +1,113 @@
+import XCTest
+@testable import VIPSKit
+
+final class VIPSImageRenditionsTests: VIPSImageTestCase {
+
+    func testRenditionsFromData() throws {
+        let data = try createTestImage(width: 800, height: 400).data(format: .jpeg)
+        let renditions = try VIPSImage.renditions(fromData: data, widths: [128, 512, 256],
+                                                  formats: [.jpeg, .png])
+
+        XCTAssertEqual(renditions.map(\.targetWidth), [512, 512, 256, 256, 128, 128])
+        XCTAssertEqual(renditions.map(\.format), [.jpeg, .png, .jpeg, .png, .jpeg, .png])
+        for rendition in renditions {
+            XCTAssertEqual(rendition.width, rendition.targetWidth)
+            XCTAssertEqual(rendition.height, rendition.targetWidth / 2)
+
+            let decoded = try VIPSImage(data: rendition.data)
+            XCTAssertEqual(decoded.width, rendition.width)
+            XCTAssertEqual(decoded.sourceFormat, rendition.format)
+        }
+    }
+
+    func testRenditionsFromFile() throws {
+        let path = NSTemporaryDirectory() + "vipskit_test_renditions.jpg"
+        defer { try? FileManager.default.removeItem(atPath: path) }
+        try createTestImage(width: 600, height: 600).write(toFile: path)
+
+        let renditions = try VIPSImage.renditions(fromFile: path, widths: [300, 150])
+        XCTAssertEqual(renditions.map(\.width), [300, 150])
+        XCTAssertEqual(renditions.map(\.height), [300, 150])
+    }
+
+    func testRenditionsDoNotUpscale() throws {
+        let data = try createTestImage(width: 200, height: 100).data(format: .png)
+        let renditions = try VIPSImage.renditions(fromData: data, widths: [1024, 100])
+        XCTAssertEqual(renditions.first?.targetWidth, 1024)
+        XCTAssertEqual(renditions.first?.width, 200)
+        XCTAssertEqual(renditions.last?.width, 100)
+    }
+
+    func testSourceIsDecodedOnce() throws {
+        let data = try createTestImage(width: 1000, height: 750).data(format: .jpeg)
+        let (renditions, decodes) = try VIPSImage.makeRenditions(widths: [800, 400, 200, 100],
+                                                                 formats: [.jpeg, .webP], quality: 80) { width in
+            try VIPSImage.thumbnail(fromData: data, width: width, height: 10_000)
+        }
+        XCTAssertEqual(renditions.count, 8)
+        XCTAssertEqual(decodes, 1)
+    }
+
+    func testInvalidArgumentsThrow() throws {
+        let data = try createTestImage(width: 50, height: 50).data(format: .png)
+        XCTAssertThrowsError(try VIPSImage.renditions(fromData: data, widths: []))
+        XCTAssertThrowsError(try VIPSImage.renditions(fromData: data, widths: [0, 20]))
+        XCTAssertThrowsError(try VIPSImage.renditions(fromData: data, widths: [20], formats: []))
+        XCTAssertThrowsError(try VIPSImage.renditions(fromData: data, widths: [20], formats: [.gif]))
+    }
+
+    func testRenditionsAsync() async throws {
+        let data = try createTestImage(width: 400, height: 300).data(format: .jpeg)
+        let renditions = try await VIPSImage.renditions(fromData: data, widths: [200, 100])
+        XCTAssertEqual(renditions.count, 2)
+    }
+
+    func testRenditionsDecodeOnceWhereNaiveLoopDecodesPerEncode() throws {
+        let data = try createTestImage(width: 800, height: 600).data(format: .jpeg)
+        let widths = [400, 200, 100]
+        let formats: [VIPSImageFormat] = [.jpeg, .webP]
+
+        // One thumbnail per width, one encode per format; each encode re-runs the decode
+        var naiveDecodes = 0
+        for width in widths {
+            let thumbnail = try VIPSImage.thumbnail(fromData: data, width: width, height: 10_000)
+            for format in formats {
+                naiveDecodes += try thumbnail.countingEvaluations {
+                    try thumbnail.data(format: format, quality: 80)
+                }.evaluations
+            }
+        }
+        let (_, decodes) = try VIPSImage.makeRenditions(widths: widths, formats: formats, quality: 80) { width in
+            try VIPSImage.thumbnail(fromData: data, width: width, height: 10_000)
+        }
+        XCTAssertEqual(decodes, 1)
+        XCTAssertGreaterThan(naiveDecodes, decodes)
+    }
+
+    // MARK: - Benchmark
+
+    private static let benchmarkWidths = [2048, 1024, 512, 256, 128]
+    private static let benchmarkFormats: [VIPSImageFormat] = [.jpeg, .webP]
+
+    func testPerformanceNaiveRenditionLoop() throws {
+        try skipUnlessBenchmarking()
+        let data = try createTestImage(width: 4000, height: 3000).data(format: .jpeg)
+        measure {
+            for width in Self.benchmarkWidths {
+                let thumbnail = try? VIPSImage.thumbnail(fromData: data, width: width, height: 10_000)
+                for format in Self.benchmarkFormats {
+                    _ = try? thumbnail?.data(format: format, quality: 80)
+                }
+            }
+        }
+    }
+
+    func testPerformanceRenditions() throws {
+        try skipUnlessBenchmarking()
+        let data = try createTestImage(width: 4000, height: 3000).data(format: .jpeg)
+        measure {
+            _ = try? VIPSImage.renditions(fromData: data, widths: Self.benchmarkWidths,
+                                          formats: Self.benchmarkFormats, quality: 80)
+        }
+    }
+}
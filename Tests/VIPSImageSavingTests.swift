@@ -531,6 +531,63 @@ final class VIPSImageSavingTests: VIPSImageTestCase {
         XCTAssertEqual(loaded.sourceFormat, .jxl)
     }
 
+    // MARK: - Streaming Export
+
+    func testStreamedOutputMatchesData() throws {
+        let image = createTestImage(width: 300, height: 200)
+        for format in [VIPSImageFormat.jpeg, .png, .webP, .tiff] {
+            var streamed = Data()
+            var chunks = 0
+            try image.write(format: format, quality: 80) { chunk in
+                streamed.append(contentsOf: chunk)
+                chunks += 1
+            }
+            XCTAssertGreaterThan(chunks, 0)
+            XCTAssertEqual(try VIPSImage(data: streamed).sourceFormat, format)
+            if format != .tiff {
+                XCTAssertEqual(streamed, try image.data(format: format, quality: 80))
+            }
+        }
+    }
+
+    func testStreamingSinkErrorIsRethrown() {
+        struct SinkFull: Error {}
+        let image = createTestImage(width: 200, height: 200)
+        XCTAssertThrowsError(try image.write(format: .png) { _ in throw SinkFull() }) { error in
+            XCTAssertTrue(error is SinkFull)
+        }
+    }
+
+    func testStreamingUnsupportedFormatThrows() {
+        let image = createTestImage(width: 10, height: 10)
+        XCTAssertThrowsError(try image.write(format: .gif) { _ in })
+    }
+
+    func testWriteToFileDescriptor() throws {
+        let image = createTestImage(width: 120, height: 80)
+        let path = NSTemporaryDirectory() + "vipskit_test_descriptor.png"
+        defer { try? FileManager.default.removeItem(atPath: path) }
+
+        let descriptor = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0o644)
+        XCTAssertGreaterThanOrEqual(descriptor, 0)
+        try image.write(toFileDescriptor: descriptor, format: .png)
+        close(descriptor)
+
+        let loaded = try VIPSImage(contentsOfFile: path)
+        XCTAssertEqual(loaded.width, 120)
+        XCTAssertEqual(loaded.sourceFormat, .png)
+    }
+
+    func testDataOutlivesSourceImage() throws {
+        var data: Data
+        do {
+            let image = createTestImage(width: 64, height: 64)
+            data = try image.data(format: .png)
+        }
+        data.append(0)
+        XCTAssertEqual(try VIPSImage(data: data.dropLast()).width, 64)
+    }
+
     // MARK: - Async
 
     func testAsyncWriteToFile() async throws {
@@ -557,4 +614,29 @@ final class VIPSImageSavingTests: VIPSImageTestCase {
         XCTAssertEqual(data[0], 0xFF)
         XCTAssertEqual(data[1], 0xD8)
     }
+
+    func testAsyncStreamedWrite() async throws {
+        let image = createTestImage(width: 100, height: 100)
+        let collected = ChunkCollector()
+        try await image.write(format: .jpeg) { chunk in collected.append(chunk) }
+        XCTAssertEqual(collected.data.prefix(2), Data([0xFF, 0xD8]))
+    }
+}
+
+/// Collects streamed chunks from a detached task for inspection by a test.
+private final class ChunkCollector: @unchecked Sendable {
+    private let lock = NSLock()
+    private var storage = Data()
+
+    var data: Data {
+        lock.lock()
+        defer { lock.unlock() }
+        return storage
+    }
+
+    func append(_ chunk: UnsafeRawBufferPointer) {
+        lock.lock()
+        storage.append(contentsOf: chunk)
+        lock.unlock()
+    }
 }
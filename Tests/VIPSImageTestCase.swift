@@ -15,6 +15,20 @@ class VIPSImageTestCase: XCTestCase {
 
     // MARK: - Helpers
 
+    /// Skip the calling benchmark unless `VIPSKIT_BENCHMARKS` is set, keeping timing
+    /// runs on large inputs out of the default test suite.
+    func skipUnlessBenchmarking() throws {
+        try XCTSkipUnless(ProcessInfo.processInfo.environment["VIPSKIT_BENCHMARKS"] != nil,
+                          "Set VIPSKIT_BENCHMARKS to run benchmarks")
+    }
+
+    /// Skip the calling benchmark unless `VIPSKIT_LARGE_BENCHMARKS` is set, for runs
+    /// that take minutes or write gigabytes.
+    func skipUnlessLargeBenchmarking() throws {
+        try XCTSkipUnless(ProcessInfo.processInfo.environment["VIPSKIT_LARGE_BENCHMARKS"] != nil,
+                          "Set VIPSKIT_LARGE_BENCHMARKS to run large benchmarks")
+    }
+
     func pathForTestResource(_ filename: String) -> String? {
         #if SWIFT_PACKAGE
         let bundle = Bundle.module
@@ -99,3 +113,20 @@ class VIPSImageTestCase: XCTestCase {
         return try! VIPSImage(buffer: &buffer, width: width, height: height, bands: 3)
     }
 }
+
+/// A SplitMix64 generator, so randomized inputs are the same on every run.
+struct SeededGenerator: RandomNumberGenerator {
+    private var state: UInt64
+
+    init(seed: UInt64) {
+        state = seed
+    }
+
+    mutating func next() -> UInt64 {
+        state &+= 0x9E37_79B9_7F4A_7C15
+        var z = state
+        z = (z ^ (z >> 30)) &* 0xBF58_476D_1CE4_E5B9
+        z = (z ^ (z >> 27)) &* 0x94D0_49BB_1331_11EB
+        return z ^ (z >> 31)
+    }
+}
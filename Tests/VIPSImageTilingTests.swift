@@ -79,6 +79,130 @@ final class VIPSImageTilingTests: VIPSImageTestCase {
         }
     }
 
+    // MARK: - Pyramids
+
+    private func makeOutputDirectory() throws -> URL {
+        let directory = URL(fileURLWithPath: NSTemporaryDirectory())
+            .appendingPathComponent("vipskit_test_pyramid_\(UUID().uuidString)")
+        try FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+        return directory
+    }
+
+    func testWriteDeepZoomPyramid() throws {
+        let directory = try makeOutputDirectory()
+        defer { try? FileManager.default.removeItem(at: directory) }
+        let base = directory.appendingPathComponent("scan").path
+
+        try createTestImage(width: 600, height: 400).writePyramid(toPath: base)
+        XCTAssertTrue(FileManager.default.fileExists(atPath: base + ".dzi"))
+
+        // 600px wide needs 11 levels; the deepest holds 3 x 2 tiles of 254px plus overlap
+        let level = base + "_files/10"
+        XCTAssertEqual(try FileManager.default.contentsOfDirectory(atPath: level).count, 6)
+        let corner = try VIPSImage(contentsOfFile: level + "/0_0.jpg")
+        XCTAssertEqual(corner.width, 255)
+        XCTAssertEqual(corner.height, 255)
+        XCTAssertEqual(try VIPSImage(contentsOfFile: base + "_files/0/0_0.jpg").width, 1)
+    }
+
+    func testWriteZoomifyAndGooglePyramids() throws {
+        let directory = try makeOutputDirectory()
+        defer { try? FileManager.default.removeItem(at: directory) }
+        let image = createTestImage(width: 700, height: 300)
+
+        let zoomify = directory.appendingPathComponent("zoomify").path
+        try image.writePyramid(toPath: zoomify, layout: .zoomify, format: .png)
+        XCTAssertTrue(FileManager.default.fileExists(atPath: zoomify + "/ImageProperties.xml"))
+        XCTAssertTrue(FileManager.default.fileExists(atPath: zoomify + "/TileGroup0/0-0-0.png"))
+
+        let google = directory.appendingPathComponent("google").path
+        try image.writePyramid(toPath: google, layout: .google, tileSize: 128, format: .webP, quality: 60)
+        let top = try VIPSImage(contentsOfFile: google + "/0/0/0.webp")
+        XCTAssertEqual(top.width, 128)
+        XCTAssertEqual(top.sourceFormat, .webP)
+    }
+
+    func testWritePyramidFromFileStreams() throws {
+        let directory = try makeOutputDirectory()
+        defer { try? FileManager.default.removeItem(at: directory) }
+        let source = directory.appendingPathComponent("source.png").path
+        try createTestImage(width: 1000, height: 800).write(toFile: source)
+
+        let base = directory.appendingPathComponent("streamed").path
+        try VIPSImage.writePyramid(fromFile: source, toPath: base, tileSize: 256, overlap: 0)
+        let level = base + "_files/10"
+        XCTAssertEqual(try FileManager.default.contentsOfDirectory(atPath: level).count, 16)
+    }
+
+    func testWritePyramidRestoresConcurrency() throws {
+        let directory = try makeOutputDirectory()
+        defer { try? FileManager.default.removeItem(at: directory) }
+        let before = VIPSImage.concurrency
+        let image = createTestImage(width: 600, height: 600)
+        try image.writePyramid(toPath: directory.appendingPathComponent("threads").path, threads: 4)
+        XCTAssertEqual(VIPSImage.concurrency, before)
+        try image.writePyramid(toPath: directory.appendingPathComponent("default").path)
+        XCTAssertEqual(VIPSImage.concurrency, before)
+    }
+
+    func testWritePyramidRejectsInvalidOptions() throws {
+        let image = createTestImage(width: 100, height: 100)
+        let base = NSTemporaryDirectory() + "vipskit_test_pyramid_invalid"
+        XCTAssertThrowsError(try image.writePyramid(toPath: base, tileSize: 0))
+        XCTAssertThrowsError(try image.writePyramid(toPath: base, tileSize: 64, overlap: 64))
+        XCTAssertThrowsError(try image.writePyramid(toPath: base, format: .gif))
+        XCTAssertFalse(FileManager.default.fileExists(atPath: base + ".dzi"))
+    }
+
+    func testAsyncWritePyramid() async throws {
+        let directory = try makeOutputDirectory()
+        defer { try? FileManager.default.removeItem(at: directory) }
+        let base = directory.appendingPathComponent("async").path
+        try await createTestImage(width: 300, height: 300).writePyramid(toPath: base, layout: .google)
+        XCTAssertTrue(FileManager.default.fileExists(atPath: base + "/0/0/0.jpg"))
+    }
+
+    // MARK: - Benchmark
+
+    func testPerformancePyramidOnLargeImage() throws {
+        // Writes around 40,000 tiles; opt in with VIPSKIT_LARGE_BENCHMARKS=1
+        try skipUnlessLargeBenchmarking()
+        let directory = try makeOutputDirectory()
+        defer { try? FileManager.default.removeItem(at: directory) }
+
+        // A repeated 512px pattern, generated on demand, so the source is never resident
+        let size = 50_000
+        let image = try createTestImage(width: 512, height: 512)
+            .embed(x: 0, y: 0, width: size, height: size, extend: .repeat)
+
+        // Every level halves the one below, rounding up, down to a single pixel
+        var expectedTiles = 0
+        var levelSize = size
+        while true {
+            let tiles = (levelSize + 253) / 254
+            expectedTiles += tiles * tiles
+            if levelSize == 1 { break }
+            levelSize = (levelSize + 1) / 2
+        }
+
+        let options = XCTMeasureOptions()
+        options.iterationCount = 1
+        // VIPSImage.initialize() pins libvips to one thread; use every core for the save
+        let threads = ProcessInfo.processInfo.activeProcessorCount
+        measure(metrics: [XCTClockMetric(), XCTMemoryMetric()], options: options) {
+            let base = directory.appendingPathComponent(UUID().uuidString).path
+            XCTAssertNoThrow(try image.writePyramid(toPath: base, quality: 80, threads: threads))
+
+            var tiles = 0
+            let enumerator = FileManager.default.enumerator(atPath: base + "_files")
+            while let file = enumerator?.nextObject() as? String {
+                if file.hasSuffix(".jpg") { tiles += 1 }
+            }
+            XCTAssertEqual(tiles, expectedTiles)
+            try? FileManager.default.removeItem(atPath: base + "_files")
+        }
+    }
+
     // MARK: - Async
 
     func testAsyncExtractedRegionFromFile() async throws {
@@ -0,0 +1,152 @@
+import XCTest
+@testable import VIPSKit
+
+final class VIPSPipelineTests: VIPSImageTestCase {
+
+    func testAdjacentLinearStepsMerge() {
+        let pipeline = VIPSPipeline().adjustContrast(1.5).adjustBrightness(0.1)
+        XCTAssertEqual(pipeline.steps.count, 1)
+        guard case let .linear(a, b)? = pipeline.steps.first else {
+            return XCTFail("Expected a single linear step")
+        }
+        XCTAssertEqual(a, 1.5, accuracy: 1e-9)
+        XCTAssertEqual(b, 127.5 * -0.5 + 25.5, accuracy: 1e-9)
+    }
+
+    func testIdentityStepsAreDropped() {
+        let pipeline = VIPSPipeline()
+            .adjust(brightness: 0, contrast: 1.0, saturation: 1.0)
+            .adjustBrightness(0.2).adjustBrightness(-0.2)
+            .adjustGamma(1.0)
+        XCTAssertTrue(pipeline.steps.isEmpty)
+    }
+
+    func testStepsAreNotMergedAcrossOtherOperations() {
+        let pipeline = VIPSPipeline().adjustBrightness(0.1).sharpened(sigma: 1.0).adjustBrightness(0.1)
+        XCTAssertEqual(pipeline.steps.count, 3)
+    }
+
+    func testEmptyPipelineReturnsEquivalentImage() throws {
+        let image = createTestImage(width: 40, height: 30)
+        let result = try VIPSPipeline().apply(to: image)
+        XCTAssertEqual(result.width, 40)
+        XCTAssertEqual(result.height, 30)
+        XCTAssertEqual(try result.pixelValues(atX: 10, y: 10), try image.pixelValues(atX: 10, y: 10))
+    }
+
+    func testMatchesChainedOperations() throws {
+        let image = createTestImage(width: 200, height: 150)
+        let chained = try image
+            .crop(x: 20, y: 10, width: 160, height: 120)
+            .resize(scale: 0.5)
+            .adjust(brightness: 0.1, contrast: 1.2)
+
+        let piped = try VIPSPipeline()
+            .crop(x: 20, y: 10, width: 160, height: 120)
+            .resize(scale: 0.5)
+            .adjust(brightness: 0.1, contrast: 1.2)
+            .apply(to: image)
+
+        XCTAssertEqual(piped.width, chained.width)
+        XCTAssertEqual(piped.height, chained.height)
+        let expected = try chained.pixelValues(atX: 40, y: 30)
+        let actual = try piped.pixelValues(atX: 40, y: 30)
+        // 8-bit input stays 8-bit in a pipeline, so allow for rounding
+        XCTAssertEqual(actual.red, min(255, max(0, expected.red)), accuracy: 1.0)
+        XCTAssertEqual(actual.green, min(255, max(0, expected.green)), accuracy: 1.0)
+        XCTAssertEqual(actual.blue, min(255, max(0, expected.blue)), accuracy: 1.0)
+    }
+
+    func testLinearLeavesAlphaUntouched() throws {
+        let image = createSolidColorImage(width: 10, height: 10, r: 100, g: 100, b: 100, a: 128)
+        let result = try VIPSPipeline().adjustBrightness(0.2).apply(to: image)
+        let pixel = try result.pixelValues(atX: 5, y: 5)
+        XCTAssertEqual(pixel.red, 151, accuracy: 1.0)
+        XCTAssertEqual(pixel.alpha ?? 0, 128, accuracy: 0.5)
+    }
+
+    func testNoOpStepsLeaveImageUnchanged() throws {
+        let image = createTestImage(width: 64, height: 48)
+        let result = try VIPSPipeline()
+            .crop(x: 0, y: 0, width: 64, height: 48)
+            .resize(scale: 1.0)
+            .resizeToFit(width: 64, height: 100)
+            .flatten(background: .white)
+            .apply(to: image)
+        XCTAssertEqual(result.width, 64)
+        XCTAssertEqual(result.height, 48)
+        XCTAssertEqual(try result.pixelValues(atX: 30, y: 20), try image.pixelValues(atX: 30, y: 20))
+    }
+
+    func testFlattenAndGrayscale() throws {
+        let image = createSolidColorImage(width: 16, height: 16, r: 255, g: 0, b: 0, a: 0)
+        let result = try VIPSPipeline().flatten(background: .white).grayscaled().apply(to: image)
+        XCTAssertEqual(result.bands, 1)
+        XCTAssertFalse(result.hasAlpha)
+        XCTAssertEqual(try result.pixelValues(atX: 8, y: 8).red, 255, accuracy: 1.0)
+    }
+
+    func testEncode() throws {
+        let image = createTestImage(width: 300, height: 200)
+        let pipeline = VIPSPipeline()
+            .resizeToFit(width: 100, height: 100)
+            .sharpened(sigma: 1.0)
+            .encode(format: .png)
+
+        let decoded = try VIPSImage(data: try pipeline.data(from: image))
+        XCTAssertEqual(decoded.sourceFormat, .png)
+        XCTAssertEqual(decoded.width, 100)
+        XCTAssertEqual(decoded.height, 67)
+    }
+
+    func testDataWithoutEncodingThrows() {
+        let image = createTestImage(width: 10, height: 10)
+        XCTAssertThrowsError(try VIPSPipeline().resize(scale: 0.5).data(from: image))
+    }
+
+    func testInvalidCropThrows() {
+        let image = createTestImage(width: 10, height: 10)
+        XCTAssertThrowsError(try VIPSPipeline().crop(x: 5, y: 5, width: 20, height: 20).apply(to: image))
+    }
+
+    func testApplyAsync() async throws {
+        let image = createTestImage(width: 100, height: 100)
+        let result = try await VIPSPipeline().resize(scale: 0.25).apply(to: image)
+        XCTAssertEqual(result.width, 25)
+    }
+
+    // MARK: - Benchmark
+
+    private static let benchmarkImageCount = 50
+
+    func testPerformanceChainedOperations() throws {
+        try skipUnlessBenchmarking()
+        let image = createTestImage(width: 800, height: 600)
+        measure {
+            for _ in 0..<Self.benchmarkImageCount {
+                _ = try? image
+                    .resizeToFit(width: 256, height: 256)
+                    .adjustContrast(1.1)
+                    .adjustBrightness(0.05)
+                    .sharpened(sigma: 0.8)
+                    .data(format: .jpeg, quality: 80)
+            }
+        }
+    }
+
+    func testPerformancePipeline() throws {
+        try skipUnlessBenchmarking()
+        let image = createTestImage(width: 800, height: 600)
+        let pipeline = VIPSPipeline()
+            .resizeToFit(width: 256, height: 256)
+            .adjustContrast(1.1)
+            .adjustBrightness(0.05)
+            .sharpened(sigma: 0.8)
+            .encode(format: .jpeg, quality: 80)
+        measure {
+            for _ in 0..<Self.benchmarkImageCount {
+                _ = try? pipeline.data(from: image)
+            }
+        }
+    }
+}
@@ -0,0 +1,143 @@
+import XCTest
+@testable import VIPSKit
+
+final class VIPSProfilerTests: VIPSImageTestCase {
+
+    override func setUp() {
+        super.setUp()
+        VIPSProfiler.reset()
+        VIPSProfiler.isEnabled = true
+    }
+
+    override func tearDown() {
+        VIPSProfiler.isEnabled = false
+        VIPSProfiler.reset()
+        super.tearDown()
+    }
+
+    func testDisabledRecordsNothing() throws {
+        VIPSProfiler.isEnabled = false
+        _ = try createTestImage(width: 64, height: 64).resize(scale: 0.5).data(format: .png)
+        XCTAssertTrue(VIPSProfiler.snapshot().events.isEmpty)
+    }
+
+    func testRecordsLoadBuildAndSave() throws {
+        VIPSProfiler.isEnabled = false
+        let data = try createTestImage(width: 200, height: 100).data(format: .jpeg)
+        VIPSProfiler.isEnabled = true
+
+        let thumbnail = try VIPSImage.thumbnail(fromData: data, width: 50, height: 50)
+        let encoded = try thumbnail.resize(scale: 0.5).data(format: .png)
+        let events = VIPSProfiler.snapshot().events
+
+        let load = try XCTUnwrap(events.first { $0.name == "thumbnail_buffer" })
+        XCTAssertEqual(load.kind, .load)
+        XCTAssertEqual(load.bytesIn, UInt64(data.count))
+        XCTAssertEqual(load.pixelsOut, 50 * 25)
+        XCTAssertFalse(load.failed)
+
+        let resize = try XCTUnwrap(events.first { $0.name == "resize" })
+        XCTAssertEqual(resize.kind, .build)
+        XCTAssertEqual(resize.pixelsIn, 50 * 25)
+
+        let save = try XCTUnwrap(events.first { $0.name == "pngsave_buffer" })
+        XCTAssertEqual(save.kind, .save)
+        XCTAssertEqual(save.bytesOut, UInt64(encoded.count))
+        XCTAssertGreaterThan(save.thread, 0)
+    }
+
+    func testFailuresAreRecorded() {
+        XCTAssertThrowsError(try VIPSImage(data: Data([0x00, 0x01, 0x02, 0x03])))
+        let events = VIPSProfiler.snapshot().events
+        XCTAssertEqual(events.filter(\.failed).count, 1)
+    }
+
+    func testResetClearsEvents() throws {
+        _ = try createTestImage(width: 32, height: 32).resize(scale: 0.5)
+        XCTAssertFalse(VIPSProfiler.snapshot().events.isEmpty)
+        VIPSProfiler.reset()
+        XCTAssertTrue(VIPSProfiler.snapshot().events.isEmpty)
+    }
+
+    func testOperationSummaries() throws {
+        let image = createTestImage(width: 64, height: 64)
+        for _ in 0..<3 {
+            _ = try image.resize(scale: 0.5).data(format: .jpeg)
+        }
+        let operations = VIPSProfiler.snapshot().operations
+        let save = try XCTUnwrap(operations.first { $0.name == "jpegsave_buffer" })
+        XCTAssertEqual(save.count, 3)
+        XCTAssertGreaterThan(save.bytesOut, 0)
+        XCTAssertEqual(operations.map(\.totalDuration), operations.map(\.totalDuration).sorted(by: >))
+    }
+
+    func testRepeatedOperationHitsCache() throws {
+        let image = createTestImage(width: 64, height: 64)
+        _ = try image.resize(scale: 0.5)
+        _ = try image.resize(scale: 0.5)
+        let resizes = VIPSProfiler.snapshot().events.filter { $0.name == "resize" }
+        XCTAssertEqual(resizes.count, 2)
+        XCTAssertEqual(resizes[0].cache, .miss)
+        XCTAssertEqual(resizes[1].cache, .hit)
+    }
+
+    func testUncacheableOperationIsNotAHit() throws {
+        // Wrapped memory is built outside the operation cache, so the cache never grows
+        let pixels = NSMutableData(length: 16 * 16 * 3)!
+        let buffer = UnsafeRawBufferPointer(start: pixels.bytes, count: pixels.length)
+        for _ in 0..<2 {
+            _ = try VIPSImage(noCopyBuffer: buffer, width: 16, height: 16, bands: 3, owner: pixels)
+        }
+        let imports = VIPSProfiler.snapshot().events.filter { $0.name == "image_new_from_memory_owned" }
+        XCTAssertEqual(imports.count, 2)
+        XCTAssertEqual(imports.map(\.cache), [.none, .none])
+    }
+
+    func testEvaluationTimeByThread() async throws {
+        let image = createTestImage(width: 128, height: 128)
+        try await withThrowingTaskGroup(of: Void.self) { group in
+            for _ in 0..<4 {
+                group.addTask { _ = try await image.encoded(format: .png) }
+            }
+            try await group.waitForAll()
+        }
+        let snapshot = VIPSProfiler.snapshot()
+        let total = snapshot.evaluationTimeByThread.values.reduce(0, +)
+        XCTAssertGreaterThan(total, 0)
+        let evaluations = snapshot.events.filter { $0.kind == .compute || $0.kind == .save || $0.kind == .read }
+        XCTAssertEqual(total, evaluations.map(\.duration).reduce(0, +))
+    }
+
+    func testChromeTrace() throws {
+        _ = try createTestImage(width: 64, height: 64).resize(scale: 0.5).data(format: .png)
+        let snapshot = VIPSProfiler.snapshot()
+        let json = try JSONSerialization.jsonObject(with: try snapshot.chromeTrace()) as? [String: Any]
+        let traceEvents = try XCTUnwrap(json?["traceEvents"] as? [[String: Any]])
+        XCTAssertEqual(traceEvents.count, snapshot.events.count)
+        let first = try XCTUnwrap(traceEvents.first)
+        XCTAssertEqual(first["ph"] as? String, "X")
+        XCTAssertNotNil(first["ts"] as? Double)
+        XCTAssertNotNil(first["args"] as? [String: Any])
+    }
+
+    // MARK: - Benchmark
+
+    func testPerformanceCallsWithProfilingDisabled() throws {
+        try skipUnlessBenchmarking()
+        let image = createTestImage(width: 32, height: 32)
+        VIPSProfiler.isEnabled = false
+        measure {
+            for _ in 0..<20_000 { _ = try? image.inverted() }
+        }
+    }
+
+    func testPerformanceCallsWithProfilingEnabled() throws {
+        try skipUnlessBenchmarking()
+        let image = createTestImage(width: 32, height: 32)
+        measure {
+            VIPSProfiler.reset()
+            for _ in 0..<20_000 { _ = try? image.inverted() }
+        }
+        XCTAssertEqual(VIPSProfiler.snapshot().events.count, 20_000)
+    }
+}
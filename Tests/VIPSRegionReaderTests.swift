@@ -0,0 +1,137 @@
+import XCTest
+@testable import VIPSKit
+
+final class VIPSRegionReaderTests: VIPSImageTestCase {
+
+    func testReaderDimensions() throws {
+        let image = createTestImage(width: 120, height: 80)
+        let reader = try VIPSRegionReader(image: image)
+        XCTAssertEqual(reader.width, 120)
+        XCTAssertEqual(reader.height, 80)
+        XCTAssertEqual(reader.bands, 3)
+        XCTAssertEqual(reader.bytesPerPixel, 3)
+    }
+
+    func testReadRegionMatchesPixels() throws {
+        let image = createTestImage(width: 100, height: 100)
+        let reader = try VIPSRegionReader(image: image)
+
+        var buffer = [UInt8](repeating: 0, count: 10 * 10 * 3)
+        try buffer.withUnsafeMutableBytes { raw in
+            try reader.read(x: 40, y: 60, width: 10, height: 10, into: raw.baseAddress!, bytesPerRow: 30)
+        }
+
+        let expected = try image.pixelValues(atX: 40, y: 60)
+        XCTAssertEqual(Double(buffer[0]), expected.red)
+        XCTAssertEqual(Double(buffer[1]), expected.green)
+        XCTAssertEqual(Double(buffer[2]), expected.blue)
+
+        let last = try image.pixelValues(atX: 49, y: 69)
+        let offset = 9 * 30 + 9 * 3
+        XCTAssertEqual(Double(buffer[offset]), last.red)
+        XCTAssertEqual(Double(buffer[offset + 1]), last.green)
+    }
+
+    func testReadRegionWithPaddedStride() throws {
+        let image = createSolidColorImage(width: 20, height: 20, r: 10, g: 20, b: 30)
+        let reader = try VIPSRegionReader(image: image)
+
+        let stride = 64
+        var buffer = [UInt8](repeating: 0xFF, count: stride * 4)
+        try buffer.withUnsafeMutableBytes { raw in
+            try reader.read(x: 0, y: 0, width: 4, height: 4, into: raw.baseAddress!, bytesPerRow: stride)
+        }
+        XCTAssertEqual(buffer[stride], 10)
+        XCTAssertEqual(buffer[stride + 2], 30)
+        // Padding past the row is left untouched
+        XCTAssertEqual(buffer[12], 0xFF)
+    }
+
+    func testReadOutOfBoundsThrows() throws {
+        let image = createTestImage(width: 50, height: 50)
+        let reader = try VIPSRegionReader(image: image)
+        var buffer = [UInt8](repeating: 0, count: 20 * 20 * 3)
+        buffer.withUnsafeMutableBytes { raw in
+            XCTAssertThrowsError(try reader.read(x: 40, y: 40, width: 20, height: 20,
+                                                 into: raw.baseAddress!, bytesPerRow: 60))
+            XCTAssertThrowsError(try reader.read(x: 0, y: 0, width: 20, height: 20,
+                                                 into: raw.baseAddress!, bytesPerRow: 10))
+        }
+    }
+
+    func testReaderFromData() throws {
+        let source = createTestImage(width: 200, height: 150)
+        let data = try source.data(format: .png)
+        let reader = try VIPSRegionReader(data: data)
+        XCTAssertEqual(reader.width, 200)
+        XCTAssertEqual(reader.height, 150)
+
+        var buffer = [UInt8](repeating: 0, count: 3)
+        try buffer.withUnsafeMutableBytes { raw in
+            try reader.read(x: 199, y: 149, width: 1, height: 1, into: raw.baseAddress!, bytesPerRow: 3)
+        }
+        let expected = try source.pixelValues(atX: 199, y: 149)
+        XCTAssertEqual(Double(buffer[0]), expected.red)
+        XCTAssertEqual(Double(buffer[1]), expected.green)
+    }
+
+    func testReaderFromFile() throws {
+        let source = createTestImage(width: 64, height: 64)
+        let path = NSTemporaryDirectory() + "vipskit_test_region_reader.png"
+        defer { try? FileManager.default.removeItem(atPath: path) }
+        try source.write(toFile: path)
+
+        let reader = try VIPSRegionReader(contentsOfFile: path)
+        XCTAssertEqual(reader.width, 64)
+        XCTAssertEqual(reader.tileRects(tileWidth: 32, tileHeight: 32).count, 4)
+    }
+
+    func testForEachTileVisitsEveryTile() throws {
+        let image = createTestImage(width: 100, height: 75)
+        let reader = try VIPSRegionReader(image: image)
+
+        var visited: [CGRect] = []
+        var pixelCount = 0
+        try reader.forEachTile(tileWidth: 60, tileHeight: 60) { rect, pixels, bytesPerRow in
+            visited.append(rect)
+            XCTAssertEqual(pixels.count, bytesPerRow * Int(rect.height))
+            pixelCount += Int(rect.width * rect.height)
+        }
+        XCTAssertEqual(visited, image.tileRects(tileWidth: 60, tileHeight: 60))
+        XCTAssertEqual(pixelCount, 100 * 75)
+    }
+
+    // MARK: - Benchmark
+
+    private func makeBenchmarkFile() throws -> String {
+        let path = NSTemporaryDirectory() + "vipskit_bench_region_reader.tif"
+        try createTestImage(width: 1024, height: 1024).write(toFile: path, format: .tiff)
+        return path
+    }
+
+    func testPerformancePerCallExtractRegion() throws {
+        try skipUnlessBenchmarking()
+        let path = try makeBenchmarkFile()
+        defer { try? FileManager.default.removeItem(atPath: path) }
+        let rects = createTestImage(width: 1024, height: 1024).tileRects(tileWidth: 128, tileHeight: 128)
+
+        measure {
+            for rect in rects {
+                _ = try? VIPSImage.extractRegion(fromFile: path,
+                                                 x: Int(rect.minX), y: Int(rect.minY),
+                                                 width: Int(rect.width), height: Int(rect.height))
+            }
+        }
+    }
+
+    func testPerformanceRegionReader() throws {
+        try skipUnlessBenchmarking()
+        let path = try makeBenchmarkFile()
+        defer { try? FileManager.default.removeItem(atPath: path) }
+        let reader = try VIPSRegionReader(contentsOfFile: path)
+
+        measure {
+            try? reader.forEachTile(tileWidth: 128, tileHeight: 128) { _, _, _ in }
+        }
+    }
+}
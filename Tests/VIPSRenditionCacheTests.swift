@@ -0,0 +1,165 @@
+import XCTest
+@testable import VIPSKit
+
+final class VIPSRenditionCacheTests: VIPSImageTestCase {
+
+    private var directory: URL!
+
+    override func setUp() {
+        super.setUp()
+        directory = URL(fileURLWithPath: NSTemporaryDirectory())
+            .appendingPathComponent("vipskit_test_rendition_cache_\(UUID().uuidString)")
+    }
+
+    override func tearDown() {
+        try? FileManager.default.removeItem(at: directory)
+        super.tearDown()
+    }
+
+    private func makeSource(width: Int = 400, height: Int = 300, seed: UInt8 = 0) throws -> Data {
+        try createSolidColorImage(width: width, height: height, r: seed, g: 128, b: 64).data(format: .jpeg)
+    }
+
+    func testMissThenHit() throws {
+        let cache = try VIPSRenditionCache(directory: directory, byteBudget: 10_000_000)
+        let source = try makeSource()
+
+        let first = try cache.thumbnailData(fromData: source, width: 100, height: 100, format: .png)
+        let second = try cache.thumbnailData(fromData: source, width: 100, height: 100, format: .png)
+        XCTAssertEqual(first, second)
+
+        let thumbnail = try VIPSImage(data: second)
+        XCTAssertEqual(thumbnail.width, 100)
+        XCTAssertEqual(thumbnail.sourceFormat, .png)
+
+        let stats = cache.statistics
+        XCTAssertEqual(stats.misses, 1)
+        XCTAssertEqual(stats.hits, 1)
+        XCTAssertEqual(stats.hitRate, 0.5, accuracy: 1e-9)
+        XCTAssertEqual(stats.entryCount, 1)
+        XCTAssertEqual(stats.totalBytes, first.count)
+    }
+
+    func testKeyIncludesSourceContentAndSpecification() throws {
+        let cache = try VIPSRenditionCache(directory: directory, byteBudget: 10_000_000)
+        let a = try makeSource(seed: 10)
+        let b = try makeSource(seed: 200)
+
+        _ = try cache.thumbnailData(fromData: a, width: 64, height: 64)
+        _ = try cache.thumbnailData(fromData: b, width: 64, height: 64)
+        _ = try cache.thumbnailData(fromData: a, width: 32, height: 32)
+        _ = try cache.thumbnailData(fromData: a, width: 64, height: 64, quality: 50)
+        _ = try cache.encodedData(fromData: a, format: .png)
+        XCTAssertEqual(cache.statistics.misses, 5)
+
+        // Identical bytes hit regardless of which Data instance holds them
+        _ = try cache.thumbnailData(fromData: Data(a), width: 64, height: 64)
+        XCTAssertEqual(cache.statistics.hits, 1)
+    }
+
+    func testEncodedDataIsFullSize() throws {
+        let cache = try VIPSRenditionCache(directory: directory, byteBudget: 10_000_000)
+        let encoded = try cache.encodedData(fromData: try makeSource(width: 120, height: 90), format: .webP)
+        let image = try VIPSImage(data: encoded)
+        XCTAssertEqual(image.width, 120)
+        XCTAssertEqual(image.sourceFormat, .webP)
+    }
+
+    func testEntriesPersistAcrossInstances() throws {
+        let source = try makeSource()
+        let original = try VIPSRenditionCache(directory: directory, byteBudget: 10_000_000)
+        let first = try original.thumbnailData(fromData: source, width: 80, height: 80)
+
+        let reopened = try VIPSRenditionCache(directory: directory, byteBudget: 10_000_000)
+        XCTAssertEqual(reopened.statistics.entryCount, 1)
+        XCTAssertEqual(try reopened.thumbnailData(fromData: source, width: 80, height: 80), first)
+        XCTAssertEqual(reopened.statistics.hits, 1)
+    }
+
+    func testLeastRecentlyUsedIsEvicted() throws {
+        let sources = try (0..<3).map { try makeSource(seed: UInt8($0 * 80)) }
+        let probe = try VIPSRenditionCache(directory: directory, byteBudget: .max)
+        let size = try probe.thumbnailData(fromData: sources[0], width: 64, height: 64, format: .png).count
+        probe.removeAll()
+
+        // Room for two entries of this size, but not three
+        let cache = try VIPSRenditionCache(directory: directory, byteBudget: size * 2 + size / 2)
+        _ = try cache.thumbnailData(fromData: sources[0], width: 64, height: 64, format: .png)
+        _ = try cache.thumbnailData(fromData: sources[1], width: 64, height: 64, format: .png)
+        _ = try cache.thumbnailData(fromData: sources[0], width: 64, height: 64, format: .png)
+        _ = try cache.thumbnailData(fromData: sources[2], width: 64, height: 64, format: .png)
+
+        XCTAssertEqual(cache.statistics.evictions, 1)
+        XCTAssertEqual(cache.statistics.entryCount, 2)
+        XCTAssertLessThanOrEqual(cache.statistics.totalBytes, cache.byteBudget)
+
+        // sources[1] was the least recently used
+        cache.resetStatistics()
+        _ = try cache.thumbnailData(fromData: sources[0], width: 64, height: 64, format: .png)
+        _ = try cache.thumbnailData(fromData: sources[1], width: 64, height: 64, format: .png)
+        XCTAssertEqual(cache.statistics.hits, 1)
+        XCTAssertEqual(cache.statistics.misses, 1)
+    }
+
+    func testRemoveAll() throws {
+        let cache = try VIPSRenditionCache(directory: directory, byteBudget: 10_000_000)
+        _ = try cache.thumbnailData(fromData: try makeSource(), width: 50, height: 50)
+        cache.removeAll()
+        XCTAssertEqual(cache.statistics.entryCount, 0)
+        XCTAssertEqual(cache.statistics.totalBytes, 0)
+        XCTAssertTrue(try FileManager.default.contentsOfDirectory(atPath: directory.path).isEmpty)
+    }
+
+    func testInvalidSourceThrowsAndStoresNothing() throws {
+        let cache = try VIPSRenditionCache(directory: directory, byteBudget: 10_000_000)
+        XCTAssertThrowsError(try cache.thumbnailData(fromData: Data([0x00, 0x01, 0x02]), width: 50, height: 50))
+        XCTAssertEqual(cache.statistics.entryCount, 0)
+    }
+
+    func testThumbnailDataAsync() async throws {
+        let cache = try VIPSRenditionCache(directory: directory, byteBudget: 10_000_000)
+        let data = try await cache.thumbnailData(fromData: try makeSource(), width: 40, height: 40)
+        XCTAssertEqual(try VIPSImage(data: data).width, 40)
+    }
+
+    // MARK: - Benchmark
+
+    /// 20 distinct sources requested 200 times with a skewed popularity, so
+    /// roughly 90% of requests repeat an earlier one. The sequence is seeded so
+    /// every run times the same requests.
+    private func makeRequestSequence() throws -> (sources: [Data], requests: [Int]) {
+        let sources = try (0..<20).map { try makeSource(width: 1600, height: 1200, seed: UInt8($0 * 12)) }
+        var generator = SeededGenerator(seed: 42)
+        let requests = (0..<200).map { _ -> Int in
+            let r = Double.random(in: 0..<1, using: &generator)
+            return min(sources.count - 1, Int(r * r * Double(sources.count)))
+        }
+        return (sources, requests)
+    }
+
+    func testPerformanceUncachedRequests() throws {
+        try skipUnlessBenchmarking()
+        let (sources, requests) = try makeRequestSequence()
+        measure {
+            for index in requests {
+                _ = try? VIPSImage.thumbnail(fromData: sources[index], width: 256, height: 256).data(format: .jpeg)
+            }
+        }
+    }
+
+    func testPerformanceCachedRequests() throws {
+        try skipUnlessBenchmarking()
+        let (sources, requests) = try makeRequestSequence()
+        measure {
+            let run = directory.appendingPathComponent(UUID().uuidString)
+            guard let cache = try? VIPSRenditionCache(directory: run, byteBudget: 64 * 1024 * 1024) else {
+                return XCTFail("Could not create the cache")
+            }
+            for index in requests {
+                _ = try? cache.thumbnailData(fromData: sources[index], width: 256, height: 256)
+            }
+            XCTAssertEqual(cache.statistics.hits + cache.statistics.misses, requests.count)
+            XCTAssertEqual(cache.statistics.misses, Set(requests).count)
+        }
+    }
+}